@@ -12,11 +12,26 @@ namespace UnrealBuildTool.Rules
 		{
 			PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
+			PublicDependencyModuleNames.AddRange(
+				new string[] {
+					"GameplayTags",
+				});
+
 			PrivateDependencyModuleNames.AddRange(
 				new string[] {
 					"Core",
 					"CoreUObject",
 					"Engine",
+					"ImageWrapper",
+					"MovieScene",
+					"Networking",
+					"RenderCore",
+					"Renderer",
+					"RHI",
+					"ShaderCore",
+					"Slate",
+					"SlateCore",
+					"Sockets",
 				});
 
 			PrivateIncludePaths.AddRange(
@@ -32,9 +47,9 @@ namespace UnrealBuildTool.Rules
 
 			// add Logitech SDK libraries
 			string LogiDir = Path.GetFullPath(Path.Combine(ModuleDirectory, "..", "..", "ThirdParty"));
-			string LibDir = Path.Combine(LogiDir, "lib");
+			string LibDir = Path.Combine(LogiDir, "Lib");
 
-			PrivateIncludePaths.Add(Path.Combine(LogiDir, "include"));
+			PrivateIncludePaths.Add(Path.Combine(LogiDir, "Include"));
 
 			if (Target.Platform == UnrealTargetPlatform.Win32)
 			{
@@ -48,7 +63,8 @@ namespace UnrealBuildTool.Rules
 			}
 			else
 			{
-				System.Console.WriteLine("Logitech SDK does not support this platform");
+				// the SDK functions are stubbed out, so that lighting can still be previewed
+				System.Console.WriteLine("Logitech SDK does not support this platform, LED output will only be previewed");
 			}
 		}
 	}
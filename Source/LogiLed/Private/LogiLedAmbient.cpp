@@ -0,0 +1,215 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedAmbient.h"
+#include "LogiLedAmbientCapture.h"
+#include "LogiLedManager.h"
+#include "LogiLedPrivate.h"
+
+#include "Engine/Engine.h"
+#include "Misc/App.h"
+#include "SceneViewExtension.h"
+
+
+/* FLogiLedAmbient structors
+ *****************************************************************************/
+
+FLogiLedAmbient::FLogiLedAmbient()
+	: SmoothedValid(false)
+	, FrameInterval(1)
+	, FramesUntilCapture(0)
+	, SmoothingSeconds(0.0f)
+	, TimeSinceApply(0.0f)
+	, Running(false)
+{
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		Cells[CellIndex] = FLinearColor::Black;
+		Smoothed[CellIndex] = FLinearColor::Black;
+	}
+}
+
+
+/* FLogiLedAmbient interface
+ *****************************************************************************/
+
+void FLogiLedAmbient::Start(int32 InFrameInterval, float InSmoothingSeconds)
+{
+	FrameInterval = FMath::Max(InFrameInterval, 1);
+	SmoothingSeconds = FMath::Max(InSmoothingSeconds, 0.0f);
+
+	if (Running)
+	{
+		return;
+	}
+
+	Running = true;
+	SmoothedValid = false;
+	FramesUntilCapture = 0;
+	TimeSinceApply = 0.0f;
+
+	// images can still be submitted where nothing is rendered
+	if (FApp::CanEverRender() && (GEngine != nullptr))
+	{
+		Capture = FSceneViewExtensions::NewExtension<FLogiLedAmbientCapture>();
+	}
+}
+
+
+void FLogiLedAmbient::Stop()
+{
+	if (Capture.IsValid())
+	{
+		Capture->ReleaseResources();
+		Capture.Reset();
+	}
+
+	Running = false;
+}
+
+
+void FLogiLedAmbient::SubmitImage(const FColor* InPixels, int32 Width, int32 Height, float DeltaSeconds)
+{
+	if (Running)
+	{
+		Downsample(InPixels, Width, Height, Cells);
+		Apply(DeltaSeconds);
+	}
+}
+
+
+/* FLogiLedAmbient static functions
+ *****************************************************************************/
+
+void FLogiLedAmbient::Downsample(const FColor* Pixels, int32 Width, int32 Height, FLinearColor* OutCells)
+{
+	if ((Pixels == nullptr) || (Width <= 0) || (Height <= 0))
+	{
+		for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+		{
+			OutCells[CellIndex] = FLinearColor::Black;
+		}
+
+		return;
+	}
+
+	for (int32 CellY = 0; CellY < LOGI_LED_BITMAP_HEIGHT; ++CellY)
+	{
+		// cells cover at least one pixel, even if the image is smaller than the bitmap
+		const int32 MinY = CellY * Height / LOGI_LED_BITMAP_HEIGHT;
+		const int32 MaxY = FMath::Max((CellY + 1) * Height / LOGI_LED_BITMAP_HEIGHT, MinY + 1);
+
+		for (int32 CellX = 0; CellX < LOGI_LED_BITMAP_WIDTH; ++CellX)
+		{
+			const int32 MinX = CellX * Width / LOGI_LED_BITMAP_WIDTH;
+			const int32 MaxX = FMath::Max((CellX + 1) * Width / LOGI_LED_BITMAP_WIDTH, MinX + 1);
+
+			uint64 SumR = 0;
+			uint64 SumG = 0;
+			uint64 SumB = 0;
+
+			for (int32 Y = MinY; Y < MaxY; ++Y)
+			{
+				const FColor* Row = Pixels + Y * Width;
+
+				for (int32 X = MinX; X < MaxX; ++X)
+				{
+					SumR += Row[X].R;
+					SumG += Row[X].G;
+					SumB += Row[X].B;
+				}
+			}
+
+			const float Scale = 1.0f / (255.0f * (MaxX - MinX) * (MaxY - MinY));
+			OutCells[CellY * LOGI_LED_BITMAP_WIDTH + CellX] = FLinearColor(SumR * Scale, SumG * Scale, SumB * Scale);
+		}
+	}
+}
+
+
+void FLogiLedAmbient::Smooth(const FLinearColor* Cells, float DeltaSeconds, float SmoothingSeconds, FLinearColor* InOutSmoothed)
+{
+	// exponential moving average, independent of the capture rate
+	const float Alpha = (SmoothingSeconds > 0.0f) ? 1.0f - FMath::Exp(-FMath::Max(DeltaSeconds, 0.0f) / SmoothingSeconds) : 1.0f;
+
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		InOutSmoothed[CellIndex] += (Cells[CellIndex] - InOutSmoothed[CellIndex]) * Alpha;
+	}
+}
+
+
+/* FTickableGameObject interface
+ *****************************************************************************/
+
+TStatId FLogiLedAmbient::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FLogiLedAmbient, STATGROUP_Tickables);
+}
+
+
+bool FLogiLedAmbient::IsTickable() const
+{
+	return Running;
+}
+
+
+bool FLogiLedAmbient::IsTickableInEditor() const
+{
+	return true;
+}
+
+
+void FLogiLedAmbient::Tick(float DeltaTime)
+{
+	TimeSinceApply += DeltaTime;
+
+	if (!Capture.IsValid())
+	{
+		return;
+	}
+
+	// pick up images that were read back since the last tick
+	FIntPoint Size;
+
+	if (Capture->GetResult(Pixels, Size) && (Pixels.Num() == Size.X * Size.Y))
+	{
+		Downsample(Pixels.GetData(), Size.X, Size.Y, Cells);
+		Apply(TimeSinceApply);
+	}
+
+	if (--FramesUntilCapture <= 0)
+	{
+		Capture->RequestCapture();
+		FramesUntilCapture = FrameInterval;
+	}
+}
+
+
+/* FLogiLedAmbient implementation
+ *****************************************************************************/
+
+void FLogiLedAmbient::Apply(float DeltaSeconds)
+{
+	// the first colors are taken over as they are, so nothing is blended with stale colors
+	if (SmoothedValid)
+	{
+		Smooth(Cells, DeltaSeconds, SmoothingSeconds, Smoothed);
+	}
+	else
+	{
+		FMemory::Memcpy(Smoothed, Cells, sizeof(Smoothed));
+		SmoothedValid = true;
+	}
+
+	TimeSinceApply = 0.0f;
+
+	Pixels.SetNumUninitialized(NumCells, false);
+
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		Pixels[CellIndex] = Smoothed[CellIndex].ToFColor(false);
+	}
+
+	// ambient mode does not belong to a world, so it drives whichever manager is active
+	FLogiLedManager::GetActive().SetLightingFromBitmap(Pixels.GetData());
+}
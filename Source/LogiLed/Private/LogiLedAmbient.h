@@ -0,0 +1,167 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "CoreTypes.h"
+#include "Math/Color.h"
+#include "Templates/SharedPointer.h"
+#include "Tickable.h"
+
+#include "LogitechLEDLib.h"
+
+class FLogiLedAmbientCapture;
+
+
+/**
+ * Mirrors the colors on screen onto the per-key lighting.
+ *
+ * Every few frames, the game viewport's final scene color is halved on the
+ * GPU down to a few pixels per key bitmap cell, read back asynchronously, and
+ * averaged into the cells by Downsample. The cells are smoothed over time, so
+ * that the keyboard follows the screen without flickering, and set as the
+ * per-key lighting.
+ *
+ * Where nothing can be rendered, images can be submitted from the CPU instead,
+ * which are downsampled by Downsample alone.
+ */
+class FLogiLedAmbient
+	: public FTickableGameObject
+{
+public:
+
+	/** Number of cells in the key bitmap. */
+	static const int32 NumCells = LOGI_LED_BITMAP_WIDTH * LOGI_LED_BITMAP_HEIGHT;
+
+public:
+
+	/** Default constructor. */
+	FLogiLedAmbient();
+
+public:
+
+	/**
+	 * Get the smoothed cell colors that were applied most recently.
+	 *
+	 * @return The NumCells smoothed colors, in rows of LOGI_LED_BITMAP_WIDTH.
+	 */
+	const FLinearColor* GetSmoothed() const
+	{
+		return Smoothed;
+	}
+
+	/**
+	 * Check whether ambient lighting is running.
+	 *
+	 * @return true if running, false otherwise.
+	 */
+	bool IsRunning() const
+	{
+		return Running;
+	}
+
+	/**
+	 * Start mirroring the screen.
+	 *
+	 * @param InFrameInterval Number of frames between captures (at least 1).
+	 * @param InSmoothingSeconds Time over which the lighting follows changes on screen (0 = immediately).
+	 * @see Stop
+	 */
+	void Start(int32 InFrameInterval, float InSmoothingSeconds);
+
+	/**
+	 * Stop mirroring the screen.
+	 *
+	 * The keys keep their current lighting.
+	 *
+	 * @see Start
+	 */
+	void Stop();
+
+	/**
+	 * Submit an image from the CPU instead of capturing the screen.
+	 *
+	 * @param InPixels The image's pixels, in rows.
+	 * @param Width The image's width.
+	 * @param Height The image's height.
+	 * @param DeltaSeconds Time since the previous image.
+	 */
+	void SubmitImage(const FColor* InPixels, int32 Width, int32 Height, float DeltaSeconds);
+
+public:
+
+	/**
+	 * Downsample an image to the key bitmap by averaging the pixels of each cell.
+	 *
+	 * This finishes the downsample of captured frames, and is exact for both
+	 * captured frames and submitted images. The GPU passes before it only
+	 * average 2x2 pixels at a time, so they do not change the cell averages of
+	 * images that divide evenly into cells, apart from rounding.
+	 *
+	 * @param Pixels The image's pixels, in rows.
+	 * @param Width The image's width.
+	 * @param Height The image's height.
+	 * @param OutCells Will contain the NumCells average colors, in rows of LOGI_LED_BITMAP_WIDTH.
+	 */
+	static void Downsample(const FColor* Pixels, int32 Width, int32 Height, FLinearColor* OutCells);
+
+	/**
+	 * Blend new cell colors into smoothed ones.
+	 *
+	 * @param Cells The NumCells new colors.
+	 * @param DeltaSeconds Time since the previous colors.
+	 * @param SmoothingSeconds Time constant of the smoothing (0 = no smoothing).
+	 * @param InOutSmoothed The NumCells smoothed colors.
+	 */
+	static void Smooth(const FLinearColor* Cells, float DeltaSeconds, float SmoothingSeconds, FLinearColor* InOutSmoothed);
+
+public:
+
+	//~ FTickableGameObject interface
+
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableInEditor() const override;
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+
+	/**
+	 * Smooth new cell colors and set them as the per-key lighting.
+	 *
+	 * @param DeltaSeconds Time since the previous colors.
+	 */
+	void Apply(float DeltaSeconds);
+
+private:
+
+	/** Captures and downsamples the game viewport (only valid while running and rendering). */
+	TSharedPtr<FLogiLedAmbientCapture, ESPMode::ThreadSafe> Capture;
+
+	/** The most recent cell colors. */
+	FLinearColor Cells[NumCells];
+
+	/** The smoothed cell colors. */
+	FLinearColor Smoothed[NumCells];
+
+	/** Whether the smoothed colors are valid (false = start from the next colors). */
+	bool SmoothedValid;
+
+	/** Pixels that were read back, and the bitmap that is applied. */
+	TArray<FColor> Pixels;
+
+	/** Number of frames between captures. */
+	int32 FrameInterval;
+
+	/** Number of frames until the next capture. */
+	int32 FramesUntilCapture;
+
+	/** Time constant of the smoothing (in seconds). */
+	float SmoothingSeconds;
+
+	/** Time since the last colors were applied (in seconds). */
+	float TimeSinceApply;
+
+	/** Whether ambient lighting is running. */
+	bool Running;
+};
@@ -0,0 +1,202 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedAmbientCapture.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedReadback.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "GlobalShader.h"
+#include "Modules/ModuleManager.h"
+#include "PipelineStateCache.h"
+#include "RendererInterface.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "RHIStaticStates.h"
+#include "SceneView.h"
+#include "ScreenRendering.h"
+
+#include "LogitechLEDLib.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ambient Captures"), STAT_LogiLedAmbientCaptures, STATGROUP_LogiLed);
+
+
+/** Minimum number of read back pixels per key bitmap cell in each direction. */
+static const int32 LogiLedAmbientMinPixelsPerCell = 4;
+
+
+/**
+ * Draw a texture into a render target of half or the same size with bilinear filtering.
+ *
+ * @param RHICmdList The command list to use.
+ * @param SourceTexture The texture to draw.
+ * @param SourceSize Size of the area to draw, from the top left corner (twice or once the target's size).
+ * @param TargetTexture The render target to draw into.
+ * @param FeatureLevel The feature level to get the shaders for.
+ */
+static void LogiLedDrawDownsample(FRHICommandListImmediate& RHICmdList, FTexture2DRHIParamRef SourceTexture, FIntPoint SourceSize, FTexture2DRHIParamRef TargetTexture, ERHIFeatureLevel::Type FeatureLevel)
+{
+	const FIntPoint TargetSize(TargetTexture->GetSizeX(), TargetTexture->GetSizeY());
+
+	SetRenderTarget(RHICmdList, TargetTexture, FTextureRHIRef());
+	RHICmdList.SetViewport(0, 0, 0.0f, TargetSize.X, TargetSize.Y, 1.0f);
+
+	IRendererModule& RendererModule = FModuleManager::GetModuleChecked<IRendererModule>(TEXT("Renderer"));
+	TShaderMap<FGlobalShaderType>* ShaderMap = GetGlobalShaderMap(FeatureLevel);
+	TShaderMapRef<FScreenVS> VertexShader(ShaderMap);
+	TShaderMapRef<FScreenPS> PixelShader(ShaderMap);
+
+	FGraphicsPipelineStateInitializer GraphicsPSOInit;
+	{
+		RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+
+		GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+		GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = RendererModule.GetFilterVertexDeclaration().VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = GETSAFERHISHADER_VERTEX(*VertexShader);
+		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = GETSAFERHISHADER_PIXEL(*PixelShader);
+		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+	}
+
+	SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+	PixelShader->SetParameters(RHICmdList, TStaticSamplerState<SF_Bilinear>::GetRHI(), SourceTexture);
+
+	RendererModule.DrawRectangle(
+		RHICmdList,
+		0.0f, 0.0f, TargetSize.X, TargetSize.Y,
+		0.0f, 0.0f, SourceSize.X, SourceSize.Y,
+		TargetSize,
+		FIntPoint(SourceTexture->GetSizeX(), SourceTexture->GetSizeY()),
+		*VertexShader,
+		EDRF_Default);
+
+	RHICmdList.CopyToResolveTarget(TargetTexture, TargetTexture, true, FResolveParams());
+}
+
+
+/* FLogiLedAmbientCapture structors
+ *****************************************************************************/
+
+FLogiLedAmbientCapture::FLogiLedAmbientCapture(const FAutoRegister& AutoRegister)
+	: FSceneViewExtensionBase(AutoRegister)
+	, Readback(MakeShareable(new FLogiLedReadback()))
+	, TargetsSourceSize(0, 0)
+	, CaptureRequested(false)
+{ }
+
+
+/* FLogiLedAmbientCapture interface
+ *****************************************************************************/
+
+bool FLogiLedAmbientCapture::GetResult(TArray<FColor>& OutPixels, FIntPoint& OutSize)
+{
+	return Readback->GetResult(OutPixels, OutSize);
+}
+
+
+void FLogiLedAmbientCapture::ReleaseResources()
+{
+	Readback->ReleaseResources();
+
+	TSharedRef<FLogiLedAmbientCapture, ESPMode::ThreadSafe> Capture = StaticCastSharedRef<FLogiLedAmbientCapture>(AsShared());
+
+	ENQUEUE_RENDER_COMMAND(LogiLedReleaseAmbientCapture)(
+		[Capture](FRHICommandListImmediate& RHICmdList)
+		{
+			Capture->Targets.Empty();
+			Capture->TargetsSourceSize = FIntPoint(0, 0);
+		});
+}
+
+
+/* ISceneViewExtension interface
+ *****************************************************************************/
+
+void FLogiLedAmbientCapture::PostRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily)
+{
+	const FRenderTarget* RenderTarget = InViewFamily.RenderTarget;
+
+	if (RenderTarget == nullptr)
+	{
+		return;
+	}
+
+	SCOPED_DRAW_EVENT(RHICmdList, LogiLedAmbient);
+	RenderThread_Downsample(RHICmdList, RenderTarget->GetRenderTargetTexture(), RenderTarget->GetSizeXY(), InViewFamily.GetFeatureLevel());
+}
+
+
+bool FLogiLedAmbientCapture::IsActiveThisFrame(FViewport* InViewport) const
+{
+	if (!CaptureRequested || (GEngine == nullptr) || (GEngine->GameViewport == nullptr) || (InViewport != GEngine->GameViewport->Viewport))
+	{
+		return false;
+	}
+
+	// the game viewport's next view family claims the capture
+	CaptureRequested = false;
+
+	return true;
+}
+
+
+/* FLogiLedAmbientCapture implementation
+ *****************************************************************************/
+
+void FLogiLedAmbientCapture::RenderThread_Downsample(FRHICommandListImmediate& RHICmdList, FTexture2DRHIParamRef SourceTexture, FIntPoint SourceSize, ERHIFeatureLevel::Type FeatureLevel)
+{
+	check(IsInRenderingThread());
+
+	if ((SourceTexture == nullptr) || (SourceSize.X <= 0) || (SourceSize.Y <= 0))
+	{
+		return;
+	}
+
+	// the chain is only recreated when the viewport is resized
+	if (SourceSize != TargetsSourceSize)
+	{
+		Targets.Reset();
+		TargetsSourceSize = SourceSize;
+
+		const FIntPoint MinSize(LogiLedAmbientMinPixelsPerCell * LOGI_LED_BITMAP_WIDTH, LogiLedAmbientMinPixelsPerCell * LOGI_LED_BITMAP_HEIGHT);
+		FIntPoint Size = SourceSize;
+		TArray<FIntPoint> Sizes;
+
+		// halve exactly (an odd last row or column is dropped) while enough pixels per cell remain
+		while ((Size.X / 2 >= MinSize.X) && (Size.Y / 2 >= MinSize.Y))
+		{
+			Size = FIntPoint(Size.X / 2, Size.Y / 2);
+			Sizes.Add(Size);
+		}
+
+		// small viewports are copied, so that only the viewport's area is read back
+		if (Sizes.Num() == 0)
+		{
+			Sizes.Add(SourceSize);
+		}
+
+		for (const FIntPoint& TargetSize : Sizes)
+		{
+			FRHIResourceCreateInfo CreateInfo;
+			Targets.Add(RHICreateTexture2D(TargetSize.X, TargetSize.Y, PF_B8G8R8A8, 1, 1, TexCreate_RenderTargetable | TexCreate_ShaderResource, CreateInfo));
+		}
+	}
+
+	FTexture2DRHIParamRef Source = SourceTexture;
+
+	for (const FTexture2DRHIRef& Target : Targets)
+	{
+		const FIntPoint TargetSize(Target->GetSizeX(), Target->GetSizeY());
+		const FIntPoint DrawSize(FMath::Min(SourceSize.X, 2 * TargetSize.X), FMath::Min(SourceSize.Y, 2 * TargetSize.Y));
+
+		LogiLedDrawDownsample(RHICmdList, Source, DrawSize, Target, FeatureLevel);
+
+		Source = Target;
+		SourceSize = FIntPoint(Target->GetSizeX(), Target->GetSizeY());
+	}
+
+	Readback->RenderThread_Request(RHICmdList, Targets.Last());
+	INC_DWORD_STAT(STAT_LogiLedAmbientCaptures);
+}
@@ -0,0 +1,95 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "RHIResources.h"
+#include "SceneViewExtension.h"
+#include "Templates/SharedPointer.h"
+
+class FLogiLedReadback;
+
+
+/**
+ * Downsamples the game viewport's final scene color to the key bitmap.
+ *
+ * When a capture is requested, the view family of the game viewport is
+ * downsampled on the render thread once it has been rendered, in a chain of
+ * bilinear passes that each halve the resolution exactly, and the result is
+ * read back without stalling. Each output pixel is sampled at the center of
+ * the 2x2 pixels below it, so it is their exact average (up to rounding to
+ * 8 bits per pass). The chain stops at a few pixels per key bitmap cell, and
+ * FLogiLedAmbient::Downsample averages the read back pixels into the cells,
+ * so the box average that is verified on the CPU is the one that runs.
+ */
+class FLogiLedAmbientCapture
+	: public FSceneViewExtensionBase
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param AutoRegister Registers the extension with the engine.
+	 */
+	FLogiLedAmbientCapture(const FAutoRegister& AutoRegister);
+
+public:
+
+	/**
+	 * Get the most recent downsampled image that was read back.
+	 *
+	 * @param OutPixels Will contain the pixels, in rows.
+	 * @param OutSize Will contain the image's width and height.
+	 * @return true if a new image was available, false otherwise.
+	 */
+	bool GetResult(TArray<FColor>& OutPixels, FIntPoint& OutSize);
+
+	/** Release the render resources (must be called on the game thread). */
+	void ReleaseResources();
+
+	/** Capture the game viewport the next time it renders. */
+	void RequestCapture()
+	{
+		CaptureRequested = true;
+	}
+
+public:
+
+	//~ ISceneViewExtension interface
+
+	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override { }
+	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override { }
+	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override { }
+	virtual void PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily) override { }
+	virtual void PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView) override { }
+	virtual void PostRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily) override;
+	virtual bool IsActiveThisFrame(FViewport* InViewport) const override;
+
+protected:
+
+	/**
+	 * Downsample a texture and queue its readback.
+	 *
+	 * @param RHICmdList The command list to use.
+	 * @param SourceTexture The texture to downsample.
+	 * @param SourceSize Size of the area to downsample, from the top left corner.
+	 * @param FeatureLevel The feature level to get the shaders for.
+	 */
+	void RenderThread_Downsample(FRHICommandListImmediate& RHICmdList, FTexture2DRHIParamRef SourceTexture, FIntPoint SourceSize, ERHIFeatureLevel::Type FeatureLevel);
+
+private:
+
+	/** Reads the key bitmap back to the CPU. */
+	TSharedRef<FLogiLedReadback, ESPMode::ThreadSafe> Readback;
+
+	/** The downsample chain (render thread only). */
+	TArray<FTexture2DRHIRef> Targets;
+
+	/** The source size that the chain was created for (render thread only). */
+	FIntPoint TargetsSourceSize;
+
+	/** Whether a capture was requested and not claimed by a view family yet. */
+	mutable FThreadSafeBool CaptureRequested;
+};
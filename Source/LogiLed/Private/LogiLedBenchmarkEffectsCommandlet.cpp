@@ -0,0 +1,270 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedBenchmarkEffectsCommandlet.h"
+#include "LogiLedEffectPool.h"
+#include "LogiLedKeys.h"
+#include "LogiLedPrivate.h"
+
+#include "Classes/Curves/CurveLinearColor.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/Package.h"
+
+#include "LogitechLEDLib.h"
+
+
+/**
+ * Create a color curve with random cubic keys for benchmarking.
+ *
+ * @param Seed The random seed.
+ * @return The curve (rooted, so it is not garbage collected).
+ */
+static UCurveLinearColor* LogiLedCreateBenchmarkCurve(int32 Seed)
+{
+	UCurveLinearColor* Curve = NewObject<UCurveLinearColor>(GetTransientPackage(), NAME_None, RF_Transient);
+	FRandomStream Random(Seed);
+
+	for (int32 Channel = 0; Channel < 3; ++Channel)
+	{
+		FRichCurve& ChannelCurve = Curve->FloatCurves[Channel];
+
+		for (int32 KeyIndex = 0; KeyIndex <= 8; ++KeyIndex)
+		{
+			ChannelCurve.SetKeyInterpMode(ChannelCurve.AddKey(KeyIndex * 0.25f, Random.FRand()), RCIM_Cubic);
+		}
+
+		ChannelCurve.AutoSetTangents();
+	}
+
+	Curve->AddToRoot();
+
+	return Curve;
+}
+
+
+/**
+ * Compare the batched evaluation of many effects with evaluating their curves separately.
+ *
+ * @param Curves The curves to play.
+ * @param NumEffects The number of effects to play.
+ * @param NumFrames The number of frames to evaluate.
+ * @param FrameTime The time between two frames.
+ * @return true if both evaluations match, false otherwise.
+ */
+static bool LogiLedBenchmarkBatch(const TArray<UCurveLinearColor*>& Curves, int32 NumEffects, int32 NumFrames, float FrameTime)
+{
+	// effects wrap around before the end of the curves, so that they never become constant
+	const float CurveDuration = 2.0f;
+
+	TUniquePtr<FLogiLedEffectPool> Pool = MakeUnique<FLogiLedEffectPool>();
+	TArray<const UCurveLinearColor*> EffectCurves;
+
+	for (int32 EffectIndex = 0; EffectIndex < NumEffects; ++EffectIndex)
+	{
+		const UCurveLinearColor* Curve = Curves[EffectIndex % Curves.Num()];
+
+		if (!Pool->Add(*Curve, EffectIndex % LogiLedKeys::Count, LOGI_DEVICETYPE_PERKEY_RGB).IsValid())
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Failed to start %i effects"), NumEffects);
+			return false;
+		}
+
+		// effects are only ever appended, so their positions match their indices
+		Pool->GetEffect(EffectIndex).Time = FMath::Fmod(EffectIndex * 0.37f, CurveDuration);
+		EffectCurves.Add(Curve);
+	}
+
+	TArray<FLinearColor> Reference;
+	Reference.SetNumUninitialized(NumEffects);
+
+	double BatchSeconds = 0.0;
+	double ReferenceSeconds = 0.0;
+	float MaxDifference = 0.0f;
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		for (int32 EffectIndex = 0; EffectIndex < NumEffects; ++EffectIndex)
+		{
+			FLogiLedEffect& Effect = Pool->GetEffect(EffectIndex);
+			Effect.Time += FrameTime;
+
+			if (Effect.Time >= CurveDuration)
+			{
+				Effect.Time -= CurveDuration;
+				Effect.ConstantUntil = 0.0f;
+			}
+		}
+
+		const double BatchStartTime = FPlatformTime::Seconds();
+		Pool->Evaluate();
+		const double ReferenceStartTime = FPlatformTime::Seconds();
+
+		for (int32 EffectIndex = 0; EffectIndex < NumEffects; ++EffectIndex)
+		{
+			Reference[EffectIndex] = EffectCurves[EffectIndex]->GetLinearColorValue(Pool->GetEffect(EffectIndex).Time);
+		}
+
+		const double ReferenceEndTime = FPlatformTime::Seconds();
+
+		BatchSeconds += ReferenceStartTime - BatchStartTime;
+		ReferenceSeconds += ReferenceEndTime - ReferenceStartTime;
+
+		for (int32 EffectIndex = 0; EffectIndex < NumEffects; ++EffectIndex)
+		{
+			const FLinearColor Expected = Reference[EffectIndex].GetClamped() * 100.0f;
+			const FLinearColor& Exact = Pool->GetEffect(EffectIndex).Exact;
+
+			MaxDifference = FMath::Max(MaxDifference, FMath::Max3(FMath::Abs(Exact.R - Expected.R), FMath::Abs(Exact.G - Expected.G), FMath::Abs(Exact.B - Expected.B)));
+		}
+	}
+
+	Pool->Empty();
+
+	UE_LOG(LogLogiLed, Display, TEXT("%i effects: batched %.3f us per frame, separately %.3f us per frame (%.1fx), largest difference %.4f percent"),
+		NumEffects,
+		1000000.0 * BatchSeconds / NumFrames,
+		1000000.0 * ReferenceSeconds / NumFrames,
+		ReferenceSeconds / FMath::Max(BatchSeconds, 0.000000001),
+		MaxDifference);
+
+	// the percentages are rounded down to integers for the SDK, so small differences do not matter
+	return (MaxDifference < 0.01f);
+}
+
+
+/* ULogiLedBenchmarkEffectsCommandlet structors
+ *****************************************************************************/
+
+ULogiLedBenchmarkEffectsCommandlet::ULogiLedBenchmarkEffectsCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 ULogiLedBenchmarkEffectsCommandlet::Main(const FString& Params)
+{
+	float EffectsPerSecond = 100000.0f;
+	int32 NumPlaying = 200;
+	int32 NumCurves = 8;
+	float Duration = 5.0f;
+	float FramesPerSecond = 60.0f;
+
+	FParse::Value(*Params, TEXT("Effects="), EffectsPerSecond);
+	FParse::Value(*Params, TEXT("Playing="), NumPlaying);
+	FParse::Value(*Params, TEXT("Curves="), NumCurves);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("Fps="), FramesPerSecond);
+
+	NumPlaying = FMath::Clamp(NumPlaying, 1, FLogiLedEffectPool::MaxEffects);
+	NumCurves = FMath::Clamp(NumCurves, 1, FLogiLedEffectPool::MaxCurves);
+	FramesPerSecond = FMath::Max(FramesPerSecond, 1.0f);
+
+	const int32 NumFrames = FMath::Max(FMath::FloorToInt(Duration * FramesPerSecond), 1);
+	const int32 EffectsPerFrame = FMath::Max(FMath::RoundToInt(EffectsPerSecond / FramesPerSecond), 1);
+	const float FrameTime = 1.0f / FramesPerSecond;
+
+	TArray<UCurveLinearColor*> Curves;
+
+	for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+	{
+		Curves.Add(LogiLedCreateBenchmarkCurve(CurveIndex));
+	}
+
+	// the pool is too large for the stack
+	TUniquePtr<FLogiLedEffectPool> Pool = MakeUnique<FLogiLedEffectPool>();
+
+	// the first start of each curve copies it...
+	const double CopyStartTime = FPlatformTime::Seconds();
+
+	for (UCurveLinearColor* Curve : Curves)
+	{
+		Pool->Remove(Pool->Add(*Curve, INDEX_NONE, LOGI_DEVICETYPE_PERKEY_RGB));
+	}
+
+	const double CopySeconds = FPlatformTime::Seconds() - CopyStartTime;
+
+	// ...and later starts reuse the copy
+	TArray<FLogiLedEffectHandle> Playing;
+	Playing.SetNum(NumPlaying);
+
+	double ChurnSeconds = 0.0;
+	double EvaluateSeconds = 0.0;
+	double MaxEvaluateSeconds = 0.0;
+	int32 NumStarted = 0;
+	int32 NumFailed = 0;
+	int32 NextPlaying = 0;
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		const double ChurnStartTime = FPlatformTime::Seconds();
+
+		for (int32 EffectIndex = 0; EffectIndex < EffectsPerFrame; ++EffectIndex)
+		{
+			// replace the oldest effect
+			FLogiLedEffectHandle& Handle = Playing[NextPlaying];
+			NextPlaying = (NextPlaying + 1) % NumPlaying;
+
+			Pool->Remove(Handle);
+			Handle = Pool->Add(*Curves[NumStarted % NumCurves], NumStarted % LogiLedKeys::Count, LOGI_DEVICETYPE_PERKEY_RGB);
+
+			if (Handle.IsValid())
+			{
+				++NumStarted;
+			}
+			else
+			{
+				++NumFailed;
+			}
+		}
+
+		const double EvaluateStartTime = FPlatformTime::Seconds();
+
+		for (int32 Position = 0; Position < Pool->Num(); ++Position)
+		{
+			Pool->GetEffect(Position).Time += FrameTime;
+		}
+
+		Pool->Evaluate();
+
+		const double EvaluateEndTime = FPlatformTime::Seconds();
+
+		ChurnSeconds += EvaluateStartTime - ChurnStartTime;
+		EvaluateSeconds += EvaluateEndTime - EvaluateStartTime;
+		MaxEvaluateSeconds = FMath::Max(MaxEvaluateSeconds, EvaluateEndTime - EvaluateStartTime);
+	}
+
+	Pool->Empty();
+
+	UE_LOG(LogLogiLed, Display, TEXT("Started and stopped %i effects with %i curves in %i frames (%.0f per simulated second), %i kept playing"), NumStarted, NumCurves, NumFrames, NumStarted / (NumFrames * FrameTime), NumPlaying);
+	UE_LOG(LogLogiLed, Display, TEXT("First start of a curve (copies it): %.3f us on average"), 1000000.0 * CopySeconds / NumCurves);
+	UE_LOG(LogLogiLed, Display, TEXT("Later start and stop of an effect (reuses the copy): %.3f us on average, %.0f per second of CPU time"), 1000000.0 * ChurnSeconds / FMath::Max(NumStarted + NumFailed, 1), (NumStarted + NumFailed) / FMath::Max(ChurnSeconds, 0.000001));
+	UE_LOG(LogLogiLed, Display, TEXT("Evaluating: %.3f ms per frame on average, %.3f ms at most"), 1000.0 * EvaluateSeconds / NumFrames, 1000.0 * MaxEvaluateSeconds);
+
+	bool Passed = (NumFailed == 0);
+
+	if (!Passed)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to start %i effects"), NumFailed);
+	}
+
+	// batched evaluation compared to evaluating each effect on its own
+	for (int32 NumEffects : { 16, 116, 1000 })
+	{
+		Passed &= LogiLedBenchmarkBatch(Curves, NumEffects, NumFrames, FrameTime);
+	}
+
+	for (UCurveLinearColor* Curve : Curves)
+	{
+		Curve->RemoveFromRoot();
+	}
+
+	return Passed ? 0 : 1;
+}
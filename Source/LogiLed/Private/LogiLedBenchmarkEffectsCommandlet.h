@@ -0,0 +1,49 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedBenchmarkEffectsCommandlet.generated.h"
+
+
+/**
+ * Starts and stops effects in an effect pool at a high rate and reports the cost.
+ *
+ * A number of color curves are created, and effects that play them are started
+ * round-robin, a given number per simulated frame. The oldest effects are
+ * stopped, so that a given number of effects keeps playing, and the playing
+ * effects are evaluated once per frame. The average time to start, stop and
+ * evaluate effects is reported, as well as the time for the first start of
+ * each curve, which copies it, compared to later starts, which reuse the copy.
+ *
+ * Then, the batched evaluation of 16, 116 and 1000 playing effects is compared
+ * with evaluating each effect's curve asset separately, and the results of
+ * both are checked to match. No manager is involved, and no SDK calls are made.
+ *
+ * Usage:
+ *     UE4Editor-Cmd.exe <Project> -run=LogiLedBenchmarkEffects [-Effects=<PerSecond>] [-Playing=<Count>] [-Curves=<Count>] [-Duration=<Seconds>] [-Fps=<Rate>]
+ *
+ * The rate defaults to 100000 effects per second, the number of playing effects
+ * to 200, the number of curves to 8, the duration to 5 seconds, and the frame
+ * rate to 60 frames per second.
+ */
+UCLASS()
+class ULogiLedBenchmarkEffectsCommandlet
+	: public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Default constructor. */
+	ULogiLedBenchmarkEffectsCommandlet();
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+};
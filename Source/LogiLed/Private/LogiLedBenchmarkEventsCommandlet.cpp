@@ -0,0 +1,210 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedBenchmarkEventsCommandlet.h"
+#include "LogiLedEventMap.h"
+#include "LogiLedKeys.h"
+#include "LogiLedManager.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedSnapshot.h"
+
+#include "Curves/CurveLinearColor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+
+/** Number of keys that each event of the transient map plays on. */
+static const int32 LogiLedBenchmarkKeysPerEvent = 8;
+
+
+/**
+ * Make a gameplay tag for the transient event map.
+ *
+ * The tag is not registered with the tags manager, which the event map does
+ * not need, because it only compares and hashes tag names.
+ *
+ * @param Index The tag's index.
+ * @return The tag.
+ */
+static FGameplayTag LogiLedMakeBenchmarkTag(int32 Index)
+{
+	static UNameProperty* TagNameProperty = FindField<UNameProperty>(FGameplayTag::StaticStruct(), TEXT("TagName"));
+	check(TagNameProperty != nullptr);
+
+	FGameplayTag Tag;
+	TagNameProperty->SetPropertyValue_InContainer(&Tag, FName(*FString::Printf(TEXT("LogiLed.Benchmark.Event%i"), Index)));
+
+	return Tag;
+}
+
+
+/**
+ * Create a transient event map with flashes, pulses and color curves.
+ *
+ * @param NumTags The number of tags to bind.
+ * @return The compiled map (rooted, so it is not garbage collected).
+ */
+static ULogiLedEventMap* LogiLedCreateBenchmarkEventMap(int32 NumTags)
+{
+	ULogiLedEventMap* Map = NewObject<ULogiLedEventMap>(GetTransientPackage(), NAME_None, RF_Transient);
+	UCurveLinearColor* Curve = NewObject<UCurveLinearColor>(Map, NAME_None, RF_Transient);
+
+	// a short rise and fall
+	for (int32 Channel = 0; Channel < 3; ++Channel)
+	{
+		FRichCurve& ChannelCurve = Curve->FloatCurves[Channel];
+
+		ChannelCurve.AddKey(0.0f, 0.0f);
+		ChannelCurve.AddKey(0.1f, 1.0f - 0.3f * Channel);
+		ChannelCurve.AddKey(0.5f, 0.0f);
+	}
+
+	for (int32 TagIndex = 0; TagIndex < NumTags; ++TagIndex)
+	{
+		FLogiLedEventBinding& Binding = Map->Bindings[Map->Bindings.AddDefaulted()];
+		{
+			Binding.Tag = LogiLedMakeBenchmarkTag(TagIndex);
+			Binding.Effect = (ELogiLedEventEffect)(TagIndex % 3);
+			Binding.Color = FLinearColor::MakeFromHSV8((uint8)(TagIndex * 37), 255, 255);
+			Binding.EndColor = FLinearColor::Black;
+			Binding.Curve = Curve;
+			Binding.Duration = 0.5f;
+			Binding.Interval = 0.1f;
+		}
+
+		// every fourth event plays on all keys of all devices
+		if (TagIndex % 4 != 3)
+		{
+			for (int32 KeyOffset = 0; KeyOffset < LogiLedBenchmarkKeysPerEvent; ++KeyOffset)
+			{
+				Binding.Keys.Add((ELogiLedKeys)((TagIndex * LogiLedBenchmarkKeysPerEvent + KeyOffset) % LogiLedKeys::Count));
+			}
+		}
+	}
+
+	Map->Compile();
+	Map->AddToRoot();
+
+	return Map;
+}
+
+
+/* ULogiLedBenchmarkEventsCommandlet structors
+ *****************************************************************************/
+
+ULogiLedBenchmarkEventsCommandlet::ULogiLedBenchmarkEventsCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 ULogiLedBenchmarkEventsCommandlet::Main(const FString& Params)
+{
+	FString MapPath;
+	ULogiLedEventMap* Map = nullptr;
+
+	if (FParse::Value(*Params, TEXT("Map="), MapPath))
+	{
+		Map = LoadObject<ULogiLedEventMap>(nullptr, *MapPath);
+
+		if (Map == nullptr)
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Failed to load event map %s"), *MapPath);
+			return 1;
+		}
+
+		Map->AddToRoot();
+	}
+	else
+	{
+		int32 NumTags = 16;
+		FParse::Value(*Params, TEXT("Tags="), NumTags);
+
+		Map = LogiLedCreateBenchmarkEventMap(FMath::Max(NumTags, 1));
+		MapPath = TEXT("(transient)");
+	}
+
+	TArray<FGameplayTag> Tags;
+
+	for (const FLogiLedEventBinding& Binding : Map->Bindings)
+	{
+		if (Map->FindEvent(Binding.Tag) != INDEX_NONE)
+		{
+			Tags.AddUnique(Binding.Tag);
+		}
+	}
+
+	if (Tags.Num() == 0)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Event map %s has no valid bindings"), *MapPath);
+		Map->RemoveFromRoot();
+
+		return 1;
+	}
+
+	float EventsPerSecond = 10000.0f;
+	float Duration = 10.0f;
+	float FramesPerSecond = 60.0f;
+
+	FParse::Value(*Params, TEXT("Events="), EventsPerSecond);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("Fps="), FramesPerSecond);
+
+	FramesPerSecond = FMath::Max(FramesPerSecond, 1.0f);
+
+	const int32 NumFrames = FMath::Max(FMath::FloorToInt(Duration * FramesPerSecond), 1);
+	const int32 EventsPerFrame = FMath::Max(FMath::RoundToInt(EventsPerSecond / FramesPerSecond), 1);
+	const float FrameTime = 1.0f / FramesPerSecond;
+
+	// the manager composes frames only while someone is watching
+	FLogiLedSnapshot& Snapshot = FLogiLedSnapshot::Get();
+	Snapshot.AddViewer();
+
+	FLogiLedManager& Manager = FLogiLedManager::Get();
+
+	double FireSeconds = 0.0;
+	double TickSeconds = 0.0;
+	double MaxTickSeconds = 0.0;
+	int32 NumFired = 0;
+	int32 TagIndex = 0;
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		const double FireStartTime = FPlatformTime::Seconds();
+
+		for (int32 EventIndex = 0; EventIndex < EventsPerFrame; ++EventIndex)
+		{
+			if (Map->FireEvent(Tags[TagIndex]))
+			{
+				++NumFired;
+			}
+
+			TagIndex = (TagIndex + 1) % Tags.Num();
+		}
+
+		const double TickStartTime = FPlatformTime::Seconds();
+		Manager.Tick(FrameTime);
+		const double TickEndTime = FPlatformTime::Seconds();
+
+		FireSeconds += TickStartTime - FireStartTime;
+		TickSeconds += TickEndTime - TickStartTime;
+		MaxTickSeconds = FMath::Max(MaxTickSeconds, TickEndTime - TickStartTime);
+	}
+
+	Manager.StopAnimations();
+	Snapshot.RemoveViewer();
+	Map->RemoveFromRoot();
+
+	UE_LOG(LogLogiLed, Display, TEXT("Fired %i events for %i tags in %i frames (%.0f events per simulated second)"), NumFired, Tags.Num(), NumFrames, NumFired / (NumFrames * FrameTime));
+	UE_LOG(LogLogiLed, Display, TEXT("Firing: %.3f us per event, %.0f events per second of CPU time"), 1000000.0 * FireSeconds / FMath::Max(NumFired, 1), NumFired / FMath::Max(FireSeconds, 0.000001));
+	UE_LOG(LogLogiLed, Display, TEXT("Starting and composing: %.3f ms per frame on average, %.3f ms at most"), 1000.0 * TickSeconds / NumFrames, 1000.0 * MaxTickSeconds);
+
+	return (NumFired == NumFrames * EventsPerFrame) ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedBenchmarkEventsCommandlet.generated.h"
+
+
+/**
+ * Fires the events of an LED event map at a high rate and reports the cost.
+ *
+ * All tags that are bound in the map are fired in turn, a given number of
+ * events per simulated frame, and the manager composes each frame as if LEDs
+ * were connected. The time spent firing events and the time spent starting
+ * and composing them are reported separately. No SDK calls are made.
+ *
+ * Without a map, a transient one is built with the given number of tags,
+ * which are bound to flashes, pulses and a color curve on runs of keys or on
+ * all keys, so that the benchmark runs in any project.
+ *
+ * Usage:
+ *     UE4Editor-Cmd.exe <Project> -run=LogiLedBenchmarkEvents [-Map=<EventMapPath>] [-Tags=<Count>] [-Events=<PerSecond>] [-Duration=<Seconds>] [-Fps=<Rate>]
+ *
+ * The number of tags defaults to 16, the rate to 10000 events per second, the
+ * duration to 10 seconds, and the frame rate to 60 frames per second.
+ */
+UCLASS()
+class ULogiLedBenchmarkEventsCommandlet
+	: public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Default constructor. */
+	ULogiLedBenchmarkEventsCommandlet();
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -1,33 +1,105 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "LogiLedBlueprintLibrary.h"
+#include "LogiLedEffectGraph.h"
+#include "LogiLedKeys.h"
 #include "LogiLedPrivate.h"
+#include "LogiLedSdk.h"
+#include "LogiLedSharedFrame.h"
 
 #include "Classes/Curves/CurveLinearColor.h"
 #include "Classes/Engine/Texture.h"
+#include "Classes/Engine/TextureRenderTarget2D.h"
 #include "TextureResource.h"
-#include "UObject/Package.h"
-#include "UObject/UObjectGlobals.h"
 
 #include "LogitechLEDLib.h"
 
 
-FLogiLedManager ULogiLedBlueprintLibrary::Manager;
+TUniquePtr<FLogiLedAmbient> ULogiLedBlueprintLibrary::Ambient;
+TUniquePtr<FLogiLedConfigCache> ULogiLedBlueprintLibrary::ConfigCache;
+TUniquePtr<FLogiLedMirror> ULogiLedBlueprintLibrary::Mirror;
+TUniquePtr<FLogiLedOpenRgb> ULogiLedBlueprintLibrary::OpenRgb;
 
 
-/* Local constants
+/* ULogiLedBlueprintLibrary static functions
  *****************************************************************************/
 
-const uint32 LogiLedKeyName[] = {
-	0x01, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44, 0x57, 0x58, 0x137, 0x46, 0x145,
-	0x29, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,	0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x152, 0x147,
-	0x149, 0x45, 0x135, 0x37, 0x4A, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
-	0x1A, 0x1B, 0x2B, 0x153, 0x14F, 0x151, 0x47, 0x48, 0x49, 0x4E, 0x3A, 0x1E, 0x1F, 0x20, 0x21, 0x22,
-	0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x1C, 0x4B, 0x4C, 0x4D, 0x2A, 0x2C, 0x2D, 0x2E, 0x2F, 0x30,
-	0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x148, 0x4F, 0x50, 0x51, 0x11C, 0x1D, 0x15B, 0x38, 0x39, 0x138,
-	0x15C, 0x15D, 0x11D, 0x14B, 0x150, 0x14D, 0x52, 0x53, 0xFFF1, 0xFFF2, 0xFFF3, 0xFFF4, 0xFFF5, 0xFFF6,
-	0xFFF7, 0xFFF8, 0xFFF9, 0xFFFF1, 0xFFFF2
-};
+void ULogiLedBlueprintLibrary::DestroyAll()
+{
+	check(IsInGameThread());
+
+	if (Ambient.IsValid())
+	{
+		Ambient->Stop();
+		Ambient.Reset();
+	}
+
+	if (Mirror.IsValid())
+	{
+		Mirror->Stop();
+		Mirror.Reset();
+	}
+
+	if (OpenRgb.IsValid())
+	{
+		OpenRgb->Stop();
+		OpenRgb.Reset();
+	}
+
+	ConfigCache.Reset();
+}
+
+
+FLogiLedAmbient& ULogiLedBlueprintLibrary::GetAmbient()
+{
+	check(IsInGameThread());
+
+	if (!Ambient.IsValid())
+	{
+		Ambient = MakeUnique<FLogiLedAmbient>();
+	}
+
+	return *Ambient;
+}
+
+
+FLogiLedConfigCache& ULogiLedBlueprintLibrary::GetConfigCache()
+{
+	check(IsInGameThread());
+
+	if (!ConfigCache.IsValid())
+	{
+		ConfigCache = MakeUnique<FLogiLedConfigCache>();
+	}
+
+	return *ConfigCache;
+}
+
+
+FLogiLedMirror& ULogiLedBlueprintLibrary::GetMirror()
+{
+	check(IsInGameThread());
+
+	if (!Mirror.IsValid())
+	{
+		Mirror = MakeUnique<FLogiLedMirror>();
+	}
+
+	return *Mirror;
+}
+
+
+FLogiLedOpenRgb& ULogiLedBlueprintLibrary::GetOpenRgb()
+{
+	check(IsInGameThread());
+
+	if (!OpenRgb.IsValid())
+	{
+		OpenRgb = MakeUnique<FLogiLedOpenRgb>();
+	}
+
+	return *OpenRgb;
+}
 
 
 /* ULogiLedBlueprintLibrary interface (generic functions)
@@ -35,22 +107,21 @@ const uint32 LogiLedKeyName[] = {
 
 bool ULogiLedBlueprintLibrary::LogiLedInitialize()
 {
-	if (!::LogiLedInit())
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to initialize Logitech LED SDK"));
-		return false;
-	}
+	FLogiLedSdk::Connect();
 
-	return true;
+	return FLogiLedSdk::IsAvailable();
 }
 
 
 FString ULogiLedBlueprintLibrary::LogiLedKeyToString(ELogiLedKeys Key)
 {
-	static const UEnum* Enum = FindObject<UEnum>(ANY_PACKAGE, TEXT("ELogiLedKeys"));
-	check(Enum);
+	return LogiLedKeys::ToString(Key);
+}
 
-	return Enum->GetNameStringByValue((int64)Key);
+
+void ULogiLedBlueprintLibrary::LogiLedSetDithering(bool Enabled)
+{
+	GetManager().SetDithering(Enabled);
 }
 
 
@@ -66,19 +137,34 @@ bool ULogiLedBlueprintLibrary::LogiLedSetTargetDevice(ELogiLedDeviceType DeviceT
 	case ELogiLedDeviceType::Rgb: TargetDevice = LOGI_DEVICETYPE_RGB; break;
 	}
 
-	if (!::LogiLedSetTargetDevice(TargetDevice))
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to set target device"));
-		return false;
-	}
+	// the SDK target is switched by the manager when needed
+	GetManager().SetTargetDevice(TargetDevice);
 
 	return true;
 }
 
 
+void ULogiLedBlueprintLibrary::LogiLedSetSuspendWhenPaused(bool Suspend)
+{
+	GetManager().SetSuspendWhenPaused(Suspend);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedSetUpdateBudget(float Milliseconds)
+{
+	GetManager().SetBudget(Milliseconds / 1000.0);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedSetUpdatePriority(ELogiLedPriority Priority)
+{
+	GetManager().SetPriority(Priority);
+}
+
+
 void ULogiLedBlueprintLibrary::LogiLedShutdown()
 {
-	::LogiLedShutdown();
+	FLogiLedSdk::Disconnect();
 }
 
 
@@ -87,43 +173,47 @@ void ULogiLedBlueprintLibrary::LogiLedShutdown()
 
 bool ULogiLedBlueprintLibrary::LogiLedGetConfigOptionBool(const FString& ConfigPath, bool DefaultValue)
 {
-	if (!::LogiLedGetConfigOptionBool(*ConfigPath, &DefaultValue))
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to get Boolean config option for %s"), *ConfigPath);
-	}
-
-	return DefaultValue;
+	return GetConfigCache().GetBool(ConfigPath, DefaultValue);
 }
 
 
 FLinearColor ULogiLedBlueprintLibrary::LogiLedGetConfigOptionColor(const FString& ConfigPath, FLinearColor DefaultValue)
 {
-	FColor Default = DefaultValue.ToFColor(false);
+	return FLinearColor(GetConfigCache().GetColor(ConfigPath, DefaultValue.ToFColor(false)));
+}
+
 
-	int R = Default.R;
-	int G = Default.G;
-	int B = Default.B;
+FString ULogiLedBlueprintLibrary::LogiLedGetConfigOptionKeyInput(const FString& ConfigPath, const FString& DefaultValue)
+{
+	return GetConfigCache().GetKeyInput(ConfigPath, DefaultValue);
+}
 
-	if (::LogiLedGetConfigOptionColor(*ConfigPath, &R, &G, &B))
+
+void ULogiLedBlueprintLibrary::LogiLedInvalidateConfigOption(const FString& ConfigPath)
+{
+	if (ConfigPath.IsEmpty())
 	{
-		Default.R = R;
-		Default.G = G;
-		Default.B = B;
+		GetConfigCache().InvalidateAll();
 	}
 	else
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to get color config option for %s"), *ConfigPath);
+		GetConfigCache().Invalidate(ConfigPath);
 	}
-
-return FLinearColor(Default);
 }
 
 
 bool ULogiLedBlueprintLibrary::LogiLedSetConfigOptionLabel(const FString& ConfigPath, FString Label)
 {
-	if (!::LogiLedSetConfigOptionLabel(*ConfigPath, const_cast<wchar_t*>(*Label)))
+	if (!FLogiLedSdk::IsAvailable())
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to set label for config option %s"), *ConfigPath);
+		GetManager().DeferCommand([ConfigPath, Label]() { LogiLedSetConfigOptionLabel(ConfigPath, Label); });
+		return false;
+	}
+
+	if (!::LogiLedSetConfigOptionLabel(FLogiLedSdk::ToSdkString(*ConfigPath), FLogiLedSdk::ToSdkString(*Label)))
+	{
+		static FLogiLedFailureCounter Failures(TEXT("LogiLedSetConfigOptionLabel"), false);
+		Failures.Add();
 		return false;
 	}
 
@@ -133,14 +223,7 @@ bool ULogiLedBlueprintLibrary::LogiLedSetConfigOptionLabel(const FString& Config
 
 float ULogiLedBlueprintLibrary::LogiLedGetConfigOptionNumber(const FString& ConfigPath, float DefaultValue)
 {
-	double OutValue = DefaultValue;
-
-	if (!::LogiLedGetConfigOptionNumber(*ConfigPath, &OutValue))
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to get numeric config option for %s"), *ConfigPath);
-	}
-
-	return (float)OutValue;
+	return (float)GetConfigCache().GetNumber(ConfigPath, DefaultValue);
 }
 
 
@@ -149,68 +232,102 @@ float ULogiLedBlueprintLibrary::LogiLedGetConfigOptionNumber(const FString& Conf
 
 void ULogiLedBlueprintLibrary::LogiLedFlashLighting(FLinearColor Color, FTimespan Duration, FTimespan Interval)
 {
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([Color, Duration, Interval]() { LogiLedFlashLighting(Color, Duration, Interval); });
+		return;
+	}
+
 	const FLinearColor Percentage = Color.GetClamped() * 100.0f;
 
+	GetManager().ApplyTargetDevice();
+
 	if (!::LogiLedFlashLighting(Percentage.R, Percentage.G, Percentage.B, (int)Duration.GetTotalMilliseconds(), (int)Interval.GetTotalMilliseconds()))
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to flash lighting with color %s for duration %s with interval %s"), *Color.ToString(), *Duration.ToString(), *Interval.ToString());
+		static FLogiLedFailureCounter Failures(TEXT("LogiLedFlashLighting"), true);
+		Failures.Add();
 	}
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedPulseLighting(FLinearColor Color, FTimespan Duration, FTimespan Interval)
 {
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([Color, Duration, Interval]() { LogiLedPulseLighting(Color, Duration, Interval); });
+		return;
+	}
+
 	const FLinearColor Percentage = Color.GetClamped() * 100.0f;
 
+	GetManager().ApplyTargetDevice();
+
 	if (!::LogiLedPulseLighting(Percentage.R, Percentage.G, Percentage.B, (int)Duration.GetTotalMilliseconds(), (int)Interval.GetTotalMilliseconds()))
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to pulse lighting with color %s for duration %s with interval %s"), *Color.ToString(), *Duration.ToString(), *Interval.ToString());
+		static FLogiLedFailureCounter Failures(TEXT("LogiLedPulseLighting"), true);
+		Failures.Add();
 	}
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedRestoreLighting()
 {
-	if (!::LogiLedRestoreLighting())
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to restore saved lighting"));
-	}
+	GetManager().RestoreLighting(NAME_None, 0.0f, false);
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedSaveLighting()
 {
-	if (!::LogiLedSaveCurrentLighting())
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to save current lighting"));
-	}
+	GetManager().SaveLighting(NAME_None);
+}
+
+
+bool ULogiLedBlueprintLibrary::LogiLedRestoreLightingSnapshot(FName Name, float FadeSeconds, bool Discard)
+{
+	return GetManager().RestoreLighting(Name, FadeSeconds, Discard);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedSaveLightingSnapshot(FName Name)
+{
+	GetManager().SaveLighting(Name);
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedSetLighting(FLinearColor Color)
 {
-	const FLinearColor Percentage = Color.GetClamped() * 100.0f;
+	GetManager().SetLighting(Color);
+}
 
-	if (!::LogiLedSetLighting(Percentage.R, Percentage.G, Percentage.B))
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to set lighting to %s"), *Color.ToString());
-	}
+
+FLogiLedEffectHandle ULogiLedBlueprintLibrary::LogiledSetLightingCurve(UCurveLinearColor* ColorCurve)
+{
+	return GetManager().PlayAnimation(ColorCurve);
 }
 
 
-void ULogiLedBlueprintLibrary::LogiledSetLightingCurve(UCurveLinearColor* ColorCurve)
+void ULogiLedBlueprintLibrary::LogiLedStopEffect(FLogiLedEffectHandle Effect)
 {
-	Manager.PlayAnimation(ColorCurve);
+	GetManager().StopAnimation(Effect);
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedStopEffects()
 {
-	Manager.StopAnimations();
+	GetManager().StopAnimations();
+
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([]() { ::LogiLedStopEffects(); });
+		return;
+	}
+
+	GetManager().ApplyTargetDevice();
 
 	if (!::LogiLedStopEffects())
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to stop effects"));
+		static FLogiLedFailureCounter Failures(TEXT("LogiLedStopEffects"), true);
+		Failures.Add();
 	}
 }
 
@@ -220,38 +337,62 @@ void ULogiLedBlueprintLibrary::LogiLedStopEffects()
 
 void ULogiLedBlueprintLibrary::LogiLedExcludeKeysFromTexture(TArray<ELogiLedKeys> Keys)
 {
+	GetManager().ExcludeKeysFromBitmap(Keys);
+
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([Keys]() { LogiLedExcludeKeysFromTexture(Keys); });
+		return;
+	}
+
 	TArray<LogiLed::KeyName> KeyNames;
 
 	for (auto Key : Keys)
 	{
-		KeyNames.Add((LogiLed::KeyName)LogiLedKeyName[(int)Key]);
+		KeyNames.Add(LogiLedKeys::ToKeyName(Key));
 	}
 
 	if (!::LogiLedExcludeKeysFromBitmap(KeyNames.GetData(), KeyNames.Num()))
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to exclude keys from bitmap"));
+		static FLogiLedFailureCounter Failures(TEXT("LogiLedExcludeKeysFromTexture"), false);
+		Failures.Add();
 	}
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedFlashLightingForKey(ELogiLedKeys Key, FLinearColor Color, FTimespan Duration, FTimespan Interval)
 {
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([Key, Color, Duration, Interval]() { LogiLedFlashLightingForKey(Key, Color, Duration, Interval); });
+		return;
+	}
+
 	const FLinearColor Percentage = Color.GetClamped() * 100.0f;
 
+	GetManager().ApplyTargetDevice();
+
 	if (!::LogiLedFlashSingleKey(
-		(LogiLed::KeyName)LogiLedKeyName[(int)Key],
+		LogiLedKeys::ToKeyName(Key),
 		Percentage.R, Percentage.G, Percentage.B,
 		(int)Duration.GetTotalMilliseconds(),
 		(int)Interval.GetTotalMilliseconds()
 	))
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to flash lighting for key %s"), *LogiLedKeyToString(Key));
+		static FLogiLedFailureCounter Failures(TEXT("LogiLedFlashLightingForKey"), false);
+		Failures.Add();
 	}
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedFlashLightingForKeys(const TArray<ELogiLedKeys> Keys, FLinearColor Color, FTimespan Duration, FTimespan Interval)
 {
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([Keys, Color, Duration, Interval]() { LogiLedFlashLightingForKeys(Keys, Color, Duration, Interval); });
+		return;
+	}
+
 	for (const auto& Key : Keys)
 	{
 		LogiLedFlashLightingForKey(Key, Color, Duration, Interval);
@@ -261,24 +402,39 @@ void ULogiLedBlueprintLibrary::LogiLedFlashLightingForKeys(const TArray<ELogiLed
 
 void ULogiLedBlueprintLibrary::LogiLedPulseLightingForKey(ELogiLedKeys Key, FLinearColor StartColor, FLinearColor EndColor, FTimespan Duration, bool Infinite)
 {
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([Key, StartColor, EndColor, Duration, Infinite]() { LogiLedPulseLightingForKey(Key, StartColor, EndColor, Duration, Infinite); });
+		return;
+	}
+
 	const FLinearColor StartPercentage = StartColor.GetClamped() * 100.0f;
 	const FLinearColor EndPercentage = EndColor.GetClamped() * 100.0f;
 
+	GetManager().ApplyTargetDevice();
+
 	if (!::LogiLedPulseSingleKey(
-		(LogiLed::KeyName)LogiLedKeyName[(int)Key],
+		LogiLedKeys::ToKeyName(Key),
 		StartPercentage.R, StartPercentage.G, StartPercentage.B,
 		EndPercentage.R, EndPercentage.G, EndPercentage.B,
 		(int)Duration.GetTotalMilliseconds(),
 		Infinite
 	))
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to pulse lighting for key %s"), *LogiLedKeyToString(Key));
+		static FLogiLedFailureCounter Failures(TEXT("LogiLedPulseLightingForKey"), false);
+		Failures.Add();
 	}
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedPulseLightingForKeys(const TArray<ELogiLedKeys>& Keys, FLinearColor StartColor, FLinearColor EndColor, FTimespan Duration, bool Infinite)
 {
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([Keys, StartColor, EndColor, Duration, Infinite]() { LogiLedPulseLightingForKeys(Keys, StartColor, EndColor, Duration, Infinite); });
+		return;
+	}
+
 	for (const auto& Key : Keys)
 	{
 		LogiLedPulseLightingForKey(Key, StartColor, EndColor, Duration, Infinite);
@@ -288,43 +444,33 @@ void ULogiLedBlueprintLibrary::LogiLedPulseLightingForKeys(const TArray<ELogiLed
 
 void ULogiLedBlueprintLibrary::LogiLedRestoreLightingForKey(ELogiLedKeys Key)
 {
-	if (!::LogiLedRestoreLightingForKey((LogiLed::KeyName)LogiLedKeyName[(int)Key]))
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to restore lighting for key %s"), *LogiLedKeyToString(Key));
-	}
+	const TArray<ELogiLedKeys> Keys = { Key };
+	GetManager().RestoreLighting(NAME_None, 0.0f, false, &Keys);
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedRestoreLightingForKeys(const TArray<ELogiLedKeys>& Keys)
 {
-	for (const auto& Key : Keys)
-	{
-		LogiLedRestoreLightingForKey(Key);
-	}
+	GetManager().RestoreLighting(NAME_None, 0.0f, false, &Keys);
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedSaveLightingForKey(ELogiLedKeys Key)
 {
-	if (!::LogiLedSaveLightingForKey((LogiLed::KeyName)LogiLedKeyName[(int)Key]))
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to save lighting for key %s"), *LogiLedKeyToString(Key));
-	}
+	const TArray<ELogiLedKeys> Keys = { Key };
+	GetManager().SaveLighting(NAME_None, &Keys);
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedSaveLightingForKeys(const TArray<ELogiLedKeys>& Keys)
 {
-	for (const auto& Key : Keys)
-	{
-		LogiLedSaveLightingForKey(Key);
-	}
+	GetManager().SaveLighting(NAME_None, &Keys);
 }
 
 
-void ULogiLedBlueprintLibrary::LogiLedSetLightingCurveForKey(ELogiLedKeys Key, UCurveLinearColor* ColorCurve)
+FLogiLedEffectHandle ULogiLedBlueprintLibrary::LogiLedSetLightingCurveForKey(ELogiLedKeys Key, UCurveLinearColor* ColorCurve)
 {
-	Manager.PlayAnimation((LogiLed::KeyName)LogiLedKeyName[(int)Key], ColorCurve);
+	return GetManager().PlayAnimation(Key, ColorCurve);
 }
 
 
@@ -339,12 +485,7 @@ void ULogiLedBlueprintLibrary::LogiLedSetLightingCurveForKeys(const TArray<ELogi
 
 void ULogiLedBlueprintLibrary::LogiLedSetLightingForKey(ELogiLedKeys Key, FLinearColor Color)
 {
-	const FLinearColor Percentage = Color.GetClamped() * 100.0f;
-
-	if (!::LogiLedSetLightingForKeyWithKeyName((LogiLed::KeyName)LogiLedKeyName[(int)Key], Percentage.R, Percentage.G, Percentage.B))
-	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to set lighting to %s for key %s"), *Color.ToString(), *LogiLedKeyToString(Key));
-	}
+	GetManager().SetLightingForKey(Key, Color);
 }
 
 
@@ -352,7 +493,7 @@ void ULogiLedBlueprintLibrary::LogiLedSetLightingForKeys(const TArray<ELogiLedKe
 {
 	for (const auto& Key : Keys)
 	{
-		LogiLedSetLightingForKey(Key, Color);
+		GetManager().SetLightingForKey(Key, Color);
 	}
 }
 
@@ -370,20 +511,44 @@ void ULogiLedBlueprintLibrary::LogiLedSetLightingFromTexture(UTexture* Texture)
 	if ((Height != LOGI_LED_BITMAP_HEIGHT) || (Width != LOGI_LED_BITMAP_WIDTH))
 	{
 		UE_LOG(LogLogiLed, Warning, TEXT("Lighting texture must be %ix%i, but it is %ix%i"), LOGI_LED_BITMAP_WIDTH, LOGI_LED_BITMAP_HEIGHT, Width, Height);
+		return;
 	}
 
-	// @todo gmp: logiled: implement lighting from texture
+	UTextureRenderTarget2D* RenderTarget = Cast<UTextureRenderTarget2D>(Texture);
+
+	if (RenderTarget == nullptr)
+	{
+		UE_LOG(LogLogiLed, Warning, TEXT("Lighting texture %s must be a render target"), *Texture->GetName());
+		return;
+	}
+
+	// blocks until rendering is done; ULogiLedMaterialComponent reads back asynchronously
+	TArray<FColor> Pixels;
+
+	if (RenderTarget->GameThread_GetRenderTargetResource()->ReadPixels(Pixels))
+	{
+		GetManager().SetLightingFromBitmap(Pixels.GetData());
+	}
 }
 
 
 void ULogiLedBlueprintLibrary::LogiLedStopEffectForKey(ELogiLedKeys Key)
 {
-	auto KeyName = (LogiLed::KeyName)LogiLedKeyName[(int)Key];
-	Manager.StopAnimations(KeyName);
+	auto KeyName = LogiLedKeys::ToKeyName(Key);
+	GetManager().StopAnimations(Key);
+
+	if (!FLogiLedSdk::IsAvailable())
+	{
+		GetManager().DeferCommand([KeyName]() { ::LogiLedStopEffectsOnKey(KeyName); });
+		return;
+	}
+
+	GetManager().ApplyTargetDevice();
 
 	if (!::LogiLedStopEffectsOnKey(KeyName))
 	{
-		UE_LOG(LogLogiLed, Verbose, TEXT("Failed to stop effects for key %s"), *LogiLedKeyToString(Key));
+		static FLogiLedFailureCounter Failures(TEXT("LogiLedStopEffectForKey"), false);
+		Failures.Add();
 	}
 }
 
@@ -395,3 +560,158 @@ void ULogiLedBlueprintLibrary::LogiLedStopEffectForKeys(const TArray<ELogiLedKey
 		LogiLedStopEffectForKey(Key);
 	}
 }
+
+
+/* ULogiLedBlueprintLibrary interface (meter functions)
+ *****************************************************************************/
+
+void ULogiLedBlueprintLibrary::LogiLedBindMeter(FName Name, const FLogiLedMeter& Meter)
+{
+	GetManager().BindMeter(Name, Meter);
+}
+
+
+TArray<ELogiLedKeys> ULogiLedBlueprintLibrary::LogiLedGetKeyRange(ELogiLedKeys First, ELogiLedKeys Last)
+{
+	const int32 Step = (Last >= First) ? 1 : -1;
+	TArray<ELogiLedKeys> Keys;
+
+	for (int32 KeyIndex = (int32)First; KeyIndex != (int32)Last + Step; KeyIndex += Step)
+	{
+		Keys.Add((ELogiLedKeys)KeyIndex);
+	}
+
+	return Keys;
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedSetMeterValue(FName Name, float Value)
+{
+	GetManager().SetMeterValue(Name, Value);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedUnbindMeter(FName Name)
+{
+	GetManager().UnbindMeter(Name);
+}
+
+
+/* ULogiLedBlueprintLibrary interface (effect graph functions)
+ *****************************************************************************/
+
+bool ULogiLedBlueprintLibrary::LogiLedPlayEffectGraph(ULogiLedEffectGraph* Graph)
+{
+	if (Graph == nullptr)
+	{
+		GetManager().StopEffectGraph();
+		return false;
+	}
+
+	return GetManager().PlayEffectGraph(*Graph);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedSetEffectParameter(FName Name, float Value)
+{
+	GetManager().SetEffectParameter(Name, Value);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedStopEffectGraph()
+{
+	GetManager().StopEffectGraph();
+}
+
+
+/* ULogiLedBlueprintLibrary interface (ambient functions)
+ *****************************************************************************/
+
+void ULogiLedBlueprintLibrary::LogiLedStartAmbientMode(int32 FrameInterval, float SmoothingSeconds)
+{
+	GetAmbient().Start(FrameInterval, SmoothingSeconds);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedStopAmbientMode()
+{
+	if (Ambient.IsValid())
+	{
+		Ambient->Stop();
+	}
+}
+
+
+/* ULogiLedBlueprintLibrary interface (mirroring functions)
+ *****************************************************************************/
+
+float ULogiLedBlueprintLibrary::LogiLedGetMirrorBytesPerSecond()
+{
+	return Mirror.IsValid() ? Mirror->GetBytesPerSecond() : 0.0f;
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedSetMirrorBandwidth(int32 MaxBytesPerSecond)
+{
+	GetMirror().SetMaxBytesPerSecond(MaxBytesPerSecond);
+}
+
+
+bool ULogiLedBlueprintLibrary::LogiLedStartMirrorReceiver(int32 Port)
+{
+	return GetMirror().StartReceiving(Port);
+}
+
+
+bool ULogiLedBlueprintLibrary::LogiLedStartMirrorSender(const FString& Address)
+{
+	return GetMirror().StartSending(Address);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedStopMirror()
+{
+	if (Mirror.IsValid())
+	{
+		Mirror->Stop();
+	}
+}
+
+
+/* ULogiLedBlueprintLibrary interface (OpenRGB functions)
+ *****************************************************************************/
+
+bool ULogiLedBlueprintLibrary::LogiLedIsOpenRgbConnected()
+{
+	return OpenRgb.IsValid() && OpenRgb->IsConnected();
+}
+
+
+bool ULogiLedBlueprintLibrary::LogiLedStartOpenRgb(const FString& Address)
+{
+	return GetOpenRgb().Start(Address);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedStopOpenRgb()
+{
+	if (OpenRgb.IsValid())
+	{
+		OpenRgb->Stop();
+	}
+}
+
+
+/* ULogiLedBlueprintLibrary interface (export functions)
+ *****************************************************************************/
+
+bool ULogiLedBlueprintLibrary::LogiLedStartSharedFrameExport(const FString& Name)
+{
+	return FLogiLedSharedFrame::Get().Open(Name);
+}
+
+
+void ULogiLedBlueprintLibrary::LogiLedStopSharedFrameExport()
+{
+	FLogiLedSharedFrame::Get().Close();
+}
@@ -5,152 +5,22 @@
 #include "CoreTypes.h"
 #include "Containers/Array.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "LogiLedAmbient.h"
+#include "LogiLedConfigCache.h"
 #include "LogiLedManager.h"
+#include "LogiLedMirror.h"
+#include "LogiLedOpenRgb.h"
+#include "LogiLedTypes.h"
+#include "Templates/UniquePtr.h"
 #include "UObject/ObjectMacros.h"
 
 #include "LogiLedBlueprintLibrary.generated.h"
 
 class UCurveLinearColor;
+class ULogiLedEffectGraph;
 class UTexture;
 
 
-/**
- * Enumerates available Logitech LED device types.
- */
-UENUM()
-enum class ELogiLedDeviceType : uint8
-{
-	All,
-	Monochrome,
-	PerKeyRgb,
-	Rgb
-};
-
-
-/**
- * Enumerates available Logitech LED mouse and keyboard keys.
- */
-UENUM()
-enum class ELogiLedKeys : uint8
-{
-	Escape,
-	F1,
-	F2,
-	F3,
-	F4,
-	F5,
-	F6,
-	F7,
-	F8,
-	F9,
-	F10,
-	F11,
-	F12,
-	PrintScreen,
-	ScrollLock,
-	PauseBreak,
-	Tilde,
-	One,
-	Two,
-	Three,
-	Four,
-	Five,
-	Six,
-	Seven,
-	Eight,
-	Nine,
-	Zero,
-	Minus,
-	Equals,
-	Backspace,
-	Insert,
-	Home,
-	PageUp,
-	NumLock,
-	NumSlash,
-	NumAsterisk,
-	NumMinus,
-	Tab,
-	Q,
-	W,
-	E,
-	R,
-	T,
-	Y,
-	U,
-	I,
-	O,
-	P,
-	OpenBracket,
-	CloseBracket,
-	Backslash,
-	KeyboardDelete,
-	End,
-	PageDown,
-	NumSeven,
-	NumEight,
-	NumNine,
-	NumPlus,
-	CapsLock,
-	A,
-	S,
-	D,
-	F,
-	G,
-	H,
-	J,
-	K,
-	L,
-	Semicolon,
-	Apostrophe,
-	Enter,
-	NumFour,
-	NumFive,
-	NumSix,
-	LeftShift,
-	Z,
-	X,
-	C,
-	V,
-	B,
-	N,
-	M,
-	Comma,
-	Period,
-	ForwardSlash,
-	RightShift,
-	ArrowUp,
-	NumOne,
-	NumTwo,
-	NumThree,
-	NumEnter,
-	LeftControl,
-	LeftWindows,
-	LeftAlt,
-	Space,
-	RightAlt,
-	RightWindows,
-	ApplicationSelect,
-	RightControl,
-	ArrowLeft,
-	ArrowDown,
-	ArrowRight,
-	NumZero,
-	NumPeriod,
-	G1,
-	G2,
-	G3,
-	G4,
-	G5,
-	G6,
-	G7,
-	G8,
-	G9,
-	GLogo,
-	GBadge
-};
-
-
 /**
  * Blueprint function library for Logitech LED SDK.
  */
@@ -165,7 +35,10 @@ public:
 	/**
 	 * Initialize the Logitech LED SDK.
 	 *
-	 * @return true on success, false otherwise.
+	 * The SDK is initialized in the background, and initialization is retried
+	 * until Logitech Gaming Software or G HUB becomes available.
+	 *
+	 * @return true if the SDK is connected, false if it is still connecting.
 	 * @see LogiLedShutdown
 	 */
 	UFUNCTION(BlueprintCallable, Category="LogiLed")
@@ -180,15 +53,61 @@ public:
 	UFUNCTION(BlueprintCallable, Category="LogiLed")
 	static FString LogiLedKeyToString(ELogiLedKeys Key);
 
+	/**
+	 * Enable or disable temporal dithering of curve effects.
+	 *
+	 * Dithering smooths slow and dim fades, which otherwise visibly step because
+	 * devices only support 100 brightness levels per channel.
+	 *
+	 * @param Enabled Whether to dither.
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed")
+	static void LogiLedSetDithering(bool Enabled);
+
 	/**
 	 * Set the target device type for future LogiLed calls.
 	 *
+	 * The lighting of each device type is tracked separately. Unless set explicitly,
+	 * RGB and monochrome devices show the average color of the per-key lighting.
+	 *
 	 * @param DeviceType The device type(s) to set.
 	 * @return true on success, false otherwise.
 	 */
 	UFUNCTION(BlueprintCallable, Category="LogiLed")
 	static bool LogiLedSetTargetDevice(ELogiLedDeviceType DeviceType);
 
+	/**
+	 * Set whether LED output is suspended while the game is paused.
+	 *
+	 * Output is always suspended while the application is in the background.
+	 * Suspended changes are applied when output resumes.
+	 *
+	 * @param Suspend Whether to suspend output while paused (default = true).
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed")
+	static void LogiLedSetSuspendWhenPaused(bool Suspend);
+
+	/**
+	 * Set the time that may be spent sending lighting updates to devices per frame.
+	 *
+	 * When the budget is exceeded, keys are updated in priority order and the
+	 * remaining keys are updated in later frames.
+	 *
+	 * @param Milliseconds The budget (0 = unlimited).
+	 * @see LogiLedSetUpdatePriority
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed")
+	static void LogiLedSetUpdateBudget(float Milliseconds);
+
+	/**
+	 * Set the priority for future LogiLed calls.
+	 *
+	 * @param Priority The priority of lighting changes.
+	 * @see LogiLedSetUpdateBudget
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed")
+	static void LogiLedSetUpdatePriority(ELogiLedPriority Priority);
+
 	/**
 	 * Shut down the Logitech LED SDK.
 	 *
@@ -219,6 +138,26 @@ public:
 	UFUNCTION(BlueprintCallable, Category="LogiLed|Config")
 	static FLinearColor LogiLedGetConfigOptionColor(const FString& ConfigPath, FLinearColor DefaultValue);
 
+	/**
+	 * Get the specified key input config option.
+	 *
+	 * @param ConfigPath Path to the config option to get.
+	 * @param DefaultValue The option's default value.
+	 * @return The key input config value.
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Config")
+	static FString LogiLedGetConfigOptionKeyInput(const FString& ConfigPath, const FString& DefaultValue);
+
+	/**
+	 * Read the specified config option from the SDK again the next time it is requested.
+	 *
+	 * Config options are cached, and refreshed every few seconds.
+	 *
+	 * @param ConfigPath Path to the config option to invalidate, or empty to invalidate all options.
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Config")
+	static void LogiLedInvalidateConfigOption(const FString& ConfigPath);
+
 	/**
 	 * Set the label for the specified config option.
 	 *
@@ -277,6 +216,21 @@ public:
 	UFUNCTION(BlueprintCallable, Category="LogiLed|General")
 	static void LogiLedRestoreLighting();
 
+	/**
+	 * Restore a named lighting snapshot.
+	 *
+	 * Snapshots are kept in memory, so restoring one does not need any SDK
+	 * calls besides sending the restored lighting.
+	 *
+	 * @param Name The name of the snapshot.
+	 * @param FadeSeconds Time over which to cross-fade from the current lighting (0 = instantly).
+	 * @param Discard Whether to remove the snapshot and all snapshots saved after it.
+	 * @return true if the snapshot was found, false otherwise.
+	 * @see LogiLedSaveLightingSnapshot
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|General")
+	static bool LogiLedRestoreLightingSnapshot(FName Name, float FadeSeconds = 0.0f, bool Discard = true);
+
 	/**
 	 * Save the current lighting so that it can be restored.
 	 *
@@ -285,6 +239,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category="LogiLed|General")
 	static void LogiLedSaveLighting();
 
+	/**
+	 * Save the current lighting in a named snapshot.
+	 *
+	 * Snapshots are kept on a stack, so that nested states, such as menus, can
+	 * save the lighting when they open and restore it when they close.
+	 *
+	 * @param Name The name of the snapshot (replaces any snapshot with the same name).
+	 * @see LogiLedRestoreLightingSnapshot
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|General")
+	static void LogiLedSaveLightingSnapshot(FName Name);
+
 	/**
 	 * Set the lighting on the targeted devices.
 	 *
@@ -303,10 +269,22 @@ public:
 	 * Play a color curve on the target device.
 	 *
 	 * @param ColorCurve The color curve to play.
-	 * @see LogiLedAnimateSingleKey
+	 * @return Handle to the curve effect.
+	 * @see LogiLedAnimateSingleKey, LogiLedStopEffect
 	 */
 	UFUNCTION(BlueprintCallable, Category="LogiLed|General")
-	static void LogiledSetLightingCurve(UCurveLinearColor* ColorCurve);
+	static FLogiLedEffectHandle LogiledSetLightingCurve(UCurveLinearColor* ColorCurve);
+
+	/**
+	 * Stop a curve effect.
+	 *
+	 * The keys keep the effect's last color.
+	 *
+	 * @param Effect Handle to the effect to stop.
+	 * @see LogiledSetLightingCurve, LogiLedSetLightingCurveForKey
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|General")
+	static void LogiLedStopEffect(FLogiLedEffectHandle Effect);
 
 	/**
 	 * Stop any active flashing, pulsing, or curve effect.
@@ -419,10 +397,11 @@ public:
 	 *
 	 * @param Key The key to play the color curve on.
 	 * @param ColorCurve The color curve to play.
-	 * @see LogiledAnimateLighting, LogiLedSetTargetDevice
+	 * @return Handle to the curve effect.
+	 * @see LogiledAnimateLighting, LogiLedSetTargetDevice, LogiLedStopEffect
 	 */
 	UFUNCTION(BlueprintCallable, Category="LogiLed|PerKey")
-	static void LogiLedSetLightingCurveForKey(ELogiLedKeys Key, UCurveLinearColor* ColorCurve);
+	static FLogiLedEffectHandle LogiLedSetLightingCurveForKey(ELogiLedKeys Key, UCurveLinearColor* ColorCurve);
 
 	/**
 	 * Play a color curve on the specified keys.
@@ -456,9 +435,11 @@ public:
 	 * Set the lighting of keys on the target device based on pixels in a texture.
 	 *
 	 * The texture is organized as an array of 21x6 RGBA pixels, representing the
-	 * keys on the target device.
+	 * keys on the target device. Only render targets are supported, and reading
+	 * them waits for rendering to finish. Use a LogiLed Material component to
+	 * update the lighting from a material continuously.
 	 *
-	 * @param Texture The texture containing the lighting color values.
+	 * @param Texture The render target containing the lighting color values.
 	 * @see LogiLedExcludeKeysFromTexture
 	 */
 	UFUNCTION(BlueprintCallable, Category="LogiLed|PerKey")
@@ -482,8 +463,288 @@ public:
 	UFUNCTION(BlueprintCallable, Category="LogiLed|PerKey")
 	static void LogiLedStopEffectForKeys(const TArray<ELogiLedKeys>& Keys);
 
+public:
+
+	/**
+	 * Bind a meter, such as a health or ammo bar, to a sequence of keys.
+	 *
+	 * Use LogiLedSetMeterValue to update the meter. Only the keys that change
+	 * are updated, so the value can be set every tick.
+	 *
+	 * @param Name The meter's name (replaces any meter with the same name).
+	 * @param Meter The meter's keys and colors.
+	 * @see LogiLedGetKeyRange, LogiLedSetMeterValue, LogiLedUnbindMeter
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Meter")
+	static void LogiLedBindMeter(FName Name, const FLogiLedMeter& Meter);
+
+	/**
+	 * Get a range of consecutive keys, such as F1 to F12 or the number row.
+	 *
+	 * @param First The first key.
+	 * @param Last The last key (may be before the first key to reverse the range).
+	 * @return The keys.
+	 * @see LogiLedBindMeter
+	 */
+	UFUNCTION(BlueprintPure, Category="LogiLed|Meter")
+	static TArray<ELogiLedKeys> LogiLedGetKeyRange(ELogiLedKeys First, ELogiLedKeys Last);
+
+	/**
+	 * Set the value that a meter shows.
+	 *
+	 * @param Name The meter's name.
+	 * @param Value The value to show (0 = empty, 1 = full).
+	 * @see LogiLedBindMeter
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Meter")
+	static void LogiLedSetMeterValue(FName Name, float Value);
+
+	/**
+	 * Remove a meter, leaving its keys lit as they are.
+	 *
+	 * @param Name The meter's name.
+	 * @see LogiLedBindMeter
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Meter")
+	static void LogiLedUnbindMeter(FName Name);
+
+public:
+
+	/**
+	 * Play an effect graph on all per-key devices.
+	 *
+	 * The graph is evaluated natively on all keys every LED frame, so complex
+	 * lighting does not need per-key Blueprint logic every tick.
+	 *
+	 * @param Graph The effect graph to play.
+	 * @return true if the graph is playing, false if it could not be compiled.
+	 * @see LogiLedSetEffectParameter, LogiLedStopEffectGraph
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Graph")
+	static bool LogiLedPlayEffectGraph(ULogiLedEffectGraph* Graph);
+
+	/**
+	 * Set a gameplay parameter of effect graphs.
+	 *
+	 * @param Name The name of the parameter.
+	 * @param Value The value to set.
+	 * @see LogiLedPlayEffectGraph
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Graph")
+	static void LogiLedSetEffectParameter(FName Name, float Value);
+
+	/**
+	 * Stop the playing effect graph.
+	 *
+	 * @see LogiLedPlayEffectGraph
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Graph")
+	static void LogiLedStopEffectGraph();
+
+public:
+
+	/**
+	 * Mirror the colors on screen onto the per-key lighting.
+	 *
+	 * The game viewport is downsampled to the key bitmap on the GPU every few
+	 * frames and read back without stalling, so the keys lag the screen by a
+	 * few frames. Keys that are excluded from textures keep their lighting.
+	 *
+	 * @param FrameInterval Number of frames between captures.
+	 * @param SmoothingSeconds Time over which the keys follow changes on screen (0 = immediately).
+	 * @see LogiLedExcludeKeysFromTexture, LogiLedStopAmbientMode
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Ambient")
+	static void LogiLedStartAmbientMode(int32 FrameInterval = 4, float SmoothingSeconds = 0.25f);
+
+	/**
+	 * Stop mirroring the colors on screen.
+	 *
+	 * The keys keep their current lighting.
+	 *
+	 * @see LogiLedStartAmbientMode
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Ambient")
+	static void LogiLedStopAmbientMode();
+
+public:
+
+	/**
+	 * Get the number of bytes per second that the lighting mirror sends or receives.
+	 *
+	 * @return Bytes per second, averaged over the last second.
+	 * @see LogiLedStartMirrorReceiver, LogiLedStartMirrorSender
+	 */
+	UFUNCTION(BlueprintPure, Category="LogiLed|Mirror")
+	static float LogiLedGetMirrorBytesPerSecond();
+
+	/**
+	 * Set the maximum number of bytes per second that the lighting mirror sends.
+	 *
+	 * @param MaxBytesPerSecond The bandwidth cap (at least 512).
+	 * @see LogiLedStartMirrorSender
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Mirror")
+	static void LogiLedSetMirrorBandwidth(int32 MaxBytesPerSecond);
+
+	/**
+	 * Show the lighting that another process mirrors to this one.
+	 *
+	 * Mirrored keys take precedence over all other lighting on this machine.
+	 *
+	 * @param Port The UDP port to receive on.
+	 * @return true on success, false otherwise.
+	 * @see LogiLedStartMirrorSender, LogiLedStopMirror
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Mirror")
+	static bool LogiLedStartMirrorReceiver(int32 Port = 7788);
+
+	/**
+	 * Mirror this process' per-key lighting to another process.
+	 *
+	 * @param Address The receiver's address and port, i.e. 127.0.0.1:7788.
+	 * @return true on success, false otherwise.
+	 * @see LogiLedSetMirrorBandwidth, LogiLedStartMirrorReceiver, LogiLedStopMirror
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Mirror")
+	static bool LogiLedStartMirrorSender(const FString& Address);
+
+	/**
+	 * Stop mirroring lighting.
+	 *
+	 * @see LogiLedStartMirrorReceiver, LogiLedStartMirrorSender
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Mirror")
+	static void LogiLedStopMirror();
+
+public:
+
+	/**
+	 * Check whether the OpenRGB output is connected to a server.
+	 *
+	 * @return true if connected, false otherwise.
+	 * @see LogiLedStartOpenRgb
+	 */
+	UFUNCTION(BlueprintPure, Category="LogiLed|OpenRGB")
+	static bool LogiLedIsOpenRgbConnected();
+
+	/**
+	 * Send the per-key lighting to an OpenRGB server.
+	 *
+	 * OpenRGB drives devices from many vendors, including on platforms where
+	 * the Logitech SDK is not available. Keyboard LEDs show their keys, and all
+	 * other LEDs show the average color of the keys. The connection is retried
+	 * until the server is available.
+	 *
+	 * @param Address The server's IP address and optional port.
+	 * @return true on success, false if the address is invalid.
+	 * @see LogiLedIsOpenRgbConnected, LogiLedStopOpenRgb
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|OpenRGB")
+	static bool LogiLedStartOpenRgb(const FString& Address = TEXT("127.0.0.1:6742"));
+
+	/**
+	 * Stop sending lighting to an OpenRGB server.
+	 *
+	 * @see LogiLedStartOpenRgb
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|OpenRGB")
+	static void LogiLedStopOpenRgb();
+
+public:
+
+	/**
+	 * Export the per-key lighting to a named shared memory segment.
+	 *
+	 * External tools, such as stream overlays or bridges to other lighting
+	 * software, can read the current frame from the segment at any time. See
+	 * FLogiLedSharedFrameData for the layout.
+	 *
+	 * @param Name The segment's name.
+	 * @return true on success, false if the segment could not be mapped.
+	 * @see LogiLedStopSharedFrameExport
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Export")
+	static bool LogiLedStartSharedFrameExport(const FString& Name = TEXT("LogiLedFrame"));
+
+	/**
+	 * Stop exporting the per-key lighting to shared memory.
+	 *
+	 * @see LogiLedStartSharedFrameExport
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Export")
+	static void LogiLedStopSharedFrameExport();
+
+public:
+
+	/**
+	 * Stop and destroy the ambient mode, config cache, mirror and OpenRGB output.
+	 *
+	 * They are created again on next use. Called when the module shuts down,
+	 * while the socket subsystem is still available.
+	 */
+	static void DestroyAll();
+
+	/**
+	 * Get the ambient mode that mirrors the colors on screen.
+	 *
+	 * The ambient mode is created on first use.
+	 *
+	 * @return The ambient mode.
+	 */
+	static FLogiLedAmbient& GetAmbient();
+
+	/**
+	 * Get the cache of config option values.
+	 *
+	 * The cache is created on first use.
+	 *
+	 * @return The config cache.
+	 */
+	static FLogiLedConfigCache& GetConfigCache();
+
+	/**
+	 * Get the manager that tracks lighting state and timing.
+	 *
+	 * The manager is created on first use. In the editor, each PIE instance
+	 * has its own manager.
+	 *
+	 * @return The manager of the current PIE instance, or the global manager.
+	 */
+	static FLogiLedManager& GetManager()
+	{
+		return FLogiLedManager::Get();
+	}
+
+	/**
+	 * Get the mirror that sends lighting to or receives lighting from other processes.
+	 *
+	 * The mirror is created on first use.
+	 *
+	 * @return The mirror.
+	 */
+	static FLogiLedMirror& GetMirror();
+
+	/**
+	 * Get the output that sends lighting to an OpenRGB server.
+	 *
+	 * The output is created on first use.
+	 *
+	 * @return The OpenRGB output.
+	 */
+	static FLogiLedOpenRgb& GetOpenRgb();
+
 private:
 
-	/** State and timing manager. */
-	static FLogiLedManager Manager;
+	/** Ambient mode (created on first use, because it registers a tickable object). */
+	static TUniquePtr<FLogiLedAmbient> Ambient;
+
+	/** Cache of config option values (created on first use, because it binds to the SDK's connection delegate). */
+	static TUniquePtr<FLogiLedConfigCache> ConfigCache;
+
+	/** Lighting mirror (created on first use). */
+	static TUniquePtr<FLogiLedMirror> Mirror;
+
+	/** OpenRGB output (created on first use). */
+	static TUniquePtr<FLogiLedOpenRgb> OpenRgb;
 };
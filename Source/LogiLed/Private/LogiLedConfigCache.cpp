@@ -0,0 +1,262 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedConfigCache.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedSdk.h"
+
+#include "HAL/PlatformTime.h"
+
+#include "LogitechLEDLib.h"
+
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Config Cache Misses"), STAT_LogiLedConfigCacheMisses, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Config Cache Refreshes"), STAT_LogiLedConfigCacheRefreshes, STATGROUP_LogiLed);
+
+
+/** Time after which cached options are refreshed (in seconds). */
+static const double LogiLedConfigRefreshInterval = 5.0;
+
+/** Maximum length of key input options. */
+static const int32 LogiLedConfigMaxKeyInputLength = 256;
+
+
+/* FLogiLedConfigCache structors
+ *****************************************************************************/
+
+FLogiLedConfigCache::FLogiLedConfigCache()
+{
+	FLogiLedSdk::OnConnected().AddRaw(this, &FLogiLedConfigCache::HandleSdkConnected);
+}
+
+
+FLogiLedConfigCache::~FLogiLedConfigCache()
+{
+	FLogiLedSdk::OnConnected().RemoveAll(this);
+}
+
+
+/* FLogiLedConfigCache interface
+ *****************************************************************************/
+
+bool FLogiLedConfigCache::GetBool(const FString& ConfigPath, bool DefaultValue)
+{
+	FEntry& Entry = FindOrAdd(ConfigPath, EType::Bool);
+
+	if (!Entry.Resolved)
+	{
+		Entry.DefaultNumber = DefaultValue ? 1.0 : 0.0;
+	}
+
+	return Prepare(ConfigPath, Entry) ? (Entry.Number != 0.0) : DefaultValue;
+}
+
+
+FColor FLogiLedConfigCache::GetColor(const FString& ConfigPath, FColor DefaultValue)
+{
+	FEntry& Entry = FindOrAdd(ConfigPath, EType::Color);
+
+	if (!Entry.Resolved)
+	{
+		Entry.DefaultColor = DefaultValue;
+	}
+
+	return Prepare(ConfigPath, Entry) ? Entry.Color : DefaultValue;
+}
+
+
+FString FLogiLedConfigCache::GetKeyInput(const FString& ConfigPath, const FString& DefaultValue)
+{
+	FEntry& Entry = FindOrAdd(ConfigPath, EType::KeyInput);
+
+	if (!Entry.Resolved)
+	{
+		Entry.DefaultString = DefaultValue.Left(LogiLedConfigMaxKeyInputLength - 1);
+	}
+
+	return Prepare(ConfigPath, Entry) ? Entry.String : DefaultValue;
+}
+
+
+double FLogiLedConfigCache::GetNumber(const FString& ConfigPath, double DefaultValue)
+{
+	FEntry& Entry = FindOrAdd(ConfigPath, EType::Number);
+
+	if (!Entry.Resolved)
+	{
+		Entry.DefaultNumber = DefaultValue;
+	}
+
+	return Prepare(ConfigPath, Entry) ? Entry.Number : DefaultValue;
+}
+
+
+void FLogiLedConfigCache::Invalidate(const FString& ConfigPath)
+{
+	FEntry* Entry = Entries.Find(ConfigPath);
+
+	if (Entry != nullptr)
+	{
+		Entry->Stale = true;
+	}
+}
+
+
+void FLogiLedConfigCache::InvalidateAll()
+{
+	for (auto& Pair : Entries)
+	{
+		Pair.Value.Stale = true;
+	}
+}
+
+
+/* FTickableGameObject interface
+ *****************************************************************************/
+
+TStatId FLogiLedConfigCache::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FLogiLedConfigCache, STATGROUP_Tickables);
+}
+
+
+bool FLogiLedConfigCache::IsTickable() const
+{
+	return (Entries.Num() > 0) && FLogiLedSdk::IsAvailable();
+}
+
+
+bool FLogiLedConfigCache::IsTickableInEditor() const
+{
+	return true;
+}
+
+
+void FLogiLedConfigCache::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	// refresh at most one option per tick, so refreshes never cause a hitch
+	for (auto& Pair : Entries)
+	{
+		FEntry& Entry = Pair.Value;
+
+		if (Entry.Resolved && (Entry.RefreshTime <= Now))
+		{
+			Resolve(Pair.Key, Entry);
+			INC_DWORD_STAT(STAT_LogiLedConfigCacheRefreshes);
+
+			break;
+		}
+	}
+}
+
+
+/* FLogiLedConfigCache implementation
+ *****************************************************************************/
+
+FLogiLedConfigCache::FEntry& FLogiLedConfigCache::FindOrAdd(const FString& ConfigPath, EType Type)
+{
+	FEntry* Entry = Entries.Find(ConfigPath);
+
+	if ((Entry == nullptr) || (Entry->Type != Type))
+	{
+		// options may be read before any lighting is set
+		FLogiLedSdk::Connect();
+
+		Entry = &Entries.Add(ConfigPath);
+		Entry->Type = Type;
+		Entry->Resolved = false;
+		Entry->Stale = true;
+		Entry->RefreshTime = 0.0;
+		Entry->DefaultNumber = 0.0;
+		Entry->Number = 0.0;
+		Entry->DefaultColor = FColor::Black;
+		Entry->Color = FColor::Black;
+	}
+
+	return *Entry;
+}
+
+
+bool FLogiLedConfigCache::Prepare(const FString& ConfigPath, FEntry& Entry)
+{
+	if (Entry.Stale && FLogiLedSdk::IsAvailable())
+	{
+		Resolve(ConfigPath, Entry);
+		INC_DWORD_STAT(STAT_LogiLedConfigCacheMisses);
+	}
+
+	return Entry.Resolved;
+}
+
+
+void FLogiLedConfigCache::Resolve(const FString& ConfigPath, FEntry& Entry)
+{
+	check(FLogiLedSdk::IsAvailable());
+
+	wchar_t* SdkPath = FLogiLedSdk::ToSdkString(*ConfigPath);
+	bool Succeeded = false;
+
+	switch (Entry.Type)
+	{
+	case EType::Bool:
+		{
+			bool Value = (Entry.DefaultNumber != 0.0);
+			Succeeded = ::LogiLedGetConfigOptionBool(SdkPath, &Value);
+			Entry.Number = Value ? 1.0 : 0.0;
+		}
+		break;
+
+	case EType::Color:
+		{
+			int R = Entry.DefaultColor.R;
+			int G = Entry.DefaultColor.G;
+			int B = Entry.DefaultColor.B;
+
+			Succeeded = ::LogiLedGetConfigOptionColor(SdkPath, &R, &G, &B);
+			Entry.Color = Succeeded ? FColor((uint8)R, (uint8)G, (uint8)B) : Entry.DefaultColor;
+		}
+		break;
+
+	case EType::KeyInput:
+		{
+			// the SDK returns the value in the buffer that holds the default value
+			TCHAR Buffer[LogiLedConfigMaxKeyInputLength];
+			FCString::Strncpy(Buffer, *Entry.DefaultString, LogiLedConfigMaxKeyInputLength);
+
+			Succeeded = ::LogiLedGetConfigOptionKeyInput(SdkPath, FLogiLedSdk::ToSdkString(Buffer), LogiLedConfigMaxKeyInputLength);
+			Buffer[LogiLedConfigMaxKeyInputLength - 1] = TEXT('\0');
+			Entry.String = Succeeded ? FString(Buffer) : Entry.DefaultString;
+		}
+		break;
+
+	case EType::Number:
+		{
+			double Value = Entry.DefaultNumber;
+			Succeeded = ::LogiLedGetConfigOptionNumber(SdkPath, &Value);
+			Entry.Number = Succeeded ? Value : Entry.DefaultNumber;
+		}
+		break;
+	}
+
+	if (!Succeeded)
+	{
+		static FLogiLedFailureCounter Failures(TEXT("FLogiLedConfigCache::Resolve"), false);
+		Failures.Add();
+	}
+
+	// options that failed keep their default value until the next refresh
+	Entry.Resolved = true;
+	Entry.Stale = false;
+	Entry.RefreshTime = FPlatformTime::Seconds() + LogiLedConfigRefreshInterval;
+}
+
+
+/* FLogiLedConfigCache callbacks
+ *****************************************************************************/
+
+void FLogiLedConfigCache::HandleSdkConnected()
+{
+	// options may have changed while the SDK was down
+	InvalidateAll();
+}
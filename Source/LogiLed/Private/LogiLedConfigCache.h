@@ -0,0 +1,171 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "Math/Color.h"
+#include "Tickable.h"
+
+
+/**
+ * Caches the values of user configurable options.
+ *
+ * Options are read from the SDK the first time they are requested, and then
+ * returned from memory. Cached options are refreshed in the background, one
+ * option per tick, so that changes that users make in Logitech Gaming Software
+ * or G HUB are picked up eventually. SDK calls must be made on the game thread,
+ * so refreshes are spread over game thread ticks instead of running on their
+ * own thread.
+ *
+ * The SDK registers an option with the default value of the first request,
+ * so the cache uses the default value of the first request, too.
+ */
+class FLogiLedConfigCache
+	: public FTickableGameObject
+{
+public:
+
+	/** Default constructor. */
+	FLogiLedConfigCache();
+
+	/** Virtual destructor. */
+	~FLogiLedConfigCache();
+
+public:
+
+	/**
+	 * Get a Boolean option.
+	 *
+	 * @param ConfigPath Path to the option.
+	 * @param DefaultValue The option's default value.
+	 * @return The option's value.
+	 */
+	bool GetBool(const FString& ConfigPath, bool DefaultValue);
+
+	/**
+	 * Get a color option.
+	 *
+	 * @param ConfigPath Path to the option.
+	 * @param DefaultValue The option's default value.
+	 * @return The option's value.
+	 */
+	FColor GetColor(const FString& ConfigPath, FColor DefaultValue);
+
+	/**
+	 * Get a key input option.
+	 *
+	 * @param ConfigPath Path to the option.
+	 * @param DefaultValue The option's default value.
+	 * @return The option's value.
+	 */
+	FString GetKeyInput(const FString& ConfigPath, const FString& DefaultValue);
+
+	/**
+	 * Get a numeric option.
+	 *
+	 * @param ConfigPath Path to the option.
+	 * @param DefaultValue The option's default value.
+	 * @return The option's value.
+	 */
+	double GetNumber(const FString& ConfigPath, double DefaultValue);
+
+	/**
+	 * Read an option from the SDK again the next time it is requested.
+	 *
+	 * @param ConfigPath Path to the option.
+	 * @see InvalidateAll
+	 */
+	void Invalidate(const FString& ConfigPath);
+
+	/**
+	 * Read all options from the SDK again the next time they are requested.
+	 *
+	 * @see Invalidate
+	 */
+	void InvalidateAll();
+
+public:
+
+	//~ FTickableGameObject interface
+
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableInEditor() const override;
+	virtual void Tick(float DeltaTime) override;
+
+private:
+
+	/** Types of options. */
+	enum class EType : uint8
+	{
+		Bool,
+		Color,
+		KeyInput,
+		Number
+	};
+
+	/** A cached option. */
+	struct FEntry
+	{
+		/** The option's type. */
+		EType Type;
+
+		/** Whether the option was read from the SDK. */
+		bool Resolved;
+
+		/** Whether the option must be read again before it is returned. */
+		bool Stale;
+
+		/** Time at which the option is refreshed in the background. */
+		double RefreshTime;
+
+		/** Default and current value of Boolean and numeric options. */
+		double DefaultNumber;
+		double Number;
+
+		/** Default and current value of color options. */
+		FColor DefaultColor;
+		FColor Color;
+
+		/** Default and current value of key input options. */
+		FString DefaultString;
+		FString String;
+	};
+
+	/**
+	 * Find an option, or add it if it is not cached with the given type.
+	 *
+	 * @param ConfigPath Path to the option.
+	 * @param Type The option's type.
+	 * @return The option.
+	 */
+	FEntry& FindOrAdd(const FString& ConfigPath, EType Type);
+
+	/**
+	 * Read an option from the SDK if it was invalidated or not read yet.
+	 *
+	 * @param ConfigPath Path to the option.
+	 * @param Entry The option.
+	 * @return true if the option has a value from the SDK, false otherwise.
+	 */
+	bool Prepare(const FString& ConfigPath, FEntry& Entry);
+
+	/**
+	 * Read an option from the SDK.
+	 *
+	 * @param ConfigPath Path to the option.
+	 * @param Entry The option.
+	 */
+	void Resolve(const FString& ConfigPath, FEntry& Entry);
+
+private:
+
+	/** Callback for when the SDK has been (re-)connected. */
+	void HandleSdkConnected();
+
+private:
+
+	/** Cached options by path. */
+	TMap<FString, FEntry> Entries;
+};
@@ -0,0 +1,153 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedDumpFramesCommandlet.h"
+#include "LogiLedBlueprintLibrary.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedSnapshot.h"
+
+#include "Curves/CurveLinearColor.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+
+/** Background color of the virtual keyboard. */
+static const FColor LogiLedDumpBackgroundColor(16, 16, 16);
+
+
+/* ULogiLedDumpFramesCommandlet structors
+ *****************************************************************************/
+
+ULogiLedDumpFramesCommandlet::ULogiLedDumpFramesCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 ULogiLedDumpFramesCommandlet::Main(const FString& Params)
+{
+	FString CurvePath;
+
+	if (!FParse::Value(*Params, TEXT("Curve="), CurvePath))
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Usage: -run=LogiLedDumpFrames -Curve=<CurvePath> [-Duration=<Seconds>] [-Fps=<Rate>] [-Scale=<PixelsPerKey>] [-Output=<Directory>]"));
+		return 1;
+	}
+
+	UCurveLinearColor* Curve = LoadObject<UCurveLinearColor>(nullptr, *CurvePath);
+
+	if (Curve == nullptr)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to load color curve %s"), *CurvePath);
+		return 1;
+	}
+
+	float MinTime = 0.0f;
+	float MaxTime = 0.0f;
+	Curve->GetTimeRange(MinTime, MaxTime);
+
+	float Duration = MaxTime;
+	float FramesPerSecond = 30.0f;
+	int32 Scale = 16;
+	FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LogiLed"), TEXT("Frames"));
+
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("Fps="), FramesPerSecond);
+	FParse::Value(*Params, TEXT("Scale="), Scale);
+	FParse::Value(*Params, TEXT("Output="), OutputDir);
+
+	FramesPerSecond = FMath::Max(FramesPerSecond, 1.0f);
+	Scale = FMath::Clamp(Scale, 1, 256);
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+
+	// the manager publishes frames only while someone is watching
+	FLogiLedSnapshot& Snapshot = FLogiLedSnapshot::Get();
+	Snapshot.AddViewer();
+
+	FLogiLedManager& Manager = ULogiLedBlueprintLibrary::GetManager();
+	Manager.PlayAnimation(Curve);
+
+	const int32 NumFrames = FMath::FloorToInt(Duration * FramesPerSecond) + 1;
+	const float FrameTime = 1.0f / FramesPerSecond;
+
+	FColor Colors[FLogiLedSnapshot::MaxKeys];
+	TArray<FColor> Pixels;
+	int32 NumWritten = 0;
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		Manager.Tick((FrameIndex == 0) ? 0.0f : FrameTime);
+		Snapshot.Read(Colors);
+
+		int32 Width = 0;
+		int32 Height = 0;
+		DrawFrame(Colors, Scale, Width, Height, Pixels);
+
+		if (!ImageWrapper->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Failed to encode frame %i"), FrameIndex);
+			break;
+		}
+
+		const FString FileName = FPaths::Combine(OutputDir, FString::Printf(TEXT("Frame_%05i.png"), FrameIndex));
+
+		if (!FFileHelper::SaveArrayToFile(ImageWrapper->GetCompressed(), *FileName))
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Failed to write %s"), *FileName);
+			break;
+		}
+
+		++NumWritten;
+	}
+
+	Manager.StopAnimations();
+	Snapshot.RemoveViewer();
+
+	UE_LOG(LogLogiLed, Display, TEXT("Wrote %i of %i frames to %s"), NumWritten, NumFrames, *OutputDir);
+
+	return (NumWritten == NumFrames) ? 0 : 1;
+}
+
+
+/* ULogiLedDumpFramesCommandlet implementation
+ *****************************************************************************/
+
+void ULogiLedDumpFramesCommandlet::DrawFrame(const FColor* Colors, int32 Scale, int32& OutWidth, int32& OutHeight, TArray<FColor>& OutPixels) const
+{
+	const FVector2D LayoutSize = FLogiLedSnapshot::GetLayoutSize();
+
+	OutWidth = FMath::CeilToInt(LayoutSize.X * Scale);
+	OutHeight = FMath::CeilToInt(LayoutSize.Y * Scale);
+
+	OutPixels.Init(LogiLedDumpBackgroundColor, OutWidth * OutHeight);
+
+	for (int32 KeyIndex = 0; KeyIndex < FLogiLedSnapshot::GetNumKeys(); ++KeyIndex)
+	{
+		const FBox2D Bounds = FLogiLedSnapshot::GetKeyBounds(KeyIndex);
+		const FColor Color = FLogiLedSnapshot::ToDisplayColor(Colors[KeyIndex]);
+
+		const int32 MinX = FMath::RoundToInt(Bounds.Min.X * Scale);
+		const int32 MinY = FMath::RoundToInt(Bounds.Min.Y * Scale);
+		const int32 MaxX = FMath::Min(FMath::RoundToInt(Bounds.Max.X * Scale), OutWidth);
+		const int32 MaxY = FMath::Min(FMath::RoundToInt(Bounds.Max.Y * Scale), OutHeight);
+
+		for (int32 Y = MinY; Y < MaxY; ++Y)
+		{
+			for (int32 X = MinX; X < MaxX; ++X)
+			{
+				OutPixels[Y * OutWidth + X] = Color;
+			}
+		}
+	}
+}
@@ -0,0 +1,54 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedDumpFramesCommandlet.generated.h"
+
+
+/**
+ * Plays a color curve on a virtual keyboard and dumps the frames as a PNG sequence.
+ *
+ * This shows what the plugin outputs on machines without Logitech hardware,
+ * such as build machines. No SDK calls are made.
+ *
+ * Usage:
+ *     UE4Editor-Cmd.exe <Project> -run=LogiLedDumpFrames -Curve=<CurvePath> [-Duration=<Seconds>] [-Fps=<Rate>] [-Scale=<PixelsPerKey>] [-Output=<Directory>]
+ *
+ * The duration defaults to the curve's time range, the rate to 30 frames per
+ * second, the scale to 16 pixels per key, and the output directory to
+ * Saved/LogiLed/Frames.
+ */
+UCLASS()
+class ULogiLedDumpFramesCommandlet
+	: public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Default constructor. */
+	ULogiLedDumpFramesCommandlet();
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	/**
+	 * Draw a frame on a virtual keyboard.
+	 *
+	 * @param Colors The percentage colors of all keys.
+	 * @param Scale The size of a key cell (in pixels).
+	 * @param OutWidth Will contain the width of the image.
+	 * @param OutHeight Will contain the height of the image.
+	 * @param OutPixels Will contain the image's pixels.
+	 */
+	void DrawFrame(const FColor* Colors, int32 Scale, int32& OutWidth, int32& OutHeight, TArray<FColor>& OutPixels) const;
+};
@@ -0,0 +1,44 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedEffectGraph.h"
+#include "LogiLedEffectProgram.h"
+
+
+/* FLogiLedEffectNode structors
+ *****************************************************************************/
+
+FLogiLedEffectNode::FLogiLedEffectNode()
+	: Type(ELogiLedEffectNodeType::Constant)
+	, InputA(INDEX_NONE)
+	, InputB(INDEX_NONE)
+	, AlphaInput(INDEX_NONE)
+	, Color(FLinearColor::White)
+	, EndColor(FLinearColor::Black)
+	, Curve(nullptr)
+	, Looping(true)
+	, Direction(1.0f, 0.0f)
+	, Scale(4.0f)
+	, Speed(1.0f)
+	, BlendMode(ELogiLedEffectBlendMode::Lerp)
+	, Alpha(1.0f)
+	, InMin(0.0f)
+	, InMax(1.0f)
+{ }
+
+
+/* UObject interface
+ *****************************************************************************/
+
+#if WITH_EDITOR
+
+void ULogiLedEffectGraph::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// show compile errors while the graph is edited
+	FLogiLedEffectProgram Program;
+	CompileError.Reset();
+	Program.Compile(*this, CompileError);
+}
+
+#endif
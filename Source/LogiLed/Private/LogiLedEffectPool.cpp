@@ -0,0 +1,653 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedEffectPool.h"
+#include "LogiLedPrivate.h"
+
+#include "Classes/Curves/CurveLinearColor.h"
+#include "HAL/PlatformTime.h"
+#include "Math/VectorRegister.h"
+#include "Templates/Sorting.h"
+#include "UObject/UObjectGlobals.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Curve Evaluations"), STAT_LogiLedCurveEvaluations, STATGROUP_LogiLed);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Curve Copies"), STAT_LogiLedCurveCopies, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effects Rejected"), STAT_LogiLedEffectsRejected, STATGROUP_LogiLed);
+
+
+/** Minimum time between two summaries of effects that could not be started (in seconds). */
+static const double LogiLedRejectLogInterval = 1.0;
+
+
+/** Number of times a curve asset was edited, which invalidates all cached curve copies. */
+static uint32 LogiLedCurveChangeCount = 0;
+
+
+/* Local helpers
+ *****************************************************************************/
+
+/**
+ * Get the time for which a curve channel keeps its current value.
+ *
+ * @param Curve The curve channel to check.
+ * @param Time The current curve time.
+ * @return Time until the value may change, 0 if it is changing, or MAX_flt if it never changes.
+ */
+static float GetConstantTimeRemaining(const FRichCurve& Curve, float Time)
+{
+	const TArray<FRichCurveKey>& Keys = Curve.Keys;
+
+	if (Keys.Num() < 2)
+	{
+		return MAX_flt;
+	}
+
+	if (Time >= Keys.Last().Time)
+	{
+		return ((Curve.PostInfinityExtrap == RCCE_Constant) || (Curve.PostInfinityExtrap == RCCE_None)) ? MAX_flt : 0.0f;
+	}
+
+	if (Time < Keys[0].Time)
+	{
+		return ((Curve.PreInfinityExtrap == RCCE_Constant) || (Curve.PreInfinityExtrap == RCCE_None)) ? Keys[0].Time - Time : 0.0f;
+	}
+
+	for (int32 KeyIndex = 0; KeyIndex < Keys.Num() - 1; ++KeyIndex)
+	{
+		const FRichCurveKey& Key = Keys[KeyIndex];
+		const FRichCurveKey& NextKey = Keys[KeyIndex + 1];
+
+		if (Time >= NextKey.Time)
+		{
+			continue;
+		}
+
+		const bool Flat = (Key.Value == NextKey.Value) &&
+			((Key.InterpMode == RCIM_Linear) || ((Key.LeaveTangent == 0.0f) && (NextKey.ArriveTangent == 0.0f)));
+
+		return ((Key.InterpMode == RCIM_Constant) || Flat) ? NextKey.Time - Time : 0.0f;
+	}
+
+	return 0.0f;
+}
+
+
+/**
+ * Get the time for which a color curve keeps its current RGB value.
+ *
+ * @param Channels The red, green and blue curve channels to check.
+ * @param Time The current curve time.
+ * @return Time until the color may change, 0 if it is changing, or MAX_flt if it never changes.
+ */
+static float GetConstantTimeRemaining(const FRichCurve* Channels, float Time)
+{
+	float Remaining = MAX_flt;
+
+	for (int32 Channel = 0; (Channel < 3) && (Remaining > 0.0f); ++Channel)
+	{
+		Remaining = FMath::Min(Remaining, GetConstantTimeRemaining(Channels[Channel], Time));
+	}
+
+	return Remaining;
+}
+
+
+
+
+#if WITH_EDITOR
+
+/** Callback for when an object is about to be modified in the editor. */
+static void LogiLedHandleObjectModified(UObject* Object)
+{
+	if ((Object != nullptr) && Object->IsA<UCurveLinearColor>())
+	{
+		++LogiLedCurveChangeCount;
+	}
+}
+
+
+/** Callback for when an object's property was changed in the editor, i.e. by undo. */
+static void LogiLedHandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	LogiLedHandleObjectModified(Object);
+}
+
+#endif
+
+
+/**
+ * Set the output of an effect.
+ *
+ * @param Effect The effect to set.
+ * @param Color The linear color.
+ */
+static void SetEffectValue(FLogiLedEffect& Effect, const FLinearColor& Color)
+{
+	Effect.Exact = Color.GetClamped() * 100.0f;
+	Effect.Value = FColor((uint8)Effect.Exact.R, (uint8)Effect.Exact.G, (uint8)Effect.Exact.B);
+}
+
+
+/* FLogiLedEffectPool structors
+ *****************************************************************************/
+
+FLogiLedEffectPool::FLogiLedEffectPool()
+	: NumActive(0)
+	, NumFree(MaxEffects)
+	, NumReleases(0)
+	, NumRejected(0)
+	, NextRejectLogTime(0.0)
+{
+	for (int32 Slot = 0; Slot < MaxEffects; ++Slot)
+	{
+		Generations[Slot] = 1;
+
+		// hand out low slots first
+		FreeSlots[Slot] = MaxEffects - 1 - Slot;
+	}
+
+	for (FCurve& Curve : Curves)
+	{
+		Curve.Source = nullptr;
+		Curve.ChangeCount = 0;
+		Curve.ReleasedAt = 0;
+		Curve.NumUsers = 0;
+		Curve.Packed = false;
+	}
+}
+
+
+/* FLogiLedEffectPool static functions
+ *****************************************************************************/
+
+void FLogiLedEffectPool::StartTrackingCurveChanges()
+{
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectModified.AddStatic(&LogiLedHandleObjectModified);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddStatic(&LogiLedHandleObjectPropertyChanged);
+#endif
+}
+
+
+void FLogiLedEffectPool::StopTrackingCurveChanges()
+{
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectModified.RemoveStatic(&LogiLedHandleObjectModified);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveStatic(&LogiLedHandleObjectPropertyChanged);
+#endif
+}
+
+
+/* FLogiLedEffectPool interface
+ *****************************************************************************/
+
+FLogiLedEffectHandle FLogiLedEffectPool::Add(const UCurveLinearColor& Curve, int32 KeyIndex, int32 TargetDevice)
+{
+	if (NumFree == 0)
+	{
+		Reject();
+		return FLogiLedEffectHandle();
+	}
+
+	const int32 CurveIndex = AcquireCurve(Curve);
+
+	if (CurveIndex == INDEX_NONE)
+	{
+		return FLogiLedEffectHandle();
+	}
+
+	return AddEffect(CurveIndex, KeyIndex, TargetDevice);
+}
+
+
+FLogiLedEffectHandle FLogiLedEffectPool::Add(int32 CurveIndex, int32 KeyIndex, int32 TargetDevice)
+{
+	check(Curves[CurveIndex].NumUsers > 0);
+
+	if (NumFree == 0)
+	{
+		Reject();
+		return FLogiLedEffectHandle();
+	}
+
+	++Curves[CurveIndex].NumUsers;
+
+	return AddEffect(CurveIndex, KeyIndex, TargetDevice);
+}
+
+
+int32 FLogiLedEffectPool::AcquireCurve(const UCurveLinearColor& Curve)
+{
+	int32 CurveIndex = INDEX_NONE;
+
+	for (int32 Index = 0; Index < MaxCurves; ++Index)
+	{
+		if (Curves[Index].Source == &Curve)
+		{
+			CurveIndex = Index;
+			break;
+		}
+	}
+
+	if (CurveIndex != INDEX_NONE)
+	{
+		FCurve& Cached = Curves[CurveIndex];
+
+		// reuse the copy if the asset was neither replaced nor edited since it was copied
+		if ((Cached.ChangeCount == LogiLedCurveChangeCount) && (Cached.SourceObject.Get() == &Curve))
+		{
+			++Cached.NumUsers;
+			return CurveIndex;
+		}
+
+		// a stale copy keeps playing until its effects stop, but is not found anymore
+		if (Cached.NumUsers > 0)
+		{
+			Cached.Source = nullptr;
+			CurveIndex = INDEX_NONE;
+		}
+	}
+
+	if (CurveIndex == INDEX_NONE)
+	{
+		// use an empty slot, or else the copy that has been unused for the longest time
+		for (int32 Index = 0; Index < MaxCurves; ++Index)
+		{
+			const FCurve& Candidate = Curves[Index];
+
+			if (Candidate.NumUsers > 0)
+			{
+				continue;
+			}
+
+			if (Candidate.Source == nullptr)
+			{
+				CurveIndex = Index;
+				break;
+			}
+
+			if ((CurveIndex == INDEX_NONE) || (NumReleases - Candidate.ReleasedAt > NumReleases - Curves[CurveIndex].ReleasedAt))
+			{
+				CurveIndex = Index;
+			}
+		}
+
+		if (CurveIndex == INDEX_NONE)
+		{
+			Reject();
+			return INDEX_NONE;
+		}
+	}
+
+	FCurve& Copy = Curves[CurveIndex];
+	{
+		Copy.Source = &Curve;
+		Copy.SourceObject = &Curve;
+		Copy.ChangeCount = LogiLedCurveChangeCount;
+
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			const FRichCurve& Source = Curve.FloatCurves[Channel];
+			FRichCurve& Target = Copy.Channels[Channel];
+
+			// reuse the key storage; key handles are not needed for evaluation
+			Target.Keys.Reset();
+			Target.Keys.Append(Source.Keys);
+			Target.PreInfinityExtrap = Source.PreInfinityExtrap;
+			Target.PostInfinityExtrap = Source.PostInfinityExtrap;
+			Target.DefaultValue = Source.DefaultValue;
+		}
+
+		++Copy.NumUsers;
+	}
+
+	PackCurve(CurveIndex);
+	INC_DWORD_STAT(STAT_LogiLedCurveCopies);
+
+	return CurveIndex;
+}
+
+
+void FLogiLedEffectPool::ReleaseCurve(int32 CurveIndex)
+{
+	FCurve& Copy = Curves[CurveIndex];
+
+	if (--Copy.NumUsers == 0)
+	{
+		// keep the copy, so it is reused if the curve is played again
+		Copy.ReleasedAt = ++NumReleases;
+	}
+}
+
+
+
+void FLogiLedEffectPool::Empty()
+{
+	while (NumActive > 0)
+	{
+		Remove(GetHandle(NumActive - 1));
+	}
+}
+
+
+void FLogiLedEffectPool::Evaluate()
+{
+	// sort effects that need evaluation by curve (counting sort)...
+	FMemory::Memzero(CurveStarts);
+
+	for (int32 Position = 0; Position < NumActive; ++Position)
+	{
+		const FLogiLedEffect& Effect = Effects[ActiveSlots[Position]];
+
+		// output is unchanged while the curve is in a constant segment
+		if (Effect.Time >= Effect.ConstantUntil)
+		{
+			++CurveStarts[Effect.CurveIndex + 1];
+		}
+	}
+
+	for (int32 CurveIndex = 0; CurveIndex < MaxCurves; ++CurveIndex)
+	{
+		CurveStarts[CurveIndex + 1] += CurveStarts[CurveIndex];
+	}
+
+	int32 CurveEnds[MaxCurves];
+	FMemory::Memcpy(CurveEnds, CurveStarts, sizeof(CurveEnds));
+
+	for (int32 Position = 0; Position < NumActive; ++Position)
+	{
+		const int32 Slot = ActiveSlots[Position];
+		const FLogiLedEffect& Effect = Effects[Slot];
+
+		if (Effect.Time >= Effect.ConstantUntil)
+		{
+			SortedSlots[CurveEnds[Effect.CurveIndex]++] = Slot;
+		}
+	}
+
+	// ...then by time, and evaluate each curve's effects together
+	for (int32 CurveIndex = 0; CurveIndex < MaxCurves; ++CurveIndex)
+	{
+		const int32 Start = CurveStarts[CurveIndex];
+		const int32 Count = CurveStarts[CurveIndex + 1] - Start;
+
+		if (Count == 0)
+		{
+			continue;
+		}
+
+		Sort(SortedSlots + Start, Count, [this](int32 A, int32 B) { return (Effects[A].Time < Effects[B].Time); });
+		EvaluateCurve(CurveIndex, SortedSlots + Start, Count);
+	}
+}
+
+
+FLogiLedEffect* FLogiLedEffectPool::Find(FLogiLedEffectHandle Handle)
+{
+	if ((Handle.Index < 0) || (Handle.Index >= MaxEffects) || (Generations[Handle.Index] != Handle.Generation))
+	{
+		return nullptr;
+	}
+
+	return &Effects[Handle.Index];
+}
+
+
+bool FLogiLedEffectPool::Remove(FLogiLedEffectHandle Handle)
+{
+	if (Find(Handle) == nullptr)
+	{
+		return false;
+	}
+
+	const int32 Slot = Handle.Index;
+
+	ReleaseCurve(Effects[Slot].CurveIndex);
+
+	// invalidate outstanding handles
+	++Generations[Slot];
+
+	// swap the last playing effect into the removed effect's position
+	const int32 Position = ActivePositions[Slot];
+	const int32 LastSlot = ActiveSlots[--NumActive];
+
+	ActiveSlots[Position] = LastSlot;
+	ActivePositions[LastSlot] = Position;
+
+	FreeSlots[NumFree++] = Slot;
+
+	return true;
+}
+
+
+/* FLogiLedEffectPool implementation
+ *****************************************************************************/
+
+FLogiLedEffectHandle FLogiLedEffectPool::AddEffect(int32 CurveIndex, int32 KeyIndex, int32 TargetDevice)
+{
+	const int32 Slot = FreeSlots[--NumFree];
+
+	FLogiLedEffect& Effect = Effects[Slot];
+	{
+		Effect.CurveIndex = CurveIndex;
+		Effect.Time = 0.0f;
+		Effect.ConstantUntil = 0.0f;
+		Effect.Value = FColor::Black;
+		Effect.Exact = FLinearColor::Black;
+		Effect.KeyIndex = KeyIndex;
+		Effect.TargetDevice = TargetDevice;
+		Effect.Event = false;
+	}
+
+	ActivePositions[Slot] = NumActive;
+	ActiveSlots[NumActive++] = Slot;
+
+	return FLogiLedEffectHandle(Slot, Generations[Slot]);
+}
+
+
+void FLogiLedEffectPool::EvaluateCurve(int32 CurveIndex, const int32* Slots, int32 NumSlots)
+{
+	const FCurve& Curve = Curves[CurveIndex];
+	const FLogiLedEffect* Previous = nullptr;
+
+	int32 SegmentIndex = INDEX_NONE;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+	{
+		FLogiLedEffect& Effect = Effects[Slots[SlotIndex]];
+		const float Time = Effect.Time;
+
+		// effects at the same time share the result
+		if ((Previous != nullptr) && (Previous->Time == Time))
+		{
+			Effect.Value = Previous->Value;
+			Effect.Exact = Previous->Exact;
+			Effect.ConstantUntil = Previous->ConstantUntil;
+
+			continue;
+		}
+
+		Previous = &Effect;
+		INC_DWORD_STAT(STAT_LogiLedCurveEvaluations);
+
+		if (!Curve.Packed)
+		{
+			const FRichCurve* Channels = Curve.Channels;
+			SetEffectValue(Effect, FLinearColor(Channels[0].Eval(Time), Channels[1].Eval(Time), Channels[2].Eval(Time)));
+
+			const float Remaining = GetConstantTimeRemaining(Channels, Time);
+			Effect.ConstantUntil = (Remaining == MAX_flt) ? MAX_flt : Time + Remaining;
+
+			continue;
+		}
+
+		const TArray<FSegment>& Segments = Curve.Segments;
+
+		// before the first key, after the last key, or single key
+		const FVector4* ConstantValue = nullptr;
+
+		if ((Segments.Num() == 0) || (Time >= Segments.Last().EndTime))
+		{
+			ConstantValue = &Curve.LastValue;
+			Effect.ConstantUntil = MAX_flt;
+		}
+		else if (Time < Segments[0].StartTime)
+		{
+			ConstantValue = &Curve.FirstValue;
+			Effect.ConstantUntil = Segments[0].StartTime;
+		}
+
+		if (ConstantValue != nullptr)
+		{
+			SetEffectValue(Effect, FLinearColor(ConstantValue->X, ConstantValue->Y, ConstantValue->Z));
+			continue;
+		}
+
+		// effects are sorted by time, so the segment only moves forward
+		if (SegmentIndex == INDEX_NONE)
+		{
+			SegmentIndex = 0;
+		}
+
+		while ((SegmentIndex < Segments.Num() - 1) && (Segments[SegmentIndex + 1].StartTime <= Time))
+		{
+			++SegmentIndex;
+		}
+
+		const FSegment& Segment = Segments[SegmentIndex];
+
+		// cubic Bezier for all channels at once (de Casteljau)
+		const VectorRegister Alpha = VectorSetFloat1((Time - Segment.StartTime) * Segment.InvDuration);
+		const VectorRegister P0 = VectorLoad(&Segment.P0.X);
+		const VectorRegister P1 = VectorLoad(&Segment.P1.X);
+		const VectorRegister P2 = VectorLoad(&Segment.P2.X);
+		const VectorRegister P3 = VectorLoad(&Segment.P3.X);
+
+		const VectorRegister P01 = VectorMultiplyAdd(VectorSubtract(P1, P0), Alpha, P0);
+		const VectorRegister P12 = VectorMultiplyAdd(VectorSubtract(P2, P1), Alpha, P1);
+		const VectorRegister P23 = VectorMultiplyAdd(VectorSubtract(P3, P2), Alpha, P2);
+		const VectorRegister P012 = VectorMultiplyAdd(VectorSubtract(P12, P01), Alpha, P01);
+		const VectorRegister P123 = VectorMultiplyAdd(VectorSubtract(P23, P12), Alpha, P12);
+		const VectorRegister Result = VectorMultiplyAdd(VectorSubtract(P123, P012), Alpha, P012);
+
+		// same as SetEffectValue
+		const VectorRegister Percentage = VectorMultiply(VectorMin(VectorMax(Result, VectorZero()), VectorOne()), VectorSetFloat1(100.0f));
+
+		MS_ALIGN(16) float Channels[4] GCC_ALIGN(16);
+		VectorStoreAligned(Percentage, Channels);
+
+		Effect.Exact = FLinearColor(Channels[0], Channels[1], Channels[2]);
+		Effect.Value = FColor((uint8)Channels[0], (uint8)Channels[1], (uint8)Channels[2]);
+		Effect.ConstantUntil = Segment.Constant ? Segment.EndTime : 0.0f;
+	}
+}
+
+
+void FLogiLedEffectPool::PackCurve(int32 CurveIndex)
+{
+	FCurve& Curve = Curves[CurveIndex];
+	const FRichCurve* Channels = Curve.Channels;
+	const int32 NumKeys = Channels[0].Keys.Num();
+
+	Curve.Packed = false;
+	Curve.Segments.Reset();
+
+	if (NumKeys == 0)
+	{
+		return;
+	}
+
+	// channels must be keyed at the same times, and must not repeat
+	for (int32 Channel = 0; Channel < 3; ++Channel)
+	{
+		const FRichCurve& ChannelCurve = Channels[Channel];
+
+		if ((ChannelCurve.Keys.Num() != NumKeys) ||
+			((ChannelCurve.PreInfinityExtrap != RCCE_Constant) && (ChannelCurve.PreInfinityExtrap != RCCE_None)) ||
+			((ChannelCurve.PostInfinityExtrap != RCCE_Constant) && (ChannelCurve.PostInfinityExtrap != RCCE_None)))
+		{
+			return;
+		}
+
+		for (int32 KeyIndex = 0; KeyIndex < NumKeys; ++KeyIndex)
+		{
+			if (ChannelCurve.Keys[KeyIndex].Time != Channels[0].Keys[KeyIndex].Time)
+			{
+				return;
+			}
+		}
+	}
+
+	Curve.FirstValue = FVector4(Channels[0].Keys[0].Value, Channels[1].Keys[0].Value, Channels[2].Keys[0].Value, 0.0f);
+	Curve.LastValue = FVector4(Channels[0].Keys.Last().Value, Channels[1].Keys.Last().Value, Channels[2].Keys.Last().Value, 0.0f);
+
+	for (int32 KeyIndex = 0; KeyIndex < NumKeys - 1; ++KeyIndex)
+	{
+		const int32 SegmentIndex = Curve.Segments.AddDefaulted();
+		FSegment& Segment = Curve.Segments[SegmentIndex];
+		{
+			Segment.StartTime = Channels[0].Keys[KeyIndex].Time;
+			Segment.EndTime = Channels[0].Keys[KeyIndex + 1].Time;
+			Segment.Constant = true;
+		}
+
+		const float Duration = Segment.EndTime - Segment.StartTime;
+		Segment.InvDuration = (Duration > 0.0f) ? 1.0f / Duration : 0.0f;
+
+		// control points that reproduce FRichCurve::Eval for each interpolation mode
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			const FRichCurveKey& Key = Channels[Channel].Keys[KeyIndex];
+			const FRichCurveKey& NextKey = Channels[Channel].Keys[KeyIndex + 1];
+
+			float P0 = Key.Value;
+			float P1 = Key.Value;
+			float P2 = Key.Value;
+			float P3 = Key.Value;
+
+			if ((Duration > 0.0f) && (Key.InterpMode == RCIM_Linear))
+			{
+				P1 = FMath::Lerp(Key.Value, NextKey.Value, 1.0f / 3.0f);
+				P2 = FMath::Lerp(Key.Value, NextKey.Value, 2.0f / 3.0f);
+				P3 = NextKey.Value;
+			}
+			else if ((Duration > 0.0f) && (Key.InterpMode != RCIM_Constant))
+			{
+				P1 = Key.Value + Key.LeaveTangent * Duration / 3.0f;
+				P2 = NextKey.Value - NextKey.ArriveTangent * Duration / 3.0f;
+				P3 = NextKey.Value;
+			}
+
+			Segment.P0[Channel] = P0;
+			Segment.P1[Channel] = P1;
+			Segment.P2[Channel] = P2;
+			Segment.P3[Channel] = P3;
+
+			Segment.Constant = Segment.Constant && (P1 == P0) && (P2 == P0) && (P3 == P0);
+		}
+
+		Segment.P0.W = Segment.P1.W = Segment.P2.W = Segment.P3.W = 0.0f;
+	}
+
+	Curve.Packed = true;
+}
+
+
+void FLogiLedEffectPool::Reject()
+{
+	++NumRejected;
+	INC_DWORD_STAT(STAT_LogiLedEffectsRejected);
+
+	const double Now = FPlatformTime::Seconds();
+
+	if (Now >= NextRejectLogTime)
+	{
+		UE_LOG(LogLogiLed, Warning, TEXT("Effect pool is full (%i of %i effects, %i curves), rejected %i effects"), NumActive, MaxEffects, MaxCurves, NumRejected);
+
+		NumRejected = 0;
+		NextRejectLogTime = Now + LogiLedRejectLogInterval;
+	}
+}
+
+
@@ -0,0 +1,330 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Curves/RichCurve.h"
+#include "Math/Color.h"
+#include "Math/Vector4.h"
+#include "UObject/WeakObjectPtr.h"
+
+#include "LogiLedTypes.h"
+
+class UCurveLinearColor;
+
+
+/**
+ * An effect instance that plays a color curve.
+ */
+struct FLogiLedEffect
+{
+	/** Index of the effect's curve in the pool. */
+	int32 CurveIndex;
+
+	/** Current curve time. */
+	float Time;
+
+	/** Curve time until which the curve output is known to be constant. */
+	float ConstantUntil;
+
+	/** The most recently evaluated percentage color. */
+	FColor Value;
+
+	/** The most recently evaluated percentage color before it was rounded down to integers. */
+	FLinearColor Exact;
+
+	/** The key the effect plays on, or INDEX_NONE for all keys of the target device(s). */
+	int32 KeyIndex;
+
+	/** The target device type(s) the effect was played on. */
+	int32 TargetDevice;
+
+	/** Whether the effect was started by a gameplay event (plays on top of other effects, and is removed without baking its last color once the curve has ended). */
+	bool Event;
+};
+
+
+/**
+ * A fixed-capacity pool of effect instances.
+ *
+ * Effects are addressed with generational handles, so stale handles are
+ * detected instead of reaching a reused slot. The pool owns copies of the
+ * color curves that its effects play, which are shared by all effects that
+ * play the same curve asset, so curve assets are never accessed while
+ * evaluating and may be garbage collected at any time.
+ *
+ * Curve copies are kept after their last effect stopped, so that starting an
+ * effect with a recently played curve neither copies nor packs it again. In
+ * the editor, cached copies are refreshed after any curve asset was edited.
+ *
+ * All storage is allocated up front. Starting and stopping effects does not
+ * allocate, unless a curve is copied for the first time or grows.
+ *
+ * Effects are evaluated in one batch per tick. Effects that play the same
+ * curve are evaluated together in time order, so that each curve segment is
+ * looked up once, and effects at the same time share one evaluation. Curves
+ * whose channels are keyed at the same times are converted into Bezier
+ * segments that interpolate all channels at once with vector instructions.
+ */
+class FLogiLedEffectPool
+{
+public:
+
+	/** Maximum number of simultaneously playing effects (enough for every key of several devices playing many layered effects). */
+	static const int32 MaxEffects = 1024;
+
+	/** Maximum number of different curves that can be played simultaneously. */
+	static const int32 MaxCurves = 64;
+
+public:
+
+	/** Default constructor. */
+	FLogiLedEffectPool();
+
+public:
+
+	/**
+	 * Start tracking edits to curve assets, so that cached curve copies are refreshed.
+	 *
+	 * Only has an effect in the editor, where curve assets can change.
+	 *
+	 * @see StopTrackingCurveChanges
+	 */
+	static void StartTrackingCurveChanges();
+
+	/**
+	 * Stop tracking edits to curve assets.
+	 *
+	 * @see StartTrackingCurveChanges
+	 */
+	static void StopTrackingCurveChanges();
+
+public:
+
+	/**
+	 * Start a new effect.
+	 *
+	 * @param Curve The color curve to play.
+	 * @param KeyIndex The key to play on, or INDEX_NONE for all keys.
+	 * @param TargetDevice The target device type(s) to play on.
+	 * @return Handle to the new effect, or an invalid handle if the pool is full (which is logged).
+	 */
+	FLogiLedEffectHandle Add(const UCurveLinearColor& Curve, int32 KeyIndex, int32 TargetDevice);
+
+	/**
+	 * Start a new effect with a curve copy that was acquired before.
+	 *
+	 * Use this to start many effects with the same curve, so that the curve is
+	 * looked up only once.
+	 *
+	 * @param CurveIndex Index of the curve copy (as returned by AcquireCurve).
+	 * @param KeyIndex The key to play on, or INDEX_NONE for all keys.
+	 * @param TargetDevice The target device type(s) to play on.
+	 * @return Handle to the new effect, or an invalid handle if the pool is full (which is logged).
+	 * @see AcquireCurve
+	 */
+	FLogiLedEffectHandle Add(int32 CurveIndex, int32 KeyIndex, int32 TargetDevice);
+
+	/**
+	 * Find or copy the given curve, and add a user to it.
+	 *
+	 * The user must be released with ReleaseCurve, even if no effects were
+	 * started with the curve.
+	 *
+	 * @param Curve The curve asset.
+	 * @return Index of the copy, or INDEX_NONE if all curve slots are in use (which is logged).
+	 * @see Add, ReleaseCurve
+	 */
+	int32 AcquireCurve(const UCurveLinearColor& Curve);
+
+	/**
+	 * Get the effect at the given position in the list of playing effects.
+	 *
+	 * @param Position The position (0 to Num() - 1).
+	 * @return The effect.
+	 */
+	FLogiLedEffect& GetEffect(int32 Position)
+	{
+		return Effects[ActiveSlots[Position]];
+	}
+
+	/**
+	 * Get the handle of the effect at the given position in the list of playing effects.
+	 *
+	 * @param Position The position (0 to Num() - 1).
+	 * @return The effect handle.
+	 */
+	FLogiLedEffectHandle GetHandle(int32 Position) const
+	{
+		const int32 Slot = ActiveSlots[Position];
+		return FLogiLedEffectHandle(Slot, Generations[Slot]);
+	}
+
+	/** Remove all effects. */
+	void Empty();
+
+	/**
+	 * Evaluate all effects whose output may have changed since the last evaluation.
+	 *
+	 * Updates the Value and ConstantUntil members of the effects.
+	 */
+	void Evaluate();
+
+	/**
+	 * Find a playing effect.
+	 *
+	 * @param Handle The effect's handle.
+	 * @return The effect, or nullptr if it is not playing anymore.
+	 */
+	FLogiLedEffect* Find(FLogiLedEffectHandle Handle);
+
+	/**
+	 * Get the number of playing effects.
+	 *
+	 * @return Number of effects.
+	 */
+	int32 Num() const
+	{
+		return NumActive;
+	}
+
+	/**
+	 * Release a user of a curve copy.
+	 *
+	 * @param CurveIndex Index of the copy.
+	 * @see AcquireCurve
+	 */
+	void ReleaseCurve(int32 CurveIndex);
+
+	/**
+	 * Remove a playing effect.
+	 *
+	 * @param Handle The effect's handle.
+	 * @return true if the effect was removed, false if it was not playing.
+	 */
+	bool Remove(FLogiLedEffectHandle Handle);
+
+protected:
+
+	/**
+	 * Start a new effect in a free slot.
+	 *
+	 * @param CurveIndex Index of the curve copy, whose user is taken over by the effect.
+	 * @param KeyIndex The key to play on, or INDEX_NONE for all keys.
+	 * @param TargetDevice The target device type(s) to play on.
+	 * @return Handle to the new effect.
+	 */
+	FLogiLedEffectHandle AddEffect(int32 CurveIndex, int32 KeyIndex, int32 TargetDevice);
+
+	/**
+	 * Evaluate effects that play the same curve.
+	 *
+	 * @param CurveIndex Index of the curve.
+	 * @param Slots Slots of the effects to evaluate, sorted by time.
+	 * @param NumSlots Number of effects to evaluate.
+	 */
+	void EvaluateCurve(int32 CurveIndex, const int32* Slots, int32 NumSlots);
+
+	/**
+	 * Convert a curve copy into Bezier segments, if its channels are keyed at the same times.
+	 *
+	 * @param CurveIndex Index of the curve.
+	 */
+	void PackCurve(int32 CurveIndex);
+
+	/** Count an effect that could not be started, and log a summary if the log interval has elapsed. */
+	void Reject();
+
+private:
+
+	/** A curve segment between two keys, with control points for all channels. */
+	struct FSegment
+	{
+		/** Bezier control points (red, green, blue, unused). */
+		FVector4 P0;
+		FVector4 P1;
+		FVector4 P2;
+		FVector4 P3;
+
+		/** Time of the segment's first key. */
+		float StartTime;
+
+		/** Time of the segment's last key. */
+		float EndTime;
+
+		/** One over the segment's duration (0 if empty). */
+		float InvDuration;
+
+		/** Whether all channels are constant over the segment. */
+		bool Constant;
+	};
+
+	/** A copy of a color curve asset. */
+	struct FCurve
+	{
+		/** The asset that was copied (for identification only, never accessed). */
+		const UCurveLinearColor* Source;
+
+		/** Weak reference to the asset that was copied, which detects a new asset at the same address. */
+		TWeakObjectPtr<const UCurveLinearColor> SourceObject;
+
+		/** The curve change count at the time the asset was copied. */
+		uint32 ChangeCount;
+
+		/** The release count at the time the last user released the copy (for evicting the oldest unused copy). */
+		uint32 ReleasedAt;
+
+		/** Copies of the red, green and blue curve channels. */
+		FRichCurve Channels[3];
+
+		/** Number of effects playing this curve. */
+		int32 NumUsers;
+
+		/** Whether the channels were converted into segments. */
+		bool Packed;
+
+		/** The curve's segments (only if packed). */
+		TArray<FSegment> Segments;
+
+		/** Values before the first and after the last key (only if packed). */
+		FVector4 FirstValue;
+		FVector4 LastValue;
+	};
+
+	/** Effect storage. */
+	FLogiLedEffect Effects[MaxEffects];
+
+	/** Generation of each effect slot, which changes whenever the slot is freed. */
+	int32 Generations[MaxEffects];
+
+	/** Indices of playing effects, in no particular order. */
+	int32 ActiveSlots[MaxEffects];
+
+	/** Position of each playing effect in ActiveSlots. */
+	int32 ActivePositions[MaxEffects];
+
+	/** Number of playing effects. */
+	int32 NumActive;
+
+	/** Indices of free effect slots. */
+	int32 FreeSlots[MaxEffects];
+
+	/** Number of free effect slots. */
+	int32 NumFree;
+
+	/** Curve storage. */
+	FCurve Curves[MaxCurves];
+
+	/** Number of times a curve copy lost its last user. */
+	uint32 NumReleases;
+
+	/** Number of effects that could not be started since the last summary. */
+	int32 NumRejected;
+
+	/** Time at which the next summary of rejected effects may be logged. */
+	double NextRejectLogTime;
+
+	/** Scratch space for sorting effects by curve and time. */
+	int32 SortedSlots[MaxEffects];
+	int32 CurveStarts[MaxCurves + 1];
+};
@@ -0,0 +1,647 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedEffectProgram.h"
+#include "LogiLedEffectGraph.h"
+#include "LogiLedFrame.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedSnapshot.h"
+
+#include "Classes/Curves/CurveLinearColor.h"
+#include "Math/UnrealMathUtility.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Effect Graph Execution"), STAT_LogiLedEffectGraphExecution, STATGROUP_LogiLed);
+
+
+/* Local helpers
+ *****************************************************************************/
+
+namespace LogiLedEffectProgram
+{
+	/** Key positions on the virtual keyboard, in keyboard widths. */
+	struct FKeyPositions
+	{
+		FVector2D Positions[LogiLedKeys::Count];
+
+		FKeyPositions()
+		{
+			const float Width = FLogiLedSnapshot::GetLayoutSize().X;
+
+			for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+			{
+				Positions[KeyIndex] = FLogiLedSnapshot::GetKeyBounds(KeyIndex).GetCenter() / Width;
+			}
+		}
+	};
+
+	/** Get the key positions. */
+	const FVector2D* GetKeyPositions()
+	{
+		static const FKeyPositions KeyPositions;
+		return KeyPositions.Positions;
+	}
+
+	/** Get the brightness of a color. */
+	FORCEINLINE float Brightness(const FLinearColor& Color)
+	{
+		return Color.ComputeLuminance();
+	}
+
+	/** Get a pseudo-random value in [0, 1] for a lattice point. */
+	FORCEINLINE float Hash(int32 X, int32 Y, int32 Z)
+	{
+		uint32 Hash = ((uint32)X * 73856093u) ^ ((uint32)Y * 19349663u) ^ ((uint32)Z * 83492791u);
+		Hash = (Hash ^ (Hash >> 13)) * 1274126177u;
+
+		return (float)((Hash ^ (Hash >> 16)) & 0xffff) / 65535.0f;
+	}
+
+	/** Get smooth value noise in [0, 1]. */
+	float Noise(float X, float Y, float Z)
+	{
+		const int32 X0 = FMath::FloorToInt(X);
+		const int32 Y0 = FMath::FloorToInt(Y);
+		const int32 Z0 = FMath::FloorToInt(Z);
+
+		const float FX = FMath::SmoothStep(0.0f, 1.0f, X - X0);
+		const float FY = FMath::SmoothStep(0.0f, 1.0f, Y - Y0);
+		const float FZ = FMath::SmoothStep(0.0f, 1.0f, Z - Z0);
+
+		const float Near = FMath::Lerp(
+			FMath::Lerp(Hash(X0, Y0, Z0), Hash(X0 + 1, Y0, Z0), FX),
+			FMath::Lerp(Hash(X0, Y0 + 1, Z0), Hash(X0 + 1, Y0 + 1, Z0), FX),
+			FY);
+
+		const float Far = FMath::Lerp(
+			FMath::Lerp(Hash(X0, Y0, Z0 + 1), Hash(X0 + 1, Y0, Z0 + 1), FX),
+			FMath::Lerp(Hash(X0, Y0 + 1, Z0 + 1), Hash(X0 + 1, Y0 + 1, Z0 + 1), FX),
+			FY);
+
+		return FMath::Lerp(Near, Far, FZ);
+	}
+
+	/**
+	 * Get the indices of the nodes that a node reads.
+	 *
+	 * @param Node The node.
+	 * @param OutInputs Will contain the input indices (INDEX_NONE if unused).
+	 */
+	void GetInputs(const FLogiLedEffectNode& Node, int32 OutInputs[3])
+	{
+		OutInputs[0] = OutInputs[1] = OutInputs[2] = INDEX_NONE;
+
+		switch (Node.Type)
+		{
+		case ELogiLedEffectNodeType::Blend:
+			OutInputs[0] = Node.InputA;
+			OutInputs[1] = Node.InputB;
+			OutInputs[2] = ((Node.BlendMode == ELogiLedEffectBlendMode::Lerp) || (Node.BlendMode == ELogiLedEffectBlendMode::Add)) ? Node.AlphaInput : INDEX_NONE;
+			break;
+
+		case ELogiLedEffectNodeType::Mask:
+			OutInputs[0] = Node.InputA;
+			OutInputs[1] = Node.InputB;
+			break;
+
+		case ELogiLedEffectNodeType::Remap:
+			OutInputs[0] = Node.InputA;
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+
+/* FLogiLedEffectProgram structors
+ *****************************************************************************/
+
+FLogiLedEffectProgram::FLogiLedEffectProgram()
+	: OutputRegister(INDEX_NONE)
+	, Animated(false)
+{ }
+
+
+/* FLogiLedEffectProgram interface
+ *****************************************************************************/
+
+bool FLogiLedEffectProgram::Compile(const ULogiLedEffectGraph& Graph, FString& OutError)
+{
+	Empty();
+
+	const TArray<FLogiLedEffectNode>& Nodes = Graph.Nodes;
+	const int32 NumNodes = Nodes.Num();
+
+	if ((NumNodes == 0) || (NumNodes > MaxNodes))
+	{
+		OutError = FString::Printf(TEXT("The graph must have between 1 and %i nodes"), MaxNodes);
+		return false;
+	}
+
+	// find the node that reads each node last, and skip nodes that do not contribute to the output
+	TArray<int32> LastUses;
+	TArray<bool> Live;
+	{
+		LastUses.Init(INDEX_NONE, NumNodes);
+		Live.Init(false, NumNodes);
+		Live.Last() = true;
+
+		for (int32 NodeIndex = NumNodes - 1; NodeIndex >= 0; --NodeIndex)
+		{
+			int32 Inputs[3];
+			LogiLedEffectProgram::GetInputs(Nodes[NodeIndex], Inputs);
+
+			for (int32 Input : Inputs)
+			{
+				if (Input == INDEX_NONE)
+				{
+					continue;
+				}
+
+				if ((Input < 0) || (Input >= NodeIndex))
+				{
+					OutError = FString::Printf(TEXT("Node %i: inputs must refer to earlier nodes"), NodeIndex);
+					return false;
+				}
+
+				if (Live[NodeIndex])
+				{
+					Live[Input] = true;
+					LastUses[Input] = FMath::Max(LastUses[Input], NodeIndex);
+				}
+			}
+		}
+	}
+
+	// compile live nodes and allocate their registers
+	TArray<int32> FreeRegisters;
+	int32 NumRegisters = 0;
+
+	NodeRegisters.Init(INDEX_NONE, NumNodes);
+
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		if (!Live[NodeIndex])
+		{
+			continue;
+		}
+
+		if (!CompileNode(Nodes[NodeIndex], NodeIndex, OutError))
+		{
+			Empty();
+			return false;
+		}
+
+		const int32 Dest = (FreeRegisters.Num() > 0) ? FreeRegisters.Pop(false) : NumRegisters++;
+
+		Instructions.Last().Dest = Dest;
+		NodeRegisters[NodeIndex] = Dest;
+
+		// registers of inputs that are not read anymore can be reused by the next node
+		int32 Inputs[3];
+		LogiLedEffectProgram::GetInputs(Nodes[NodeIndex], Inputs);
+
+		for (int32 InputIndex = 0; InputIndex < 3; ++InputIndex)
+		{
+			const int32 Input = Inputs[InputIndex];
+
+			if ((Input != INDEX_NONE) && (LastUses[Input] == NodeIndex) && (NodeRegisters[Input] != INDEX_NONE))
+			{
+				FreeRegisters.Push(NodeRegisters[Input]);
+				NodeRegisters[Input] = INDEX_NONE;
+			}
+		}
+	}
+
+	OutputRegister = NodeRegisters.Last();
+	Registers.SetNumZeroed(NumRegisters * LogiLedKeys::Count);
+	NodeRegisters.Empty();
+
+	return true;
+}
+
+
+void FLogiLedEffectProgram::Empty()
+{
+	Instructions.Reset();
+	Curves.Reset();
+	Tables.Reset();
+	ParameterNames.Reset();
+	ParameterValues.Reset();
+	Registers.Reset();
+	NodeRegisters.Reset();
+
+	OutputRegister = INDEX_NONE;
+	Animated = false;
+}
+
+
+void FLogiLedEffectProgram::Execute(float Time, FLogiLedFrame& OutFrame)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LogiLedEffectGraphExecution);
+
+	if (!IsValid())
+	{
+		return;
+	}
+
+	const FVector2D* Positions = LogiLedEffectProgram::GetKeyPositions();
+	const int32 N = LogiLedKeys::Count;
+
+	for (const FInstruction& Instruction : Instructions)
+	{
+		FLinearColor* Dest = &Registers[Instruction.Dest * N];
+		const FLinearColor* A = (Instruction.A != INDEX_NONE) ? &Registers[Instruction.A * N] : nullptr;
+		const FLinearColor* B = (Instruction.B != INDEX_NONE) ? &Registers[Instruction.B * N] : nullptr;
+		const FLinearColor* C = (Instruction.C != INDEX_NONE) ? &Registers[Instruction.C * N] : nullptr;
+
+		switch (Instruction.Op)
+		{
+		case EOpCode::Fill:
+			for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+			{
+				Dest[KeyIndex] = Instruction.Color;
+			}
+			break;
+
+		case EOpCode::Curve:
+			{
+				// curves are uniform, so they are evaluated once for all keys
+				const FCurve& Curve = Curves[Instruction.Operand];
+				float CurveTime = Time * Instruction.Speed;
+
+				if (Curve.Looping && (Curve.MaxTime > Curve.MinTime))
+				{
+					const float Range = Curve.MaxTime - Curve.MinTime;
+					CurveTime = FMath::Fmod(CurveTime - Curve.MinTime, Range);
+					CurveTime += (CurveTime < 0.0f) ? Curve.MaxTime : Curve.MinTime;
+				}
+
+				const FLinearColor Color(Curve.Channels[0].Eval(CurveTime), Curve.Channels[1].Eval(CurveTime), Curve.Channels[2].Eval(CurveTime));
+
+				for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+				{
+					Dest[KeyIndex] = Color;
+				}
+			}
+			break;
+
+		case EOpCode::LerpTable:
+			{
+				const float* Table = &Tables[Instruction.Operand];
+
+				for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+				{
+					Dest[KeyIndex] = FMath::Lerp(Instruction.Color, Instruction.EndColor, Table[KeyIndex]);
+				}
+			}
+			break;
+
+		case EOpCode::Noise:
+			{
+				const float Z = Time * Instruction.Speed;
+
+				for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+				{
+					const FVector2D Position = Positions[KeyIndex] * Instruction.Scale;
+					Dest[KeyIndex] = FMath::Lerp(Instruction.Color, Instruction.EndColor, LogiLedEffectProgram::Noise(Position.X, Position.Y, Z));
+				}
+			}
+			break;
+
+		case EOpCode::Parameter:
+			{
+				const FLinearColor Color = Instruction.Color * ParameterValues[Instruction.Operand];
+
+				for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+				{
+					Dest[KeyIndex] = Color;
+				}
+			}
+			break;
+
+		case EOpCode::Lerp:
+			if (C != nullptr)
+			{
+				for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+				{
+					Dest[KeyIndex] = FMath::Lerp(A[KeyIndex], B[KeyIndex], Instruction.Alpha * LogiLedEffectProgram::Brightness(C[KeyIndex]));
+				}
+			}
+			else
+			{
+				for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+				{
+					Dest[KeyIndex] = FMath::Lerp(A[KeyIndex], B[KeyIndex], Instruction.Alpha);
+				}
+			}
+			break;
+
+		case EOpCode::Add:
+			if (C != nullptr)
+			{
+				for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+				{
+					Dest[KeyIndex] = A[KeyIndex] + B[KeyIndex] * (Instruction.Alpha * LogiLedEffectProgram::Brightness(C[KeyIndex]));
+				}
+			}
+			else
+			{
+				for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+				{
+					Dest[KeyIndex] = A[KeyIndex] + B[KeyIndex] * Instruction.Alpha;
+				}
+			}
+			break;
+
+		case EOpCode::Multiply:
+			for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+			{
+				Dest[KeyIndex] = A[KeyIndex] * B[KeyIndex];
+			}
+			break;
+
+		case EOpCode::Max:
+			for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+			{
+				Dest[KeyIndex] = FLinearColor(FMath::Max(A[KeyIndex].R, B[KeyIndex].R), FMath::Max(A[KeyIndex].G, B[KeyIndex].G), FMath::Max(A[KeyIndex].B, B[KeyIndex].B));
+			}
+			break;
+
+		case EOpCode::MultiplyTable:
+			{
+				const float* Table = &Tables[Instruction.Operand];
+
+				if (B != nullptr)
+				{
+					for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+					{
+						Dest[KeyIndex] = A[KeyIndex] * (Table[KeyIndex] * LogiLedEffectProgram::Brightness(B[KeyIndex]));
+					}
+				}
+				else
+				{
+					for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+					{
+						Dest[KeyIndex] = A[KeyIndex] * Table[KeyIndex];
+					}
+				}
+			}
+			break;
+
+		case EOpCode::Remap:
+			// Alpha holds the input minimum, Scale one over the input range
+			for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+			{
+				const float Alpha = FMath::Clamp((LogiLedEffectProgram::Brightness(A[KeyIndex]) - Instruction.Alpha) * Instruction.Scale, 0.0f, 1.0f);
+				Dest[KeyIndex] = FMath::Lerp(Instruction.Color, Instruction.EndColor, Alpha);
+			}
+			break;
+		}
+	}
+
+	const FLinearColor* Output = &Registers[OutputRegister * N];
+
+	for (int32 KeyIndex = 0; KeyIndex < N; ++KeyIndex)
+	{
+		OutFrame.Colors[KeyIndex] = FLogiLedFrame::ToPercentage(Output[KeyIndex]);
+	}
+}
+
+
+bool FLogiLedEffectProgram::SetParameter(FName Name, float Value)
+{
+	const int32 ParameterIndex = ParameterNames.Find(Name);
+
+	if ((ParameterIndex == INDEX_NONE) || (ParameterValues[ParameterIndex] == Value))
+	{
+		return false;
+	}
+
+	ParameterValues[ParameterIndex] = Value;
+
+	return true;
+}
+
+
+/* FLogiLedEffectProgram implementation
+ *****************************************************************************/
+
+bool FLogiLedEffectProgram::CompileNode(const FLogiLedEffectNode& Node, int32 NodeIndex, FString& OutError)
+{
+	FInstruction Instruction;
+	{
+		Instruction.Op = EOpCode::Fill;
+		Instruction.Dest = INDEX_NONE;
+		Instruction.A = INDEX_NONE;
+		Instruction.B = INDEX_NONE;
+		Instruction.C = INDEX_NONE;
+		Instruction.Operand = INDEX_NONE;
+		Instruction.Color = Node.Color;
+		Instruction.EndColor = Node.EndColor;
+		Instruction.Alpha = Node.Alpha;
+		Instruction.Scale = Node.Scale;
+		Instruction.Speed = Node.Speed;
+	}
+
+	// input indices were validated by the caller, but required inputs may be missing
+	auto GetRegister = [this](int32 Input) -> int32
+	{
+		return (Input != INDEX_NONE) ? NodeRegisters[Input] : INDEX_NONE;
+	};
+
+	auto RequireInput = [NodeIndex, &OutError](int32 Input, const TCHAR* InputName) -> bool
+	{
+		if (Input == INDEX_NONE)
+		{
+			OutError = FString::Printf(TEXT("Node %i: %s is not connected"), NodeIndex, InputName);
+			return false;
+		}
+
+		return true;
+	};
+
+	switch (Node.Type)
+	{
+	case ELogiLedEffectNodeType::Constant:
+		Instruction.Op = EOpCode::Fill;
+		break;
+
+	case ELogiLedEffectNodeType::Curve:
+		{
+			if (Node.Curve == nullptr)
+			{
+				OutError = FString::Printf(TEXT("Node %i: no color curve"), NodeIndex);
+				return false;
+			}
+
+			FCurve& Curve = Curves[Curves.AddDefaulted()];
+			bool HasKeys = false;
+
+			Curve.MinTime = MAX_flt;
+			Curve.MaxTime = -MAX_flt;
+			Curve.Looping = Node.Looping;
+
+			for (int32 ChannelIndex = 0; ChannelIndex < 3; ++ChannelIndex)
+			{
+				Curve.Channels[ChannelIndex] = Node.Curve->FloatCurves[ChannelIndex];
+
+				if (Curve.Channels[ChannelIndex].GetNumKeys() > 0)
+				{
+					float MinTime, MaxTime;
+					Curve.Channels[ChannelIndex].GetTimeRange(MinTime, MaxTime);
+
+					Curve.MinTime = FMath::Min(Curve.MinTime, MinTime);
+					Curve.MaxTime = FMath::Max(Curve.MaxTime, MaxTime);
+					HasKeys = true;
+				}
+
+				Animated = Animated || ((Curve.Channels[ChannelIndex].GetNumKeys() > 1) && (Node.Speed != 0.0f));
+			}
+
+			if (!HasKeys)
+			{
+				Curve.MinTime = Curve.MaxTime = 0.0f;
+			}
+
+			Instruction.Op = EOpCode::Curve;
+			Instruction.Operand = Curves.Num() - 1;
+		}
+		break;
+
+	case ELogiLedEffectNodeType::Gradient:
+		{
+			if (Node.Direction.IsNearlyZero())
+			{
+				OutError = FString::Printf(TEXT("Node %i: the gradient has no direction"), NodeIndex);
+				return false;
+			}
+
+			// project the key positions onto the direction, and stretch the gradient across the keyboard
+			const FVector2D* Positions = LogiLedEffectProgram::GetKeyPositions();
+			const FVector2D Direction = Node.Direction.GetSafeNormal();
+			const int32 TableIndex = AddTable();
+
+			float MinDistance = MAX_flt;
+			float MaxDistance = -MAX_flt;
+
+			for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+			{
+				const float Distance = FVector2D::DotProduct(Positions[KeyIndex], Direction);
+
+				Tables[TableIndex + KeyIndex] = Distance;
+				MinDistance = FMath::Min(MinDistance, Distance);
+				MaxDistance = FMath::Max(MaxDistance, Distance);
+			}
+
+			const float InvRange = (MaxDistance > MinDistance) ? 1.0f / (MaxDistance - MinDistance) : 0.0f;
+
+			for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+			{
+				Tables[TableIndex + KeyIndex] = (Tables[TableIndex + KeyIndex] - MinDistance) * InvRange;
+			}
+
+			Instruction.Op = EOpCode::LerpTable;
+			Instruction.Operand = TableIndex;
+		}
+		break;
+
+	case ELogiLedEffectNodeType::Noise:
+		Instruction.Op = EOpCode::Noise;
+		Animated = Animated || (Node.Speed != 0.0f);
+		break;
+
+	case ELogiLedEffectNodeType::Parameter:
+		Instruction.Op = EOpCode::Parameter;
+		Instruction.Operand = ParameterNames.Find(Node.ParameterName);
+
+		if (Instruction.Operand == INDEX_NONE)
+		{
+			Instruction.Operand = ParameterNames.Add(Node.ParameterName);
+			ParameterValues.Add(0.0f);
+		}
+		break;
+
+	case ELogiLedEffectNodeType::Blend:
+		if (!RequireInput(Node.InputA, TEXT("Input A")) || !RequireInput(Node.InputB, TEXT("Input B")))
+		{
+			return false;
+		}
+
+		switch (Node.BlendMode)
+		{
+		case ELogiLedEffectBlendMode::Lerp: Instruction.Op = EOpCode::Lerp; break;
+		case ELogiLedEffectBlendMode::Add: Instruction.Op = EOpCode::Add; break;
+		case ELogiLedEffectBlendMode::Multiply: Instruction.Op = EOpCode::Multiply; break;
+		case ELogiLedEffectBlendMode::Max: Instruction.Op = EOpCode::Max; break;
+		}
+
+		Instruction.A = GetRegister(Node.InputA);
+		Instruction.B = GetRegister(Node.InputB);
+
+		if ((Instruction.Op == EOpCode::Lerp) || (Instruction.Op == EOpCode::Add))
+		{
+			Instruction.C = GetRegister(Node.AlphaInput);
+		}
+		break;
+
+	case ELogiLedEffectNodeType::Mask:
+		{
+			if (!RequireInput(Node.InputA, TEXT("Input A")))
+			{
+				return false;
+			}
+
+			const int32 TableIndex = AddTable();
+
+			for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+			{
+				Tables[TableIndex + KeyIndex] = (Node.Keys.Num() == 0) ? 1.0f : 0.0f;
+			}
+
+			for (ELogiLedKeys Key : Node.Keys)
+			{
+				Tables[TableIndex + (int32)Key] = 1.0f;
+			}
+
+			Instruction.Op = EOpCode::MultiplyTable;
+			Instruction.A = GetRegister(Node.InputA);
+			Instruction.B = GetRegister(Node.InputB);
+			Instruction.Operand = TableIndex;
+		}
+		break;
+
+	case ELogiLedEffectNodeType::Remap:
+		if (!RequireInput(Node.InputA, TEXT("Input A")))
+		{
+			return false;
+		}
+
+		if (Node.InMax == Node.InMin)
+		{
+			OutError = FString::Printf(TEXT("Node %i: the input range is empty"), NodeIndex);
+			return false;
+		}
+
+		Instruction.Op = EOpCode::Remap;
+		Instruction.A = GetRegister(Node.InputA);
+		Instruction.Alpha = Node.InMin;
+		Instruction.Scale = 1.0f / (Node.InMax - Node.InMin);
+		break;
+
+	default:
+		OutError = FString::Printf(TEXT("Node %i: unknown node type"), NodeIndex);
+		return false;
+	}
+
+	Instructions.Add(Instruction);
+
+	return true;
+}
+
+
+int32 FLogiLedEffectProgram::AddTable()
+{
+	return Tables.AddZeroed(LogiLedKeys::Count);
+}
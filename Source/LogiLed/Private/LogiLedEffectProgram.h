@@ -0,0 +1,216 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "CoreTypes.h"
+#include "Curves/RichCurve.h"
+#include "Math/Color.h"
+#include "UObject/NameTypes.h"
+
+#include "LogiLedKeys.h"
+
+class ULogiLedEffectGraph;
+struct FLogiLedEffectNode;
+struct FLogiLedFrame;
+
+
+/**
+ * An LED effect graph compiled into a flat program.
+ *
+ * Each graph node becomes one instruction that computes the colors of all
+ * keys into a register, so the program runs as a short sequence of tight
+ * loops without any per-key dispatch. Registers are reused once the nodes
+ * that read them have run. Inputs that only depend on the key layout, such
+ * as gradients and key masks, are computed into per-key tables at compile
+ * time, and color curves are copied, so that assets are never accessed while
+ * the program runs.
+ */
+class FLogiLedEffectProgram
+{
+public:
+
+	/** Maximum number of nodes in a graph. */
+	static const int32 MaxNodes = 256;
+
+public:
+
+	/** Default constructor (empty program). */
+	FLogiLedEffectProgram();
+
+public:
+
+	/**
+	 * Compile an effect graph.
+	 *
+	 * @param Graph The graph to compile.
+	 * @param OutError Will contain the reason if the graph could not be compiled.
+	 * @return true on success, false otherwise.
+	 */
+	bool Compile(const ULogiLedEffectGraph& Graph, FString& OutError);
+
+	/** Remove all instructions. */
+	void Empty();
+
+	/**
+	 * Run the program.
+	 *
+	 * @param Time The effect time (in seconds).
+	 * @param OutFrame Will contain the percentage colors of all keys.
+	 */
+	void Execute(float Time, FLogiLedFrame& OutFrame);
+
+	/**
+	 * Check whether the program's output changes over time.
+	 *
+	 * @return true if any source is animated, false otherwise.
+	 */
+	bool IsAnimated() const
+	{
+		return Animated;
+	}
+
+	/**
+	 * Check whether the program contains instructions.
+	 *
+	 * @return true if compiled, false otherwise.
+	 */
+	bool IsValid() const
+	{
+		return (Instructions.Num() > 0);
+	}
+
+	/**
+	 * Set the value of a gameplay parameter.
+	 *
+	 * @param Name The parameter's name.
+	 * @param Value The value to set.
+	 * @return true if the program uses the parameter and its value changed, false otherwise.
+	 */
+	bool SetParameter(FName Name, float Value);
+
+protected:
+
+	/**
+	 * Compile a node into an instruction.
+	 *
+	 * The instruction's result register is assigned by the caller.
+	 *
+	 * @param Node The node to compile.
+	 * @param NodeIndex The node's index in the graph.
+	 * @param OutError Will contain the reason if the node could not be compiled.
+	 * @return true on success, false otherwise.
+	 */
+	bool CompileNode(const FLogiLedEffectNode& Node, int32 NodeIndex, FString& OutError);
+
+	/**
+	 * Add a per-key table.
+	 *
+	 * @return Index of the table's first entry.
+	 */
+	int32 AddTable();
+
+private:
+
+	/** Instruction codes. */
+	enum class EOpCode : uint8
+	{
+		/** Dest = Color. */
+		Fill,
+
+		/** Dest = Curve(Time * Speed). */
+		Curve,
+
+		/** Dest = Lerp(Color, EndColor, Table). */
+		LerpTable,
+
+		/** Dest = Lerp(Color, EndColor, Noise(Position * Scale, Time * Speed)). */
+		Noise,
+
+		/** Dest = Color * Parameter. */
+		Parameter,
+
+		/** Dest = Lerp(A, B, Alpha [* Brightness(C)]). */
+		Lerp,
+
+		/** Dest = A + B * Alpha [* Brightness(C)]. */
+		Add,
+
+		/** Dest = A * B. */
+		Multiply,
+
+		/** Dest = Max(A, B). */
+		Max,
+
+		/** Dest = A * Table [* Brightness(B)]. */
+		MultiplyTable,
+
+		/** Dest = Lerp(Color, EndColor, Saturate((Brightness(A) - InMin) * InvRange)). */
+		Remap
+	};
+
+	/** A compiled node. */
+	struct FInstruction
+	{
+		/** The operation. */
+		EOpCode Op;
+
+		/** Registers of the result and the operands (INDEX_NONE if unused). */
+		int32 Dest;
+		int32 A;
+		int32 B;
+		int32 C;
+
+		/** Index of the curve, table or parameter (if used). */
+		int32 Operand;
+
+		/** Colors (if used). */
+		FLinearColor Color;
+		FLinearColor EndColor;
+
+		/** Scalar arguments (if used). */
+		float Alpha;
+		float Scale;
+		float Speed;
+	};
+
+	/** A copy of a color curve. */
+	struct FCurve
+	{
+		/** Red, green and blue channels. */
+		FRichCurve Channels[3];
+
+		/** Time range of the keys. */
+		float MinTime;
+		float MaxTime;
+
+		/** Whether to loop the keyed range. */
+		bool Looping;
+	};
+
+	/** The program's instructions. */
+	TArray<FInstruction> Instructions;
+
+	/** Copies of the played color curves. */
+	TArray<FCurve> Curves;
+
+	/** Per-key tables, LogiLedKeys::Count entries each. */
+	TArray<float> Tables;
+
+	/** Names and current values of the gameplay parameters. */
+	TArray<FName> ParameterNames;
+	TArray<float> ParameterValues;
+
+	/** Register storage, LogiLedKeys::Count colors per register. */
+	TArray<FLinearColor> Registers;
+
+	/** Register holding the result of each node during compilation. */
+	TArray<int32> NodeRegisters;
+
+	/** Register holding the program's result. */
+	int32 OutputRegister;
+
+	/** Whether any source is animated. */
+	bool Animated;
+};
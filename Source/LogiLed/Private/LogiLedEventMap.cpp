@@ -0,0 +1,224 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedEventMap.h"
+#include "LogiLedKeys.h"
+#include "LogiLedManager.h"
+#include "LogiLedPrivate.h"
+
+#include "Curves/CurveLinearColor.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Events Fired"), STAT_LogiLedEventsFired, STATGROUP_LogiLed);
+
+
+/** Maximum number of periods that are baked for flashes and pulses. */
+static const int32 LogiLedEventMaxPeriods = 256;
+
+
+/* FLogiLedEventBinding structors
+ *****************************************************************************/
+
+FLogiLedEventBinding::FLogiLedEventBinding()
+	: Effect(ELogiLedEventEffect::Flash)
+	, Color(FLinearColor::White)
+	, EndColor(FLinearColor::Black)
+	, Curve(nullptr)
+	, Duration(1.0f)
+	, Interval(0.25f)
+	, Priority(ELogiLedPriority::Gameplay)
+{ }
+
+
+/* ULogiLedEventMap interface
+ *****************************************************************************/
+
+void ULogiLedEventMap::Compile()
+{
+	Slots.Reset();
+	Actions.Reset();
+	KeyTable.Reset();
+	BakedCurves.Reset();
+
+	// group the bindings by tag, so that each event's actions are contiguous
+	TArray<int32> Order;
+	Order.Reserve(Bindings.Num());
+
+	for (int32 BindingIndex = 0; BindingIndex < Bindings.Num(); ++BindingIndex)
+	{
+		const FLogiLedEventBinding& Binding = Bindings[BindingIndex];
+
+		if (Binding.Tag.IsValid() && ((Binding.Effect != ELogiLedEventEffect::Curve) || (Binding.Curve != nullptr)))
+		{
+			Order.Add(BindingIndex);
+		}
+	}
+
+	Order.StableSort([this](int32 A, int32 B) {
+		const FName NameA = Bindings[A].Tag.GetTagName();
+		const FName NameB = Bindings[B].Tag.GetTagName();
+
+		return (NameA.GetComparisonIndex() != NameB.GetComparisonIndex()) ? (NameA.GetComparisonIndex() < NameB.GetComparisonIndex()) : (NameA.GetNumber() < NameB.GetNumber());
+	});
+
+	// at most half full, so that probe sequences stay short
+	Slots.SetNum(FMath::RoundUpToPowerOfTwo(FMath::Max(Order.Num() * 2, 8)));
+
+	const uint32 Mask = Slots.Num() - 1;
+	FSlot* Slot = nullptr;
+
+	for (int32 BindingIndex : Order)
+	{
+		const FLogiLedEventBinding& Binding = Bindings[BindingIndex];
+
+		if ((Slot == nullptr) || (Slot->Tag != Binding.Tag))
+		{
+			uint32 SlotIndex = GetTypeHash(Binding.Tag) & Mask;
+
+			while (Slots[SlotIndex].Tag.IsValid())
+			{
+				SlotIndex = (SlotIndex + 1) & Mask;
+			}
+
+			Slot = &Slots[SlotIndex];
+			Slot->Tag = Binding.Tag;
+			Slot->FirstAction = Actions.Num();
+			Slot->NumActions = 0;
+		}
+
+		FAction& Action = Actions[Actions.AddUninitialized()];
+		{
+			Action.Curve = (Binding.Effect == ELogiLedEventEffect::Curve) ? Binding.Curve : BakeCurve(Binding);
+			Action.FirstKey = KeyTable.Num();
+			Action.NumKeys = Binding.Keys.Num();
+			Action.Priority = Binding.Priority;
+		}
+
+		for (ELogiLedKeys Key : Binding.Keys)
+		{
+			KeyTable.Add((uint8)Key);
+		}
+
+		++Slot->NumActions;
+	}
+
+	Compiled = true;
+}
+
+
+int32 ULogiLedEventMap::FindEvent(FGameplayTag Tag) const
+{
+	if (Slots.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const uint32 Mask = Slots.Num() - 1;
+	uint32 SlotIndex = GetTypeHash(Tag) & Mask;
+
+	while (Slots[SlotIndex].Tag.IsValid())
+	{
+		if (Slots[SlotIndex].Tag == Tag)
+		{
+			return SlotIndex;
+		}
+
+		SlotIndex = (SlotIndex + 1) & Mask;
+	}
+
+	return INDEX_NONE;
+}
+
+
+bool ULogiLedEventMap::FireEvent(FGameplayTag Tag)
+{
+	if (!Compiled)
+	{
+		Compile();
+	}
+
+	const int32 EventIndex = FindEvent(Tag);
+
+	if (EventIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_LogiLedEventsFired);
+	FLogiLedManager::Get().QueueEvent(*this, EventIndex);
+
+	return true;
+}
+
+
+TArrayView<const ULogiLedEventMap::FAction> ULogiLedEventMap::GetActions(int32 EventIndex) const
+{
+	if (!Slots.IsValidIndex(EventIndex))
+	{
+		return TArrayView<const FAction>();
+	}
+
+	const FSlot& Slot = Slots[EventIndex];
+
+	return TArrayView<const FAction>(Actions.GetData() + Slot.FirstAction, Slot.NumActions);
+}
+
+
+/* UObject interface
+ *****************************************************************************/
+
+void ULogiLedEventMap::PostLoad()
+{
+	Super::PostLoad();
+	Compile();
+}
+
+
+#if WITH_EDITOR
+
+void ULogiLedEventMap::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	Compile();
+}
+
+#endif
+
+
+/* ULogiLedEventMap implementation
+ *****************************************************************************/
+
+UCurveLinearColor* ULogiLedEventMap::BakeCurve(const FLogiLedEventBinding& Binding)
+{
+	UCurveLinearColor* Curve = NewObject<UCurveLinearColor>(this, NAME_None, RF_Transient);
+	BakedCurves.Add(Curve);
+
+	const float Interval = FMath::Max(Binding.Interval, 0.05f);
+	const bool Looping = (Binding.Duration <= 0.0f);
+	const int32 NumPeriods = Looping ? 1 : FMath::Clamp(FMath::RoundToInt(Binding.Duration / Interval), 1, LogiLedEventMaxPeriods);
+
+	const FLinearColor& HalfColor = (Binding.Effect == ELogiLedEventEffect::Flash) ? FLinearColor::Black : Binding.EndColor;
+	const ERichCurveInterpMode InterpMode = (Binding.Effect == ELogiLedEventEffect::Flash) ? RCIM_Constant : RCIM_Linear;
+
+	for (int32 Channel = 0; Channel < 4; ++Channel)
+	{
+		FRichCurve& ChannelCurve = Curve->FloatCurves[Channel];
+
+		for (int32 Period = 0; Period < NumPeriods; ++Period)
+		{
+			const float StartTime = Period * Interval;
+
+			ChannelCurve.SetKeyInterpMode(ChannelCurve.AddKey(StartTime, Binding.Color.Component(Channel)), InterpMode);
+			ChannelCurve.SetKeyInterpMode(ChannelCurve.AddKey(StartTime + 0.5f * Interval, HalfColor.Component(Channel)), InterpMode);
+		}
+
+		// flashes end dark, pulses where they started
+		ChannelCurve.AddKey(NumPeriods * Interval, (Binding.Effect == ELogiLedEventEffect::Flash) ? HalfColor.Component(Channel) : Binding.Color.Component(Channel));
+
+		if (Looping)
+		{
+			ChannelCurve.PostInfinityExtrap = RCCE_Cycle;
+		}
+	}
+
+	return Curve;
+}
@@ -0,0 +1,123 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/UnrealMemory.h"
+#include "Math/Color.h"
+
+#include "LogiLedKeys.h"
+
+
+/**
+ * A frame of per-key lighting.
+ *
+ * Colors are stored as SDK percentages (0-100 per channel), which is the
+ * precision at which the SDK accepts them, so that comparing two frames tells
+ * whether anything needs to be sent.
+ */
+struct FLogiLedFrame
+{
+	/** Per-key colors, indexed by ELogiLedKeys. */
+	FColor Colors[LogiLedKeys::Count];
+
+public:
+
+	/** Default constructor (all keys off). */
+	FLogiLedFrame()
+	{
+		Fill(FColor::Black);
+	}
+
+public:
+
+	/**
+	 * Set all keys to the same color.
+	 *
+	 * @param Color The percentage color to set.
+	 */
+	void Fill(FColor Color)
+	{
+		for (FColor& KeyColor : Colors)
+		{
+			KeyColor = Color;
+		}
+	}
+
+	/**
+	 * Get the average color of all keys.
+	 *
+	 * @return Average percentage color.
+	 */
+	FColor GetAverage() const
+	{
+		uint32 R = 0, G = 0, B = 0;
+
+		for (const FColor& KeyColor : Colors)
+		{
+			R += KeyColor.R;
+			G += KeyColor.G;
+			B += KeyColor.B;
+		}
+
+		return FColor(R / LogiLedKeys::Count, G / LogiLedKeys::Count, B / LogiLedKeys::Count);
+	}
+
+	/**
+	 * Check whether all keys have the same color.
+	 *
+	 * @param OutColor Will contain the color of the keys if they are uniform.
+	 * @return true if all keys have the same color, false otherwise.
+	 */
+	bool IsUniform(FColor& OutColor) const
+	{
+		OutColor = Colors[0];
+
+		for (const FColor& KeyColor : Colors)
+		{
+			if (KeyColor != OutColor)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+public:
+
+	/**
+	 * Convert a color with byte channels to an SDK percentage color.
+	 *
+	 * @param Color The color to convert.
+	 * @return The percentage color.
+	 */
+	static FColor BytesToPercentage(FColor Color)
+	{
+		return FColor((uint8)((Color.R * 100 + 127) / 255), (uint8)((Color.G * 100 + 127) / 255), (uint8)((Color.B * 100 + 127) / 255));
+	}
+
+	/**
+	 * Convert a linear color to an SDK percentage color.
+	 *
+	 * @param Color The color to convert.
+	 * @return The percentage color.
+	 */
+	static FColor ToPercentage(const FLinearColor& Color)
+	{
+		const FLinearColor Percentage = Color.GetClamped() * 100.0f;
+		return FColor((uint8)Percentage.R, (uint8)Percentage.G, (uint8)Percentage.B);
+	}
+
+public:
+
+	bool operator==(const FLogiLedFrame& Other) const
+	{
+		return (FMemory::Memcmp(Colors, Other.Colors, sizeof(Colors)) == 0);
+	}
+
+	bool operator!=(const FLogiLedFrame& Other) const
+	{
+		return !(*this == Other);
+	}
+};
@@ -0,0 +1,556 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "Templates/UnrealTemplate.h"
+
+#include "LogiLedTypes.h"
+#include "LogitechLEDLib.h"
+
+
+/**
+ * Compile-time translation tables between ELogiLedKeys, Logitech SDK key names and bitmap cells.
+ *
+ * All translations are single array loads. The tables are indexed by ELogiLedKeys
+ * (or by scan code for the reverse lookup) and validated against the enumeration
+ * at compile time.
+ */
+namespace LogiLedKeys
+{
+	/** Number of keys in ELogiLedKeys. */
+	constexpr int32 Count = (int32)ELogiLedKeys::GBadge + 1;
+
+	/** Number of cells in a lighting bitmap. */
+	constexpr int32 NumBitmapCells = LOGI_LED_BITMAP_WIDTH * LOGI_LED_BITMAP_HEIGHT;
+
+	/** Marker for unused entries in the reverse lookup table. */
+	constexpr uint8 InvalidKey = 0xff;
+
+	/** SDK key name for each ELogiLedKeys value. */
+	constexpr LogiLed::KeyName KeyNames[] =
+	{
+		LogiLed::ESC,
+		LogiLed::F1,
+		LogiLed::F2,
+		LogiLed::F3,
+		LogiLed::F4,
+		LogiLed::F5,
+		LogiLed::F6,
+		LogiLed::F7,
+		LogiLed::F8,
+		LogiLed::F9,
+		LogiLed::F10,
+		LogiLed::F11,
+		LogiLed::F12,
+		LogiLed::PRINT_SCREEN,
+		LogiLed::SCROLL_LOCK,
+		LogiLed::PAUSE_BREAK,
+		LogiLed::TILDE,
+		LogiLed::ONE,
+		LogiLed::TWO,
+		LogiLed::THREE,
+		LogiLed::FOUR,
+		LogiLed::FIVE,
+		LogiLed::SIX,
+		LogiLed::SEVEN,
+		LogiLed::EIGHT,
+		LogiLed::NINE,
+		LogiLed::ZERO,
+		LogiLed::MINUS,
+		LogiLed::EQUALS,
+		LogiLed::BACKSPACE,
+		LogiLed::INSERT,
+		LogiLed::HOME,
+		LogiLed::PAGE_UP,
+		LogiLed::NUM_LOCK,
+		LogiLed::NUM_SLASH,
+		LogiLed::NUM_ASTERISK,
+		LogiLed::NUM_MINUS,
+		LogiLed::TAB,
+		LogiLed::Q,
+		LogiLed::W,
+		LogiLed::E,
+		LogiLed::R,
+		LogiLed::T,
+		LogiLed::Y,
+		LogiLed::U,
+		LogiLed::I,
+		LogiLed::O,
+		LogiLed::P,
+		LogiLed::OPEN_BRACKET,
+		LogiLed::CLOSE_BRACKET,
+		LogiLed::BACKSLASH,
+		LogiLed::KEYBOARD_DELETE,
+		LogiLed::END,
+		LogiLed::PAGE_DOWN,
+		LogiLed::NUM_SEVEN,
+		LogiLed::NUM_EIGHT,
+		LogiLed::NUM_NINE,
+		LogiLed::NUM_PLUS,
+		LogiLed::CAPS_LOCK,
+		LogiLed::A,
+		LogiLed::S,
+		LogiLed::D,
+		LogiLed::F,
+		LogiLed::G,
+		LogiLed::H,
+		LogiLed::J,
+		LogiLed::K,
+		LogiLed::L,
+		LogiLed::SEMICOLON,
+		LogiLed::APOSTROPHE,
+		LogiLed::ENTER,
+		LogiLed::NUM_FOUR,
+		LogiLed::NUM_FIVE,
+		LogiLed::NUM_SIX,
+		LogiLed::LEFT_SHIFT,
+		LogiLed::Z,
+		LogiLed::X,
+		LogiLed::C,
+		LogiLed::V,
+		LogiLed::B,
+		LogiLed::N,
+		LogiLed::M,
+		LogiLed::COMMA,
+		LogiLed::PERIOD,
+		LogiLed::FORWARD_SLASH,
+		LogiLed::RIGHT_SHIFT,
+		LogiLed::ARROW_UP,
+		LogiLed::NUM_ONE,
+		LogiLed::NUM_TWO,
+		LogiLed::NUM_THREE,
+		LogiLed::NUM_ENTER,
+		LogiLed::LEFT_CONTROL,
+		LogiLed::LEFT_WINDOWS,
+		LogiLed::LEFT_ALT,
+		LogiLed::SPACE,
+		LogiLed::RIGHT_ALT,
+		LogiLed::RIGHT_WINDOWS,
+		LogiLed::APPLICATION_SELECT,
+		LogiLed::RIGHT_CONTROL,
+		LogiLed::ARROW_LEFT,
+		LogiLed::ARROW_DOWN,
+		LogiLed::ARROW_RIGHT,
+		LogiLed::NUM_ZERO,
+		LogiLed::NUM_PERIOD,
+		LogiLed::G_1,
+		LogiLed::G_2,
+		LogiLed::G_3,
+		LogiLed::G_4,
+		LogiLed::G_5,
+		LogiLed::G_6,
+		LogiLed::G_7,
+		LogiLed::G_8,
+		LogiLed::G_9,
+		LogiLed::G_LOGO,
+		LogiLed::G_BADGE,
+	};
+
+	/** Bitmap cell for each ELogiLedKeys value (INDEX_NONE if the key is not part of the bitmap). */
+	constexpr int8 BitmapCells[] =
+	{
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
+		37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52,
+		53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68,
+		69, 70, 71, 72, 73, 74, 76, 80, 81, 82, 84, 86, 87, 88, 89, 90,
+		91, 92, 93, 94, 95, 97, 99, 101, 102, 103, 104, 105, 106, 107, 110, 114,
+		115, 116, 117, 119, 120, 121, 122, 124, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1,
+	};
+
+	/** ELogiLedKeys value for each scan code based SDK key name (InvalidKey if unused). */
+	constexpr uint8 ScanCodeKeys[] =
+	{
+		0xFF, 0x00, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x25,
+		0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x46, 0x5B, 0x3B, 0x3C,
+		0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x10, 0x4A, 0x32, 0x4B, 0x4C, 0x4D, 0x4E,
+		0x4F, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x23, 0x5D, 0x5E, 0x3A, 0x01, 0x02, 0x03, 0x04, 0x05,
+		0x06, 0x07, 0x08, 0x09, 0x0A, 0x21, 0x0E, 0x36, 0x37, 0x38, 0x24, 0x47, 0x48, 0x49, 0x39, 0x57,
+		0x58, 0x59, 0x66, 0x67, 0xFF, 0xFF, 0xFF, 0x0B, 0x0C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x5A, 0x62, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x22, 0xFF, 0x0D, 0x5F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0xFF, 0x1F, 0x56, 0x20, 0xFF, 0x63, 0xFF, 0x65, 0xFF, 0x34,
+		0x64, 0x35, 0x1E, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x5C, 0x60, 0x61, 0xFF, 0xFF,
+	};
+
+	/** Display name for each ELogiLedKeys value. */
+	constexpr const TCHAR* Strings[] =
+	{
+		TEXT("Escape"),
+		TEXT("F1"),
+		TEXT("F2"),
+		TEXT("F3"),
+		TEXT("F4"),
+		TEXT("F5"),
+		TEXT("F6"),
+		TEXT("F7"),
+		TEXT("F8"),
+		TEXT("F9"),
+		TEXT("F10"),
+		TEXT("F11"),
+		TEXT("F12"),
+		TEXT("PrintScreen"),
+		TEXT("ScrollLock"),
+		TEXT("PauseBreak"),
+		TEXT("Tilde"),
+		TEXT("One"),
+		TEXT("Two"),
+		TEXT("Three"),
+		TEXT("Four"),
+		TEXT("Five"),
+		TEXT("Six"),
+		TEXT("Seven"),
+		TEXT("Eight"),
+		TEXT("Nine"),
+		TEXT("Zero"),
+		TEXT("Minus"),
+		TEXT("Equals"),
+		TEXT("Backspace"),
+		TEXT("Insert"),
+		TEXT("Home"),
+		TEXT("PageUp"),
+		TEXT("NumLock"),
+		TEXT("NumSlash"),
+		TEXT("NumAsterisk"),
+		TEXT("NumMinus"),
+		TEXT("Tab"),
+		TEXT("Q"),
+		TEXT("W"),
+		TEXT("E"),
+		TEXT("R"),
+		TEXT("T"),
+		TEXT("Y"),
+		TEXT("U"),
+		TEXT("I"),
+		TEXT("O"),
+		TEXT("P"),
+		TEXT("OpenBracket"),
+		TEXT("CloseBracket"),
+		TEXT("Backslash"),
+		TEXT("KeyboardDelete"),
+		TEXT("End"),
+		TEXT("PageDown"),
+		TEXT("NumSeven"),
+		TEXT("NumEight"),
+		TEXT("NumNine"),
+		TEXT("NumPlus"),
+		TEXT("CapsLock"),
+		TEXT("A"),
+		TEXT("S"),
+		TEXT("D"),
+		TEXT("F"),
+		TEXT("G"),
+		TEXT("H"),
+		TEXT("J"),
+		TEXT("K"),
+		TEXT("L"),
+		TEXT("Semicolon"),
+		TEXT("Apostrophe"),
+		TEXT("Enter"),
+		TEXT("NumFour"),
+		TEXT("NumFive"),
+		TEXT("NumSix"),
+		TEXT("LeftShift"),
+		TEXT("Z"),
+		TEXT("X"),
+		TEXT("C"),
+		TEXT("V"),
+		TEXT("B"),
+		TEXT("N"),
+		TEXT("M"),
+		TEXT("Comma"),
+		TEXT("Period"),
+		TEXT("ForwardSlash"),
+		TEXT("RightShift"),
+		TEXT("ArrowUp"),
+		TEXT("NumOne"),
+		TEXT("NumTwo"),
+		TEXT("NumThree"),
+		TEXT("NumEnter"),
+		TEXT("LeftControl"),
+		TEXT("LeftWindows"),
+		TEXT("LeftAlt"),
+		TEXT("Space"),
+		TEXT("RightAlt"),
+		TEXT("RightWindows"),
+		TEXT("ApplicationSelect"),
+		TEXT("RightControl"),
+		TEXT("ArrowLeft"),
+		TEXT("ArrowDown"),
+		TEXT("ArrowRight"),
+		TEXT("NumZero"),
+		TEXT("NumPeriod"),
+		TEXT("G1"),
+		TEXT("G2"),
+		TEXT("G3"),
+		TEXT("G4"),
+		TEXT("G5"),
+		TEXT("G6"),
+		TEXT("G7"),
+		TEXT("G8"),
+		TEXT("G9"),
+		TEXT("GLogo"),
+		TEXT("GBadge"),
+	};
+
+	/** OpenRGB LED name for each ELogiLedKeys value (nullptr if OpenRGB has no name for the key). */
+	constexpr const ANSICHAR* OpenRgbNames[] =
+	{
+		"Key: Escape",
+		"Key: F1",
+		"Key: F2",
+		"Key: F3",
+		"Key: F4",
+		"Key: F5",
+		"Key: F6",
+		"Key: F7",
+		"Key: F8",
+		"Key: F9",
+		"Key: F10",
+		"Key: F11",
+		"Key: F12",
+		"Key: Print Screen",
+		"Key: Scroll Lock",
+		"Key: Pause/Break",
+		"Key: `",
+		"Key: 1",
+		"Key: 2",
+		"Key: 3",
+		"Key: 4",
+		"Key: 5",
+		"Key: 6",
+		"Key: 7",
+		"Key: 8",
+		"Key: 9",
+		"Key: 0",
+		"Key: -",
+		"Key: =",
+		"Key: Backspace",
+		"Key: Insert",
+		"Key: Home",
+		"Key: Page Up",
+		"Key: Num Lock",
+		"Key: Number Pad /",
+		"Key: Number Pad *",
+		"Key: Number Pad -",
+		"Key: Tab",
+		"Key: Q",
+		"Key: W",
+		"Key: E",
+		"Key: R",
+		"Key: T",
+		"Key: Y",
+		"Key: U",
+		"Key: I",
+		"Key: O",
+		"Key: P",
+		"Key: [",
+		"Key: ]",
+		"Key: \\ (ANSI)",
+		"Key: Delete",
+		"Key: End",
+		"Key: Page Down",
+		"Key: Number Pad 7",
+		"Key: Number Pad 8",
+		"Key: Number Pad 9",
+		"Key: Number Pad +",
+		"Key: Caps Lock",
+		"Key: A",
+		"Key: S",
+		"Key: D",
+		"Key: F",
+		"Key: G",
+		"Key: H",
+		"Key: J",
+		"Key: K",
+		"Key: L",
+		"Key: ;",
+		"Key: '",
+		"Key: Enter",
+		"Key: Number Pad 4",
+		"Key: Number Pad 5",
+		"Key: Number Pad 6",
+		"Key: Left Shift",
+		"Key: Z",
+		"Key: X",
+		"Key: C",
+		"Key: V",
+		"Key: B",
+		"Key: N",
+		"Key: M",
+		"Key: ,",
+		"Key: .",
+		"Key: /",
+		"Key: Right Shift",
+		"Key: Up Arrow",
+		"Key: Number Pad 1",
+		"Key: Number Pad 2",
+		"Key: Number Pad 3",
+		"Key: Number Pad Enter",
+		"Key: Left Control",
+		"Key: Left Windows",
+		"Key: Left Alt",
+		"Key: Space",
+		"Key: Right Alt",
+		"Key: Right Windows",
+		"Key: Menu",
+		"Key: Right Control",
+		"Key: Left Arrow",
+		"Key: Down Arrow",
+		"Key: Right Arrow",
+		"Key: Number Pad 0",
+		"Key: Number Pad .",
+		"Key: G1",
+		"Key: G2",
+		"Key: G3",
+		"Key: G4",
+		"Key: G5",
+		"Key: G6",
+		"Key: G7",
+		"Key: G8",
+		"Key: G9",
+		"Logo",
+		nullptr,
+	};
+
+	static_assert(ARRAY_COUNT(KeyNames) == Count, "KeyNames must have one entry per ELogiLedKeys value");
+	static_assert(ARRAY_COUNT(BitmapCells) == Count, "BitmapCells must have one entry per ELogiLedKeys value");
+	static_assert(ARRAY_COUNT(Strings) == Count, "Strings must have one entry per ELogiLedKeys value");
+	static_assert(ARRAY_COUNT(OpenRgbNames) == Count, "OpenRgbNames must have one entry per ELogiLedKeys value");
+	static_assert(Count < InvalidKey, "ELogiLedKeys values must fit into the reverse lookup table");
+
+	/** Scan code based key names are below this value, G-keys and logos are above. */
+	constexpr uint32 NumScanCodes = ARRAY_COUNT(ScanCodeKeys);
+
+	/** First G-key and logo key names, which are not scan codes. */
+	constexpr uint32 FirstGKeyName = LogiLed::G_1;
+	constexpr uint32 FirstGLogoName = LogiLed::G_LOGO;
+
+	/** Number of G-keys and logo keys. */
+	constexpr uint32 NumGKeys = (uint32)ELogiLedKeys::G9 - (uint32)ELogiLedKeys::G1 + 1;
+	constexpr uint32 NumGLogos = (uint32)ELogiLedKeys::GBadge - (uint32)ELogiLedKeys::GLogo + 1;
+
+	/** Check that the tables map the key at the given index back to itself. */
+	constexpr bool IsValidEntry(int32 Index)
+	{
+		return (Index >= Count) || (
+			(((uint32)KeyNames[Index] < NumScanCodes)
+				? (ScanCodeKeys[KeyNames[Index]] == Index)
+				: (((uint32)KeyNames[Index] >= FirstGLogoName)
+					? ((uint32)KeyNames[Index] - FirstGLogoName + (uint32)ELogiLedKeys::GLogo == (uint32)Index)
+					: ((uint32)KeyNames[Index] - FirstGKeyName + (uint32)ELogiLedKeys::G1 == (uint32)Index))) &&
+			(BitmapCells[Index] < NumBitmapCells) &&
+			IsValidEntry(Index + 1));
+	}
+
+	static_assert(IsValidEntry(0), "Key translation tables are inconsistent");
+
+	/**
+	 * Get the SDK key name for the given key.
+	 *
+	 * @param Key The key.
+	 * @return The SDK key name.
+	 */
+	FORCEINLINE LogiLed::KeyName ToKeyName(ELogiLedKeys Key)
+	{
+		checkSlow((int32)Key < Count);
+		return KeyNames[(int32)Key];
+	}
+
+	/**
+	 * Get the key for the given SDK key name.
+	 *
+	 * @param KeyName The SDK key name.
+	 * @param OutKey Will contain the key.
+	 * @return true if the key name is known, false otherwise.
+	 */
+	FORCEINLINE bool ToKey(LogiLed::KeyName KeyName, ELogiLedKeys& OutKey)
+	{
+		const uint32 Code = (uint32)KeyName;
+		uint32 Index = InvalidKey;
+
+		if (Code < NumScanCodes)
+		{
+			Index = ScanCodeKeys[Code];
+		}
+		else if (Code - FirstGKeyName < NumGKeys)
+		{
+			Index = (uint32)ELogiLedKeys::G1 + Code - FirstGKeyName;
+		}
+		else if (Code - FirstGLogoName < NumGLogos)
+		{
+			Index = (uint32)ELogiLedKeys::GLogo + Code - FirstGLogoName;
+		}
+
+		if (Index == InvalidKey)
+		{
+			return false;
+		}
+
+		OutKey = (ELogiLedKeys)Index;
+
+		return true;
+	}
+
+	/**
+	 * Get the bitmap cell of the given key.
+	 *
+	 * @param Key The key.
+	 * @return The cell index, or INDEX_NONE if the key is not part of the bitmap.
+	 */
+	FORCEINLINE int32 ToBitmapCell(ELogiLedKeys Key)
+	{
+		checkSlow((int32)Key < Count);
+		return BitmapCells[(int32)Key];
+	}
+
+	/**
+	 * Get the bitmap cell of the given SDK key name.
+	 *
+	 * @param KeyName The SDK key name.
+	 * @return The cell index, or INDEX_NONE if the key is not part of the bitmap.
+	 */
+	FORCEINLINE int32 ToBitmapCell(LogiLed::KeyName KeyName)
+	{
+		ELogiLedKeys Key;
+		return ToKey(KeyName, Key) ? BitmapCells[(int32)Key] : INDEX_NONE;
+	}
+
+	/**
+	 * Get the display name of the given key.
+	 *
+	 * @param Key The key.
+	 * @return The key's name.
+	 */
+	FORCEINLINE const TCHAR* ToString(ELogiLedKeys Key)
+	{
+		return ((int32)Key < Count) ? Strings[(int32)Key] : TEXT("Invalid");
+	}
+
+	/**
+	 * Get the OpenRGB LED name of the given key.
+	 *
+	 * @param Key The key.
+	 * @return The LED name, or nullptr if OpenRGB has no name for the key.
+	 */
+	FORCEINLINE const ANSICHAR* ToOpenRgbName(ELogiLedKeys Key)
+	{
+		checkSlow((int32)Key < Count);
+		return OpenRgbNames[(int32)Key];
+	}
+}
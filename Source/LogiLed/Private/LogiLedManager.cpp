@@ -1,117 +1,1844 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "LogiLedManager.h"
+#include "LogiLedEffectGraph.h"
+#include "LogiLedEventMap.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedSdk.h"
+#include "LogiLedSharedFrame.h"
+#include "LogiLedSnapshot.h"
 
 #include "Classes/Curves/CurveLinearColor.h"
+#include "CoreGlobals.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Templates/UniquePtr.h"
 
 #if WITH_EDITOR
 	#include "Editor.h"
 #endif
 
 
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Idle Time %"), STAT_LogiLedIdlePercentage, STATGROUP_LogiLed);
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Switches"), STAT_LogiLedTargetSwitches, STATGROUP_LogiLed);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Per-Key Updates"), STAT_LogiLedPerKeyUpdates, STATGROUP_LogiLed);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lighting Updates"), STAT_LogiLedLightingUpdates, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Global Flushes"), STAT_LogiLedGlobalFlushes, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bitmap Flushes"), STAT_LogiLedBitmapFlushes, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Per-Key Flushes"), STAT_LogiLedPerKeyFlushes, STATGROUP_LogiLed);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Keys"), STAT_LogiLedDeferredKeys, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Budget Overruns"), STAT_LogiLedBudgetOverruns, STATGROUP_LogiLed);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Budget Overrun Time (ms)"), STAT_LogiLedBudgetOverrunTime, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Meter Updates"), STAT_LogiLedMeterUpdates, STATGROUP_LogiLed);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Events Started"), STAT_LogiLedEventsStarted, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Events Dropped"), STAT_LogiLedEventsDropped, STATGROUP_LogiLed);
+
+
+/** Maximum number of SDK commands that are deferred while the SDK is connecting. */
+static const int32 LogiLedMaxDeferredCommands = 1024;
+
+/** Initial latency estimates for SDK calls, until actual latencies have been measured (in seconds). */
+static const double LogiLedInitialCallCost = 0.00005;
+static const double LogiLedInitialBitmapCallCost = 0.0002;
+
+/** Number of flushes a deferred key has to wait to gain one priority level. */
+static const int32 LogiLedFlushesPerPriority = 8;
+
+/** Maximum number of saved lighting snapshots. */
+static const int32 LogiLedMaxSavedLightings = 32;
+
+/** Maximum number of different gameplay events that are queued per tick. */
+static const int32 LogiLedMaxQueuedEvents = 256;
+
+
+namespace LogiLedManagers
+{
+	/** Managers by PIE instance (INDEX_NONE outside of PIE). */
+	TMap<int32, TUniquePtr<FLogiLedManager>> Managers;
+
+	/** The most recently used manager, and the PIE instance it belongs to. */
+	FLogiLedManager* LastManager = nullptr;
+	int32 LastInstance = INDEX_NONE;
+
+	/** The manager that sends its lighting to the devices (nullptr if no manager exists). */
+	FLogiLedManager* ActiveManager = nullptr;
+
+#if WITH_EDITOR
+	/** Handle to the EndPIE callback (registered with the first manager, removed in DestroyAll). */
+	FDelegateHandle EndPIEHandle;
+#endif
+
+	/** Activate the manager of the first PIE instance, or the global manager outside of PIE. */
+	void UpdateActive()
+	{
+		int32 ActiveInstance = MAX_int32;
+
+		for (const auto& Pair : Managers)
+		{
+			if ((Pair.Key != INDEX_NONE) && (Pair.Key < ActiveInstance))
+			{
+				ActiveInstance = Pair.Key;
+			}
+		}
+
+		if (ActiveInstance == MAX_int32)
+		{
+			ActiveInstance = INDEX_NONE;
+		}
+
+		ActiveManager = nullptr;
+
+		for (const auto& Pair : Managers)
+		{
+			const bool Active = (Pair.Key == ActiveInstance);
+
+			if (Active)
+			{
+				ActiveManager = Pair.Value.Get();
+			}
+
+			Pair.Value->SetActive(Active);
+		}
+	}
+}
+
+
 /* FLogiLedManager structors
  *****************************************************************************/
 
 FLogiLedManager::FLogiLedManager()
+	: EffectTime(0.0f)
+	, HasExplicitRgbColor(false)
+	, HasExplicitMonochromeColor(false)
+	, RgbColor(FColor::Black)
+	, MonochromeColor(FColor::Black)
+	, FlushedRgbColor(FColor::Black)
+	, FlushedMonochromeColor(FColor::Black)
+	, FlushedValid(true)
+	, BitmapCallCost(LogiLedInitialBitmapCallCost)
+	, LightingCallCost(LogiLedInitialCallCost)
+	, PerKeyCallCost(LogiLedInitialCallCost)
+	, PlannedStrategy(EFlushStrategy::PerKey)
+	, Budget(0.0)
+	, Priority(ELogiLedPriority::Gameplay)
+	, FadeDuration(0.0f)
+	, FadeTime(0.0f)
+	, Dithering(false)
+	, TargetDevice(LOGI_DEVICETYPE_ALL)
+	, SdkTargetDevice(0)
+	, Sleeping(true)
+	, Backgrounded(false)
+	, FocusLost(false)
+	, Inactive(false)
+	, Paused(false)
+	, SuspendWhenPaused(true)
+	, IdleSeconds(0.0)
+	, SleepStartTime(0.0)
+	, StartTime(0.0)
+{
+	for (FLogiLedFrame& OverrideFrame : OverrideFrames)
+	{
+		OverrideFrame.Fill(FColor(0, 0, 0, 0));
+	}
+
+	FMemory::Memzero(HasOverrides);
+	FMemory::Memzero(ExcludedFromBitmap);
+	FMemory::Memzero(KeyAges);
+	FMemory::Memzero(FadingKeys);
+	SetKeyPriorities();
+	ResetResiduals();
+
+	// queuing events must not allocate
+	QueuedEvents.Reserve(LogiLedMaxQueuedEvents);
+
+	FLogiLedSdk::OnConnected().AddRaw(this, &FLogiLedManager::HandleSdkConnected);
+
+	FCoreDelegates::ApplicationHasEnteredForegroundDelegate.AddRaw(this, &FLogiLedManager::HandleApplicationHasEnteredForeground);
+	FCoreDelegates::ApplicationWillEnterBackgroundDelegate.AddRaw(this, &FLogiLedManager::HandleApplicationWillEnterBackground);
+
+	// managers are usually created after Slate is up
+	if (FSlateApplication::IsInitialized())
+	{
+		HandlePostEngineInit();
+	}
+	else
+	{
+		FCoreDelegates::OnPostEngineInit.AddRaw(this, &FLogiLedManager::HandlePostEngineInit);
+	}
+}
+
+
+FLogiLedManager::~FLogiLedManager()
+{
+	FLogiLedSdk::OnConnected().RemoveAll(this);
+
+	FCoreDelegates::ApplicationHasEnteredForegroundDelegate.RemoveAll(this);
+	FCoreDelegates::ApplicationWillEnterBackgroundDelegate.RemoveAll(this);
+	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnApplicationActivationStateChanged().RemoveAll(this);
+	}
+}
+
+
+/* FLogiLedManager static functions
+ *****************************************************************************/
+
+void FLogiLedManager::ClearAllOverrideFrames(ELogiLedOverrideLayer Layer)
+{
+	check(IsInGameThread());
+
+	for (const auto& Pair : LogiLedManagers::Managers)
+	{
+		Pair.Value->ClearOverrideFrame(Layer);
+	}
+}
+
+
+void FLogiLedManager::DestroyAll()
 {
 #if WITH_EDITOR
-	FEditorDelegates::EndPIE.AddRaw(this, &FLogiLedManager::HandleEditorEndPIE);
+	FEditorDelegates::EndPIE.Remove(LogiLedManagers::EndPIEHandle);
+	LogiLedManagers::EndPIEHandle.Reset();
 #endif
+
+	LogiLedManagers::Managers.Empty();
+	LogiLedManagers::LastManager = nullptr;
+	LogiLedManagers::LastInstance = INDEX_NONE;
+	LogiLedManagers::ActiveManager = nullptr;
 }
 
 
-FLogiLedManager::~FLogiLedManager()
+FLogiLedManager& FLogiLedManager::Get()
 {
+	check(IsInGameThread());
+
+	const int32 Instance = GPlayInEditorID;
+
+	if ((LogiLedManagers::LastManager != nullptr) && (LogiLedManagers::LastInstance == Instance))
+	{
+		return *LogiLedManagers::LastManager;
+	}
+
+	TUniquePtr<FLogiLedManager>& Manager = LogiLedManagers::Managers.FindOrAdd(Instance);
+
+	if (!Manager.IsValid())
+	{
+		if (LogiLedManagers::Managers.Num() == 1)
+		{
+			// commandlets only preview lighting
+			if (!IsRunningCommandlet())
+			{
+				// the SDK initializes in the background, so this must not block
+				FLogiLedSdk::Connect();
+			}
+		}
+
 #if WITH_EDITOR
-	FEditorDelegates::EndPIE.RemoveAll(this);
+		// PIE managers come and go with their sessions, so the map may be empty again without DestroyAll
+		if (!LogiLedManagers::EndPIEHandle.IsValid())
+		{
+			LogiLedManagers::EndPIEHandle = FEditorDelegates::EndPIE.AddStatic(&FLogiLedManager::HandleEditorEndPIE);
+		}
 #endif
+
+		Manager = MakeUnique<FLogiLedManager>();
+		LogiLedManagers::UpdateActive();
+	}
+
+	LogiLedManagers::LastManager = Manager.Get();
+	LogiLedManagers::LastInstance = Instance;
+
+	return *Manager;
+}
+
+
+FLogiLedManager& FLogiLedManager::GetActive()
+{
+	check(IsInGameThread());
+
+	if (LogiLedManagers::ActiveManager == nullptr)
+	{
+		// the first manager becomes the active one
+		return Get();
+	}
+
+	return *LogiLedManagers::ActiveManager;
 }
 
 
 /* FLogiLedManager interface
  *****************************************************************************/
 
-void FLogiLedManager::PlayAnimation(UCurveLinearColor* ColorCurve)
+void FLogiLedManager::ApplyTargetDevice()
 {
-	Animation.Curve = ColorCurve;
-	Animation.Time = 0.0f;
+	if (FLogiLedSdk::IsAvailable())
+	{
+		SetSdkTargetDevice(TargetDevice);
+	}
 }
 
 
-void FLogiLedManager::PlayAnimation(LogiLed::KeyName KeyName, UCurveLinearColor* ColorCurve)
+void FLogiLedManager::ClearOverrideFrame(ELogiLedOverrideLayer Layer)
 {
-	FAnimation& KeyAnimation = KeyAnimations.FindOrAdd(KeyName);
+	if (HasOverrides[(int32)Layer])
 	{
-		KeyAnimation.Curve = ColorCurve;
-		KeyAnimation.Time = 0.0f;
+		OverrideFrames[(int32)Layer].Fill(FColor(0, 0, 0, 0));
+		HasOverrides[(int32)Layer] = false;
+
+		WakeUp();
 	}
 }
 
 
-void FLogiLedManager::StopAnimations()
+void FLogiLedManager::BindMeter(FName Name, const FLogiLedMeter& Meter)
 {
-	Animation.Curve.Reset();
-	KeyAnimations.Empty();
+	FBoundMeter& BoundMeter = Meters.Add(Name);
+	const int32 NumKeys = Meter.Keys.Num();
+
+	BoundMeter.KeyIndices.Reset(NumKeys);
+	BoundMeter.FullColors.Reset(NumKeys);
+	BoundMeter.EmptyColor = Meter.EmptyColor;
+	BoundMeter.StepsPerKey = FMath::Clamp(Meter.StepsPerKey, 1, 100);
+	BoundMeter.Level = INDEX_NONE;
+
+	for (int32 Position = 0; Position < NumKeys; ++Position)
+	{
+		const float Alpha = (NumKeys > 1) ? (float)Position / (NumKeys - 1) : 0.0f;
+
+		BoundMeter.KeyIndices.Add((int32)Meter.Keys[Position]);
+		BoundMeter.FullColors.Add((Meter.Gradient != nullptr) ? Meter.Gradient->GetLinearColorValue(Alpha) : FMath::Lerp(Meter.StartColor, Meter.EndColor, Alpha));
+	}
 }
 
 
-void FLogiLedManager::StopAnimations(LogiLed::KeyName KeyName)
+void FLogiLedManager::DeferCommand(TFunction<void()>&& Command)
 {
-	KeyAnimations.Remove(KeyName);
+	if (FLogiLedSdk::GetState() != ELogiLedSdkState::Connecting)
+	{
+		return;
+	}
+
+	if (DeferredCommands.Num() >= LogiLedMaxDeferredCommands)
+	{
+		static FLogiLedFailureCounter Failures(TEXT("FLogiLedManager::DeferCommand"), false);
+		Failures.Add();
+
+		return;
+	}
+
+	DeferredCommands.Add(MoveTemp(Command));
 }
 
 
-/* FTickableGameObject interface
- *****************************************************************************/
+void FLogiLedManager::ExcludeKeysFromBitmap(const TArray<ELogiLedKeys>& Keys)
+{
+	FMemory::Memzero(ExcludedFromBitmap);
 
-TStatId FLogiLedManager::GetStatId() const
+	for (ELogiLedKeys Key : Keys)
+	{
+		ExcludedFromBitmap[(int32)Key] = true;
+	}
+}
+
+
+float FLogiLedManager::GetIdlePercentage() const
 {
-	RETURN_QUICK_DECLARE_CYCLE_STAT(FLogiLedManager, STATGROUP_Tickables);
+	if (StartTime == 0.0)
+	{
+		return 100.0f;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double TotalSeconds = Now - StartTime;
+
+	if (TotalSeconds <= 0.0)
+	{
+		return 0.0f;
+	}
+
+	const double SleptSeconds = IdleSeconds + (Sleeping ? (Now - SleepStartTime) : 0.0);
+
+	return (float)(100.0 * SleptSeconds / TotalSeconds);
 }
 
 
-bool FLogiLedManager::IsTickable() const
+void FLogiLedManager::Invalidate()
 {
-	return (Animation.Curve != nullptr) || (KeyAnimations.Num() > 0);
+	FlushedValid = false;
+	SdkTargetDevice = 0;
+
+	// static lighting is resent with the next change, animations right away
+	if (Effects.Num() > 0)
+	{
+		WakeUp();
+	}
 }
 
 
-void FLogiLedManager::Tick(float DeltaTime)
+FLogiLedEffectHandle FLogiLedManager::PlayAnimation(UCurveLinearColor* ColorCurve)
 {
-	// global animation
-	if (Animation.Curve != nullptr)
+	Effects.Remove(GlobalEffect);
+	GlobalEffect.Invalidate();
+
+	if (ColorCurve != nullptr)
 	{
-		const FLinearColor Percentage = Animation.Curve->GetLinearColorValue(Animation.Time).GetClamped() * 100.0f;
-		::LogiLedSetLighting(Percentage.R, Percentage.G, Percentage.B);
+		GlobalEffect = Effects.Add(*ColorCurve, INDEX_NONE, TargetDevice);
+
+		if ((TargetDevice & LOGI_DEVICETYPE_PERKEY_RGB) != 0)
+		{
+			SetKeyPriorities();
+		}
 
-		Animation.Time += DeltaTime;
+		WakeUp();
 	}
 
-	// override individual keys
-	for (auto& KeyAnimationsPair : KeyAnimations)
+	return GlobalEffect;
+}
+
+
+FLogiLedEffectHandle FLogiLedManager::PlayAnimation(ELogiLedKeys Key, UCurveLinearColor* ColorCurve)
+{
+	if (ColorCurve == nullptr)
+	{
+		return PlayKeyEffect(Key, INDEX_NONE);
+	}
+
+	const int32 CurveIndex = Effects.AcquireCurve(*ColorCurve);
+	const FLogiLedEffectHandle KeyEffect = PlayKeyEffect(Key, CurveIndex);
+
+	if (CurveIndex != INDEX_NONE)
+	{
+		Effects.ReleaseCurve(CurveIndex);
+	}
+
+	return KeyEffect;
+}
+
+
+bool FLogiLedManager::PlayEffectGraph(const ULogiLedEffectGraph& Graph)
+{
+	FString Error;
+
+	if (!EffectProgram.Compile(Graph, Error))
+	{
+		UE_LOG(LogLogiLed, Warning, TEXT("Failed to compile effect graph %s: %s"), *Graph.GetPathName(), *Error);
+		return false;
+	}
+
+	for (const auto& Pair : EffectParameters)
+	{
+		EffectProgram.SetParameter(Pair.Key, Pair.Value);
+	}
+
+	EffectTime = 0.0f;
+	SetKeyPriorities();
+	WakeUp();
+
+	return true;
+}
+
+
+void FLogiLedManager::QueueEvent(const ULogiLedEventMap& Map, int32 EventIndex)
+{
+	// events are momentary, so they are not replayed when output resumes
+	if (IsSuspended())
 	{
-		FAnimation& KeyAnimation = KeyAnimationsPair.Value;
+		return;
+	}
 
-		if (KeyAnimation.Curve != nullptr)
+	for (const FQueuedEvent& Queued : QueuedEvents)
+	{
+		if ((Queued.EventIndex == EventIndex) && (Queued.Map.Get() == &Map))
 		{
-			const FLinearColor Percentage = KeyAnimation.Curve->GetLinearColorValue(KeyAnimation.Time).GetClamped() * 100.0f;
-			::LogiLedSetLightingForKeyWithKeyName(KeyAnimationsPair.Key, Percentage.R, Percentage.G, Percentage.B);
+			return;
+		}
+	}
 
-			KeyAnimation.Time += DeltaTime;
+	if (QueuedEvents.Num() >= LogiLedMaxQueuedEvents)
+	{
+		INC_DWORD_STAT(STAT_LogiLedEventsDropped);
+		return;
+	}
+
+	FQueuedEvent& Event = QueuedEvents[QueuedEvents.AddDefaulted()];
+	{
+		Event.Map = &Map;
+		Event.EventIndex = EventIndex;
+	}
+
+	WakeUp();
+}
+
+
+bool FLogiLedManager::SetAnimationTime(FLogiLedEffectHandle Handle, float Time)
+{
+	FLogiLedEffect* Effect = Effects.Find(Handle);
+
+	if (Effect == nullptr)
+	{
+		return false;
+	}
+
+	Effect->Time = Time;
+	Effect->ConstantUntil = 0.0f;
+
+	WakeUp();
+
+	return true;
+}
+
+
+bool FLogiLedManager::RestoreLighting(FName Name, float FadeSeconds, bool Discard, const TArray<ELogiLedKeys>* Keys)
+{
+	const int32 SavedIndex = SavedLightings.FindLastByPredicate([Name](const FSavedLighting& Saved) { return Saved.Name == Name; });
+
+	if (SavedIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FSavedLighting& Saved = SavedLightings[SavedIndex];
+
+	bool Restore[LogiLedKeys::Count];
+	FMemory::Memcpy(Restore, Saved.SavedKeys, sizeof(Restore));
+
+	if (Keys != nullptr)
+	{
+		bool Requested[LogiLedKeys::Count] = { };
+
+		for (ELogiLedKeys Key : *Keys)
+		{
+			Requested[(int32)Key] = true;
+		}
+
+		for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+		{
+			Restore[KeyIndex] = Restore[KeyIndex] && Requested[KeyIndex];
+		}
+	}
+
+	// fade from what is currently shown, including any fade in progress
+	if (FadeSeconds > 0.0f)
+	{
+		FadeFrame = PerKeyFrame;
+		FadeDuration = FadeSeconds;
+		FadeTime = 0.0f;
+	}
+
+	const bool RestoreAll = (Keys == nullptr) && Saved.SavedSingleColors;
+
+	if (RestoreAll)
+	{
+		StopAnimation(GlobalEffect);
+
+		ExplicitRgbColor = Saved.RgbColor;
+		ExplicitMonochromeColor = Saved.MonochromeColor;
+		HasExplicitRgbColor = true;
+		HasExplicitMonochromeColor = true;
+	}
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		if (Restore[KeyIndex])
+		{
+			StopAnimation(KeyEffects[KeyIndex]);
+
+			BaseFrame.Colors[KeyIndex] = Saved.Frame.Colors[KeyIndex];
+			KeyPriorities[KeyIndex] = Priority;
 		}
+
+		FadingKeys[KeyIndex] = (FadeSeconds > 0.0f) && (Restore[KeyIndex] || FadingKeys[KeyIndex]);
+	}
+
+	// nested states that were saved later are closed, too
+	if (Discard)
+	{
+		SavedLightings.RemoveAt(SavedIndex, SavedLightings.Num() - SavedIndex);
 	}
+
+	WakeUp();
+
+	return true;
 }
 
 
-/* FLogiLedManager callbacks
- *****************************************************************************/
+void FLogiLedManager::SaveLighting(FName Name, const TArray<ELogiLedKeys>* Keys)
+{
+	FSavedLighting* Saved = SavedLightings.FindByPredicate([Name](const FSavedLighting& Other) { return Other.Name == Name; });
 
-#if WITH_EDITOR
+	if ((Saved == nullptr) || (Keys == nullptr))
+	{
+		if (Saved != nullptr)
+		{
+			SavedLightings.RemoveAt(Saved - SavedLightings.GetData());
+		}
+		else if (SavedLightings.Num() >= LogiLedMaxSavedLightings)
+		{
+			UE_LOG(LogLogiLed, Warning, TEXT("Too many saved lighting snapshots, discarding %s"), *SavedLightings[0].Name.ToString());
+			SavedLightings.RemoveAt(0);
+		}
 
-void FLogiLedManager::HandleEditorEndPIE(bool bIsSimulating)
+		Saved = &SavedLightings[SavedLightings.AddDefaulted()];
+		Saved->Name = Name;
+		FMemory::Memzero(Saved->SavedKeys);
+		Saved->SavedSingleColors = false;
+	}
+
+	if (Keys == nullptr)
+	{
+		Saved->Frame = PerKeyFrame;
+		Saved->RgbColor = RgbColor;
+		Saved->MonochromeColor = MonochromeColor;
+		Saved->SavedSingleColors = true;
+
+		for (bool& SavedKey : Saved->SavedKeys)
+		{
+			SavedKey = true;
+		}
+	}
+	else
+	{
+		for (ELogiLedKeys Key : *Keys)
+		{
+			Saved->Frame.Colors[(int32)Key] = PerKeyFrame.Colors[(int32)Key];
+			Saved->SavedKeys[(int32)Key] = true;
+		}
+	}
+}
+
+
+void FLogiLedManager::SetBudget(double Seconds)
+{
+	Budget = FMath::Max(Seconds, 0.0);
+}
+
+
+void FLogiLedManager::SetDithering(bool Enabled)
 {
-	StopAnimations();
-	::LogiLedStopEffects();
+	if (Enabled != Dithering)
+	{
+		Dithering = Enabled;
+		ResetResiduals();
+
+		WakeUp();
+	}
+}
+
+
+void FLogiLedManager::SetEffectParameter(FName Name, float Value)
+{
+	EffectParameters.Add(Name, Value);
+
+	if (EffectProgram.SetParameter(Name, Value))
+	{
+		WakeUp();
+	}
+}
+
+
+void FLogiLedManager::SetLighting(const FLinearColor& Color)
+{
+	SetBaseColor(TargetDevice, FLogiLedFrame::ToPercentage(Color));
+	WakeUp();
+}
+
+
+void FLogiLedManager::SetLightingFromBitmap(const FColor* Pixels)
+{
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		if (IsInBitmap(KeyIndex))
+		{
+			BaseFrame.Colors[KeyIndex] = FLogiLedFrame::BytesToPercentage(Pixels[LogiLedKeys::BitmapCells[KeyIndex]]);
+			KeyPriorities[KeyIndex] = Priority;
+		}
+	}
+
+	WakeUp();
+}
+
+
+void FLogiLedManager::SetLightingForKey(ELogiLedKeys Key, const FLinearColor& Color)
+{
+	BaseFrame.Colors[(int32)Key] = FLogiLedFrame::ToPercentage(Color);
+	KeyPriorities[(int32)Key] = Priority;
+	WakeUp();
+}
+
+
+bool FLogiLedManager::SetMeterValue(FName Name, float Value)
+{
+	FBoundMeter* Meter = Meters.Find(Name);
+
+	if ((Meter == nullptr) || (Meter->KeyIndices.Num() == 0))
+	{
+		return false;
+	}
+
+	// values within the current step change nothing
+	const int32 NumSteps = Meter->KeyIndices.Num() * Meter->StepsPerKey;
+	const int32 Level = FMath::Clamp(FMath::FloorToInt(Value * NumSteps + KINDA_SMALL_NUMBER), 0, NumSteps);
+
+	if (Level == Meter->Level)
+	{
+		return false;
+	}
+
+	// only the keys between the old and the new level change
+	int32 FirstKey = 0;
+	int32 LastKey = Meter->KeyIndices.Num() - 1;
+
+	if (Meter->Level != INDEX_NONE)
+	{
+		FirstKey = FMath::Min(Level, Meter->Level) / Meter->StepsPerKey;
+		LastKey = FMath::Min((FMath::Max(Level, Meter->Level) - 1) / Meter->StepsPerKey, LastKey);
+	}
+
+	Meter->Level = Level;
+
+	bool Changed = false;
+
+	for (int32 Position = FirstKey; Position <= LastKey; ++Position)
+	{
+		const int32 LitSteps = FMath::Clamp(Level - Position * Meter->StepsPerKey, 0, Meter->StepsPerKey);
+		const FLinearColor Color = FMath::Lerp(Meter->EmptyColor, Meter->FullColors[Position], (float)LitSteps / Meter->StepsPerKey);
+		const int32 KeyIndex = Meter->KeyIndices[Position];
+		const FColor Percentage = FLogiLedFrame::ToPercentage(Color);
+
+		if (BaseFrame.Colors[KeyIndex] != Percentage)
+		{
+			BaseFrame.Colors[KeyIndex] = Percentage;
+			KeyPriorities[KeyIndex] = Priority;
+			Changed = true;
+		}
+	}
+
+	if (Changed)
+	{
+		INC_DWORD_STAT(STAT_LogiLedMeterUpdates);
+		WakeUp();
+	}
+
+	return Changed;
+}
+
+
+void FLogiLedManager::SetOverrideFrame(ELogiLedOverrideLayer Layer, const FLogiLedFrame& Frame)
+{
+	FLogiLedFrame& OverrideFrame = OverrideFrames[(int32)Layer];
+
+	if (Frame != OverrideFrame)
+	{
+		OverrideFrame = Frame;
+		HasOverrides[(int32)Layer] = true;
+
+		WakeUp();
+	}
+}
+
+
+void FLogiLedManager::SetPriority(ELogiLedPriority InPriority)
+{
+	Priority = InPriority;
+}
+
+
+void FLogiLedManager::SetSuspendWhenPaused(bool Suspend)
+{
+	SuspendWhenPaused = Suspend;
+
+	if (!Suspend)
+	{
+		SetSuspended(Paused, false);
+	}
+}
+
+
+void FLogiLedManager::SetTargetDevice(int32 InTargetDevice)
+{
+	TargetDevice = InTargetDevice;
+}
+
+
+void FLogiLedManager::StopAnimation(FLogiLedEffectHandle Handle)
+{
+	const FLogiLedEffect* Effect = Effects.Find(Handle);
+
+	if (Effect == nullptr)
+	{
+		return;
+	}
+
+	// events never become static lighting
+	if (Effect->Event)
+	{
+		((Effect->KeyIndex == INDEX_NONE) ? EventGlobalEffect : EventKeyEffects[Effect->KeyIndex]).Invalidate();
+	}
+	else
+	{
+		BakeAnimation(*Effect);
+		((Effect->KeyIndex == INDEX_NONE) ? GlobalEffect : KeyEffects[Effect->KeyIndex]).Invalidate();
+	}
+
+	Effects.Remove(Handle);
+}
+
+
+void FLogiLedManager::StopAnimations()
+{
+	// global animation first, so that key animations are baked on top
+	StopAnimation(GlobalEffect);
+
+	while (Effects.Num() > 0)
+	{
+		StopAnimation(Effects.GetHandle(Effects.Num() - 1));
+	}
+}
+
+
+void FLogiLedManager::StopAnimations(ELogiLedKeys Key)
+{
+	StopAnimation(KeyEffects[(int32)Key]);
+	StopAnimation(EventKeyEffects[(int32)Key]);
+}
+
+
+void FLogiLedManager::StopEffectGraph()
+{
+	if (EffectProgram.IsValid())
+	{
+		EffectProgram.Empty();
+		WakeUp();
+	}
+}
+
+
+void FLogiLedManager::UnbindMeter(FName Name)
+{
+	Meters.Remove(Name);
+}
+
+
+/* FLogiLedManager implementation
+ *****************************************************************************/
+
+bool FLogiLedManager::Compose(float DeltaTime)
+{
+	bool Settled = true;
+
+	PerKeyFrame = BaseFrame;
+
+	auto ComposeGlobalAnimation = [this, DeltaTime, &Settled](FLogiLedEffect& GlobalAnimation)
+	{
+		if ((GlobalAnimation.TargetDevice & LOGI_DEVICETYPE_PERKEY_RGB) != 0)
+		{
+			if (Dithering)
+			{
+				for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+				{
+					PerKeyFrame.Colors[KeyIndex] = Quantize(GlobalAnimation, KeyResiduals[KeyIndex]);
+				}
+			}
+			else
+			{
+				PerKeyFrame.Fill(GlobalAnimation.Value);
+			}
+		}
+
+		Settled = Settled && (GlobalAnimation.ConstantUntil == MAX_flt);
+		GlobalAnimation.Time += DeltaTime;
+	};
+
+	auto ComposeKeyAnimations = [this, DeltaTime, &Settled](bool Events)
+	{
+		for (int32 Position = 0; Position < Effects.Num(); ++Position)
+		{
+			FLogiLedEffect& KeyAnimation = Effects.GetEffect(Position);
+
+			if ((KeyAnimation.KeyIndex == INDEX_NONE) || (KeyAnimation.Event != Events))
+			{
+				continue;
+			}
+
+			if (Events && (KeyAnimation.ConstantUntil == MAX_flt))
+			{
+				// the last playing animation is swapped into this position
+				EventKeyEffects[KeyAnimation.KeyIndex].Invalidate();
+				Effects.Remove(Effects.GetHandle(Position--));
+
+				continue;
+			}
+
+			PerKeyFrame.Colors[KeyAnimation.KeyIndex] = Dithering ? Quantize(KeyAnimation, KeyResiduals[KeyAnimation.KeyIndex]) : KeyAnimation.Value;
+
+			Settled = Settled && (KeyAnimation.ConstantUntil == MAX_flt);
+			KeyAnimation.Time += DeltaTime;
+		}
+	};
+
+	// global animation
+	FLogiLedEffect* Animation = Effects.Find(GlobalEffect);
+	FLogiLedEffect* EventAnimation = Effects.Find(EventGlobalEffect);
+
+	Effects.Evaluate();
+
+	// events end without leaving their last color behind
+	if ((EventAnimation != nullptr) && (EventAnimation->ConstantUntil == MAX_flt))
+	{
+		Effects.Remove(EventGlobalEffect);
+		EventGlobalEffect.Invalidate();
+		EventAnimation = nullptr;
+	}
+
+	if (Animation != nullptr)
+	{
+		ComposeGlobalAnimation(*Animation);
+	}
+
+	// effect graph
+	if (EffectProgram.IsValid())
+	{
+		EffectProgram.Execute(EffectTime, PerKeyFrame);
+
+		Settled = Settled && !EffectProgram.IsAnimated();
+		EffectTime += DeltaTime;
+	}
+
+	// override individual keys
+	ComposeKeyAnimations(false);
+
+	// cross-fade from restored lighting
+	if (FadeDuration > 0.0f)
+	{
+		FadeTime += DeltaTime;
+
+		const float Alpha = FMath::Clamp(FadeTime / FadeDuration, 0.0f, 1.0f);
+
+		for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+		{
+			if (FadingKeys[KeyIndex])
+			{
+				const FColor& From = FadeFrame.Colors[KeyIndex];
+				FColor& To = PerKeyFrame.Colors[KeyIndex];
+
+				To.R = (uint8)FMath::RoundToInt(FMath::Lerp((float)From.R, (float)To.R, Alpha));
+				To.G = (uint8)FMath::RoundToInt(FMath::Lerp((float)From.G, (float)To.G, Alpha));
+				To.B = (uint8)FMath::RoundToInt(FMath::Lerp((float)From.B, (float)To.B, Alpha));
+			}
+		}
+
+		if (Alpha < 1.0f)
+		{
+			Settled = false;
+		}
+		else
+		{
+			FadeDuration = 0.0f;
+			FMemory::Memzero(FadingKeys);
+		}
+	}
+
+	// gameplay events, on top of everything but external overrides
+	if (EventAnimation != nullptr)
+	{
+		ComposeGlobalAnimation(*EventAnimation);
+	}
+
+	ComposeKeyAnimations(true);
+
+	// external overrides, layers of higher priority last
+	for (int32 Layer = 0; Layer < (int32)ELogiLedOverrideLayer::Count; ++Layer)
+	{
+		if (!HasOverrides[Layer])
+		{
+			continue;
+		}
+
+		const FLogiLedFrame& OverrideFrame = OverrideFrames[Layer];
+
+		for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+		{
+			const FColor& OverrideColor = OverrideFrame.Colors[KeyIndex];
+
+			if (OverrideColor.A != 0)
+			{
+				PerKeyFrame.Colors[KeyIndex] = FColor(OverrideColor.R, OverrideColor.G, OverrideColor.B);
+			}
+		}
+	}
+
+	// single color devices, events first
+	auto FindSingleColorAnimation = [Animation, EventAnimation](int32 DeviceType) -> const FLogiLedEffect*
+	{
+		if ((EventAnimation != nullptr) && ((EventAnimation->TargetDevice & DeviceType) != 0))
+		{
+			return EventAnimation;
+		}
+
+		if ((Animation != nullptr) && ((Animation->TargetDevice & DeviceType) != 0))
+		{
+			return Animation;
+		}
+
+		return nullptr;
+	};
+
+	const FLogiLedEffect* RgbAnimation = FindSingleColorAnimation(LOGI_DEVICETYPE_RGB);
+
+	if (RgbAnimation != nullptr)
+	{
+		RgbColor = Dithering ? Quantize(*RgbAnimation, RgbResidual) : RgbAnimation->Value;
+	}
+	else
+	{
+		RgbColor = HasExplicitRgbColor ? ExplicitRgbColor : PerKeyFrame.GetAverage();
+	}
+
+	const FLogiLedEffect* MonochromeAnimation = FindSingleColorAnimation(LOGI_DEVICETYPE_MONOCHROME);
+
+	if (MonochromeAnimation != nullptr)
+	{
+		MonochromeColor = Dithering ? Quantize(*MonochromeAnimation, MonochromeResidual) : MonochromeAnimation->Value;
+	}
+	else
+	{
+		MonochromeColor = HasExplicitMonochromeColor ? ExplicitMonochromeColor : PerKeyFrame.GetAverage();
+	}
+
+	return Settled;
+}
+
+
+void FLogiLedManager::BakeAnimation(const FLogiLedEffect& Effect)
+{
+	// animations that never played have no color yet
+	if (Effect.Time <= 0.0f)
+	{
+		return;
+	}
+
+	if (Effect.KeyIndex == INDEX_NONE)
+	{
+		SetBaseColor(Effect.TargetDevice, Effect.Value);
+	}
+	else
+	{
+		BaseFrame.Colors[Effect.KeyIndex] = Effect.Value;
+	}
+}
+
+
+bool FLogiLedManager::Flush()
+{
+	// unknown colors never match composed colors, whose alpha is never zero
+	if (!FlushedValid)
+	{
+		FlushedPerKeyFrame.Fill(FColor(0, 0, 0, 0));
+	}
+
+	const bool PerKeyChanged = (PerKeyFrame != FlushedPerKeyFrame);
+	const bool RgbChanged = !FlushedValid || (RgbColor != FlushedRgbColor);
+	const bool MonochromeChanged = !FlushedValid || (MonochromeColor != FlushedMonochromeColor);
+
+	if (!PerKeyChanged && !RgbChanged && !MonochromeChanged)
+	{
+		SET_DWORD_STAT(STAT_LogiLedDeferredKeys, 0);
+		return true;
+	}
+
+	const double FlushStartTime = FPlatformTime::Seconds();
+
+	// group device classes that receive the same color, so they can share a target
+	struct FColorGroup
+	{
+		FColor Color;
+		int32 TargetDevice;
+	};
+
+	FColorGroup Groups[3];
+	int32 NumGroups = 0;
+
+	auto AddToGroup = [&Groups, &NumGroups](FColor Color, int32 Device)
+	{
+		for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+		{
+			if (Groups[GroupIndex].Color == Color)
+			{
+				Groups[GroupIndex].TargetDevice |= Device;
+				return;
+			}
+		}
+
+		Groups[NumGroups].Color = Color;
+		Groups[NumGroups].TargetDevice = Device;
+		++NumGroups;
+	};
+
+	FColor UniformColor;
+	bool PerKeyGlobal = false;
+	bool PerKeyPending = false;
+
+	if (RgbChanged)
+	{
+		AddToGroup(RgbColor, LOGI_DEVICETYPE_RGB);
+	}
+
+	if (MonochromeChanged)
+	{
+		AddToGroup(MonochromeColor, LOGI_DEVICETYPE_MONOCHROME);
+	}
+
+	if (PerKeyChanged)
+	{
+		if (PlanPerKeyFlush() == EFlushStrategy::Global)
+		{
+			PerKeyFrame.IsUniform(UniformColor);
+			AddToGroup(UniformColor, LOGI_DEVICETYPE_PERKEY_RGB);
+			PerKeyGlobal = true;
+			INC_DWORD_STAT(STAT_LogiLedGlobalFlushes);
+		}
+		else
+		{
+			PerKeyPending = true;
+		}
+	}
+
+	// single color updates are always sent, per-key updates get what is left of the budget
+	const double PerKeyBudget = (Budget > 0.0) ? (Budget - NumGroups * LightingCallCost.Get()) : MAX_dbl;
+	int32 NumDeferred = 0;
+
+	// start with the group that needs no target switch
+	for (int32 GroupIndex = 1; GroupIndex < NumGroups; ++GroupIndex)
+	{
+		if (Groups[GroupIndex].TargetDevice == SdkTargetDevice)
+		{
+			Swap(Groups[0], Groups[GroupIndex]);
+			break;
+		}
+	}
+
+	// per-key updates apply to per-key devices under any target that includes them
+	auto FlushPerKey = [this, &PerKeyPending, &NumDeferred, PerKeyBudget]()
+	{
+		NumDeferred = FlushPerKeyFrame(PerKeyBudget);
+		PerKeyPending = false;
+	};
+
+	if (PerKeyPending && ((SdkTargetDevice & LOGI_DEVICETYPE_PERKEY_RGB) != 0))
+	{
+		FlushPerKey();
+	}
+
+	for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+	{
+		const FColorGroup& Group = Groups[GroupIndex];
+
+		SetSdkTargetDevice(Group.TargetDevice);
+		INC_DWORD_STAT(STAT_LogiLedLightingUpdates);
+
+		const double CallStartTime = FPlatformTime::Seconds();
+
+		if (!::LogiLedSetLighting(Group.Color.R, Group.Color.G, Group.Color.B))
+		{
+			static FLogiLedFailureCounter Failures(TEXT("FLogiLedManager::Flush (LogiLedSetLighting)"), true);
+			Failures.Add();
+		}
+
+		LightingCallCost.Add(FPlatformTime::Seconds() - CallStartTime, 1);
+
+		if (PerKeyPending && ((SdkTargetDevice & LOGI_DEVICETYPE_PERKEY_RGB) != 0))
+		{
+			FlushPerKey();
+		}
+	}
+
+	if (PerKeyPending)
+	{
+		SetSdkTargetDevice(LOGI_DEVICETYPE_PERKEY_RGB);
+		FlushPerKey();
+	}
+
+	if (PerKeyGlobal)
+	{
+		FlushedPerKeyFrame = PerKeyFrame;
+		FMemory::Memzero(KeyAges);
+	}
+
+	FlushedRgbColor = RgbColor;
+	FlushedMonochromeColor = MonochromeColor;
+	FlushedValid = true;
+
+	SET_DWORD_STAT(STAT_LogiLedDeferredKeys, NumDeferred);
+
+	if (Budget > 0.0)
+	{
+		const double Overrun = FPlatformTime::Seconds() - FlushStartTime - Budget;
+
+		if (Overrun > 0.0)
+		{
+			INC_DWORD_STAT(STAT_LogiLedBudgetOverruns);
+			INC_FLOAT_STAT_BY(STAT_LogiLedBudgetOverrunTime, (float)(Overrun * 1000.0));
+		}
+	}
+
+	return (NumDeferred == 0);
+}
+
+
+int32 FLogiLedManager::FlushPerKeyFrame(double Remaining)
+{
+	// keys in the bitmap are sent together, as urgently as the most urgent of them
+	int32 BitmapUrgency = INDEX_NONE;
+	int32 Keys[LogiLedKeys::Count];
+	int32 NumKeys = 0;
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		if (PerKeyFrame.Colors[KeyIndex] == FlushedPerKeyFrame.Colors[KeyIndex])
+		{
+			continue;
+		}
+
+		if ((PlannedStrategy == EFlushStrategy::Bitmap) && IsInBitmap(KeyIndex))
+		{
+			BitmapUrgency = FMath::Max(BitmapUrgency, GetUrgency(KeyIndex));
+		}
+		else
+		{
+			Keys[NumKeys++] = KeyIndex;
+		}
+	}
+
+	if (Budget > 0.0)
+	{
+		Sort(Keys, NumKeys, [this](int32 A, int32 B) { return GetUrgency(A) > GetUrgency(B); });
+	}
+
+	if (PlannedStrategy == EFlushStrategy::PerKey)
+	{
+		INC_DWORD_STAT(STAT_LogiLedPerKeyFlushes);
+	}
+
+	double PerKeySeconds = 0.0;
+	int32 NumCalls = 0;
+	int32 NextKey = 0;
+
+	while ((BitmapUrgency != INDEX_NONE) || (NextKey < NumKeys))
+	{
+		const bool SendBitmap = (BitmapUrgency != INDEX_NONE) && ((NextKey == NumKeys) || (BitmapUrgency >= GetUrgency(Keys[NextKey])));
+		const double Cost = SendBitmap ? BitmapCallCost.Get() : PerKeyCallCost.Get();
+
+		// defer the rest, but always make progress
+		if ((Cost > Remaining) && (NumCalls > 0))
+		{
+			break;
+		}
+
+		Remaining -= Cost;
+
+		const double CallStartTime = FPlatformTime::Seconds();
+
+		if (SendBitmap)
+		{
+			INC_DWORD_STAT(STAT_LogiLedBitmapFlushes);
+
+			uint8 Bitmap[LOGI_LED_BITMAP_SIZE];
+			FMemory::Memzero(Bitmap);
+
+			for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+			{
+				const int32 Cell = LogiLedKeys::BitmapCells[KeyIndex];
+
+				if (Cell != INDEX_NONE)
+				{
+					const FColor& Color = PerKeyFrame.Colors[KeyIndex];
+					uint8* Pixel = Bitmap + Cell * LOGI_LED_BITMAP_BYTES_PER_KEY;
+
+					// bitmap colors are BGRA bytes instead of percentages
+					Pixel[0] = (uint8)((Color.B * 255 + 50) / 100);
+					Pixel[1] = (uint8)((Color.G * 255 + 50) / 100);
+					Pixel[2] = (uint8)((Color.R * 255 + 50) / 100);
+					Pixel[3] = 255;
+				}
+			}
+
+			if (!::LogiLedSetLightingFromBitmap(Bitmap))
+			{
+				static FLogiLedFailureCounter Failures(TEXT("FLogiLedManager::Flush (LogiLedSetLightingFromBitmap)"), true);
+				Failures.Add();
+			}
+
+			BitmapCallCost.Add(FPlatformTime::Seconds() - CallStartTime, 1);
+
+			for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+			{
+				if (IsInBitmap(KeyIndex))
+				{
+					FlushedPerKeyFrame.Colors[KeyIndex] = PerKeyFrame.Colors[KeyIndex];
+					KeyAges[KeyIndex] = 0;
+				}
+			}
+
+			BitmapUrgency = INDEX_NONE;
+		}
+		else
+		{
+			const int32 KeyIndex = Keys[NextKey++];
+			const FColor& Color = PerKeyFrame.Colors[KeyIndex];
+
+			INC_DWORD_STAT(STAT_LogiLedPerKeyUpdates);
+
+			if (!::LogiLedSetLightingForKeyWithKeyName(LogiLedKeys::KeyNames[KeyIndex], Color.R, Color.G, Color.B))
+			{
+				static FLogiLedFailureCounter Failures(TEXT("FLogiLedManager::Flush (LogiLedSetLightingForKeyWithKeyName)"), false);
+				Failures.Add();
+			}
+
+			PerKeySeconds += FPlatformTime::Seconds() - CallStartTime;
+			FlushedPerKeyFrame.Colors[KeyIndex] = Color;
+			KeyAges[KeyIndex] = 0;
+		}
+
+		++NumCalls;
+	}
+
+	PerKeyCallCost.Add(PerKeySeconds, NextKey);
+
+	// deferred keys become more urgent with every flush
+	int32 NumDeferred = 0;
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		if (PerKeyFrame.Colors[KeyIndex] != FlushedPerKeyFrame.Colors[KeyIndex])
+		{
+			++KeyAges[KeyIndex];
+			++NumDeferred;
+		}
+	}
+
+	return NumDeferred;
+}
+
+
+int32 FLogiLedManager::GetUrgency(int32 KeyIndex) const
+{
+	return (int32)KeyPriorities[KeyIndex] * LogiLedFlushesPerPriority + KeyAges[KeyIndex];
+}
+
+
+bool FLogiLedManager::IsInBitmap(int32 KeyIndex) const
+{
+	return (LogiLedKeys::BitmapCells[KeyIndex] != INDEX_NONE) && !ExcludedFromBitmap[KeyIndex];
+}
+
+
+FLogiLedManager::EFlushStrategy FLogiLedManager::PlanPerKeyFlush()
+{
+	int32 NumChanged = 0;
+	int32 NumChangedOutsideBitmap = 0;
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		if (PerKeyFrame.Colors[KeyIndex] != FlushedPerKeyFrame.Colors[KeyIndex])
+		{
+			++NumChanged;
+
+			if (!IsInBitmap(KeyIndex))
+			{
+				++NumChangedOutsideBitmap;
+			}
+		}
+	}
+
+	const double PerKeyCost = PerKeyCallCost.Get() * NumChanged;
+	const double BitmapCost = BitmapCallCost.Get() + PerKeyCallCost.Get() * NumChangedOutsideBitmap;
+
+	FColor UniformColor;
+
+	if (PerKeyFrame.IsUniform(UniformColor) && (LightingCallCost.Get() <= FMath::Min(PerKeyCost, BitmapCost)))
+	{
+		PlannedStrategy = EFlushStrategy::Global;
+	}
+	else
+	{
+		PlannedStrategy = (BitmapCost < PerKeyCost) ? EFlushStrategy::Bitmap : EFlushStrategy::PerKey;
+	}
+
+	return PlannedStrategy;
+}
+
+
+FLogiLedEffectHandle FLogiLedManager::PlayKeyEffect(ELogiLedKeys Key, int32 CurveIndex)
+{
+	FLogiLedEffectHandle& KeyEffect = KeyEffects[(int32)Key];
+
+	Effects.Remove(KeyEffect);
+	KeyEffect.Invalidate();
+
+	if (CurveIndex != INDEX_NONE)
+	{
+		KeyEffect = Effects.Add(CurveIndex, (int32)Key, LOGI_DEVICETYPE_PERKEY_RGB);
+		KeyPriorities[(int32)Key] = Priority;
+		WakeUp();
+	}
+
+	return KeyEffect;
+}
+
+
+void FLogiLedManager::PlayEventEffect(int32 KeyIndex, int32 CurveIndex)
+{
+	FLogiLedEffectHandle& EventEffect = (KeyIndex == INDEX_NONE) ? EventGlobalEffect : EventKeyEffects[KeyIndex];
+
+	Effects.Remove(EventEffect);
+	EventEffect = Effects.Add(CurveIndex, KeyIndex, (KeyIndex == INDEX_NONE) ? LOGI_DEVICETYPE_ALL : LOGI_DEVICETYPE_PERKEY_RGB);
+
+	FLogiLedEffect* Effect = Effects.Find(EventEffect);
+
+	if (Effect == nullptr)
+	{
+		return;
+	}
+
+	Effect->Event = true;
+
+	if (KeyIndex == INDEX_NONE)
+	{
+		SetKeyPriorities();
+	}
+	else
+	{
+		KeyPriorities[KeyIndex] = Priority;
+	}
+
+	WakeUp();
+}
+
+
+FColor FLogiLedManager::Quantize(const FLogiLedEffect& Effect, FVector& Residual) const
+{
+	const FVector Exact(Effect.Exact.R, Effect.Exact.G, Effect.Exact.B);
+
+	// constant colors are rounded, so that settled keys don't keep flickering
+	if (Effect.ConstantUntil > Effect.Time)
+	{
+		Residual = FVector::ZeroVector;
+
+		return FColor((uint8)FMath::RoundToInt(Exact.X), (uint8)FMath::RoundToInt(Exact.Y), (uint8)FMath::RoundToInt(Exact.Z));
+	}
+
+	// first order error diffusion over time
+	const FVector Target = Exact + Residual;
+	const FVector Output(
+		FMath::Clamp(FMath::RoundToFloat(Target.X), 0.0f, 100.0f),
+		FMath::Clamp(FMath::RoundToFloat(Target.Y), 0.0f, 100.0f),
+		FMath::Clamp(FMath::RoundToFloat(Target.Z), 0.0f, 100.0f)
+	);
+
+	Residual = Target - Output;
+
+	return FColor((uint8)Output.X, (uint8)Output.Y, (uint8)Output.Z);
+}
+
+
+void FLogiLedManager::ResetResiduals()
+{
+	// different starting errors keep keys from stepping in sync
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		KeyResiduals[KeyIndex] = FVector(
+			FMath::Frac(KeyIndex * 0.618034f) - 0.5f,
+			FMath::Frac(KeyIndex * 0.618034f + 0.333333f) - 0.5f,
+			FMath::Frac(KeyIndex * 0.618034f + 0.666667f) - 0.5f
+		);
+	}
+
+	RgbResidual = FVector::ZeroVector;
+	MonochromeResidual = FVector::ZeroVector;
+}
+
+
+void FLogiLedManager::StartQueuedEvents()
+{
+	const ELogiLedPriority CommandPriority = Priority;
+
+	for (const FQueuedEvent& Event : QueuedEvents)
+	{
+		const ULogiLedEventMap* Map = Event.Map.Get();
+
+		if (Map == nullptr)
+		{
+			continue;
+		}
+
+		for (const ULogiLedEventMap::FAction& Action : Map->GetActions(Event.EventIndex))
+		{
+			// curve assets may have been deleted in the editor since the map was compiled
+			UCurveLinearColor* Curve = Action.Curve.Get();
+
+			if (Curve == nullptr)
+			{
+				continue;
+			}
+
+			// look up the curve once for all keys
+			const int32 CurveIndex = Effects.AcquireCurve(*Curve);
+
+			if (CurveIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			Priority = Action.Priority;
+
+			if (Action.NumKeys == 0)
+			{
+				PlayEventEffect(INDEX_NONE, CurveIndex);
+			}
+			else
+			{
+				for (uint8 KeyIndex : Map->GetKeys(Action))
+				{
+					PlayEventEffect(KeyIndex, CurveIndex);
+				}
+			}
+
+			Effects.ReleaseCurve(CurveIndex);
+		}
+
+		INC_DWORD_STAT(STAT_LogiLedEventsStarted);
+	}
+
+	// events do not change the settings of subsequent commands
+	Priority = CommandPriority;
+
+	QueuedEvents.Reset();
+}
+
+
+void FLogiLedManager::SetActive(bool Active)
+{
+	SetSuspended(Inactive, !Active);
+}
+
+
+void FLogiLedManager::SetBaseColor(int32 InTargetDevice, FColor Color)
+{
+	if ((InTargetDevice & LOGI_DEVICETYPE_PERKEY_RGB) != 0)
+	{
+		BaseFrame.Fill(Color);
+		SetKeyPriorities();
+
+		// single color devices follow the per-key frame again
+		if ((InTargetDevice & LOGI_DEVICETYPE_RGB) != 0)
+		{
+			HasExplicitRgbColor = false;
+		}
+
+		if ((InTargetDevice & LOGI_DEVICETYPE_MONOCHROME) != 0)
+		{
+			HasExplicitMonochromeColor = false;
+		}
+	}
+	else
+	{
+		if ((InTargetDevice & LOGI_DEVICETYPE_RGB) != 0)
+		{
+			ExplicitRgbColor = Color;
+			HasExplicitRgbColor = true;
+		}
+
+		if ((InTargetDevice & LOGI_DEVICETYPE_MONOCHROME) != 0)
+		{
+			ExplicitMonochromeColor = Color;
+			HasExplicitMonochromeColor = true;
+		}
+	}
+}
+
+
+bool FLogiLedManager::IsGamePaused() const
+{
+	if (GEngine == nullptr)
+	{
+		return false;
+	}
+
+	bool HasGameWorld = false;
+
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World = Context.World();
+
+		if ((World != nullptr) && World->IsGameWorld())
+		{
+			if (!World->IsPaused())
+			{
+				return false;
+			}
+
+			HasGameWorld = true;
+		}
+	}
+
+	return HasGameWorld;
+}
+
+
+void FLogiLedManager::SetKeyPriorities()
+{
+	for (ELogiLedPriority& KeyPriority : KeyPriorities)
+	{
+		KeyPriority = Priority;
+	}
+}
+
+
+void FLogiLedManager::SetSdkTargetDevice(int32 InTargetDevice)
+{
+	if (InTargetDevice == SdkTargetDevice)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_LogiLedTargetSwitches);
+
+	if (!::LogiLedSetTargetDevice(InTargetDevice))
+	{
+		static FLogiLedFailureCounter Failures(TEXT("FLogiLedManager::SetSdkTargetDevice"), true);
+		Failures.Add();
+	}
+
+	SdkTargetDevice = InTargetDevice;
+}
+
+
+void FLogiLedManager::SetSuspended(bool& Reason, bool Value)
+{
+	const bool WasSuspended = IsSuspended();
+
+	Reason = Value;
+
+	if (IsSuspended() == WasSuspended)
+	{
+		return;
+	}
+
+	if (WasSuspended)
+	{
+		UE_LOG(LogLogiLed, Verbose, TEXT("Resuming LED output"));
+
+		// other applications may have changed the lighting in the meantime
+		Invalidate();
+		WakeUp();
+	}
+	else
+	{
+		UE_LOG(LogLogiLed, Verbose, TEXT("Suspending LED output"));
+		Sleep();
+	}
+}
+
+
+void FLogiLedManager::Sleep()
+{
+	if (!Sleeping)
+	{
+		Sleeping = true;
+		SleepStartTime = FPlatformTime::Seconds();
+		SET_FLOAT_STAT(STAT_LogiLedIdlePercentage, GetIdlePercentage());
+	}
+}
+
+
+void FLogiLedManager::WakeUp()
+{
+	if (!Sleeping)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	if (StartTime == 0.0)
+	{
+		StartTime = Now;
+	}
+	else
+	{
+		IdleSeconds += Now - SleepStartTime;
+	}
+
+	Sleeping = false;
+	SET_FLOAT_STAT(STAT_LogiLedIdlePercentage, GetIdlePercentage());
+}
+
+
+/* FTickableGameObject interface
+ *****************************************************************************/
+
+TStatId FLogiLedManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FLogiLedManager, STATGROUP_Tickables);
+}
+
+
+bool FLogiLedManager::IsTickable() const
+{
+#if STATS
+	// this is polled every frame, even while the manager sleeps and doesn't tick
+	if (!Inactive)
+	{
+		SET_FLOAT_STAT(STAT_LogiLedIdlePercentage, GetIdlePercentage());
+	}
+#endif
+
+	if (IsSuspended())
+	{
+		// keep polling while paused, so that output resumes with the game
+		return Paused && !Backgrounded && !FocusLost;
+	}
+
+	return !Sleeping || FLogiLedSnapshot::Get().IsFrameRequested();
+}
+
+
+bool FLogiLedManager::IsTickableInEditor() const
+{
+	// lighting previews while scrubbing in Sequencer
+	return true;
+}
+
+
+void FLogiLedManager::Tick(float DeltaTime)
+{
+	SetSuspended(Paused, SuspendWhenPaused && IsGamePaused());
+
+	if (IsSuspended())
+	{
+		return;
+	}
+
+	if (QueuedEvents.Num() > 0)
+	{
+		StartQueuedEvents();
+	}
+
+	FLogiLedSnapshot& Snapshot = FLogiLedSnapshot::Get();
+	const bool Available = FLogiLedSdk::IsAvailable();
+
+	// nothing can be sent while the SDK is down, but viewers may still be watching
+	if (!Available && !Snapshot.HasViewers())
+	{
+		Sleep();
+		return;
+	}
+
+	const bool Settled = Compose(DeltaTime);
+	bool Flushed = true;
+
+	if (Available)
+	{
+		Flushed = Flush();
+	}
+
+	if (Snapshot.HasViewers())
+	{
+		Snapshot.Publish(PerKeyFrame.Colors);
+		FLogiLedSharedFrame::Get().Publish(PerKeyFrame.Colors);
+	}
+
+	// stop ticking until the next command
+	if (Settled && Flushed)
+	{
+		Sleep();
+	}
+	else
+	{
+		SET_FLOAT_STAT(STAT_LogiLedIdlePercentage, GetIdlePercentage());
+	}
+}
+
+
+/* FLogiLedManager callbacks
+ *****************************************************************************/
+
+void FLogiLedManager::HandleApplicationActivationStateChanged(const bool IsActive)
+{
+	SetSuspended(FocusLost, !IsActive);
+}
+
+
+void FLogiLedManager::HandleApplicationHasEnteredForeground()
+{
+	SetSuspended(Backgrounded, false);
+}
+
+
+void FLogiLedManager::HandleApplicationWillEnterBackground()
+{
+	SetSuspended(Backgrounded, true);
+}
+
+
+void FLogiLedManager::HandlePostEngineInit()
+{
+	// Slate is not available in commandlets and dedicated servers
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnApplicationActivationStateChanged().AddRaw(this, &FLogiLedManager::HandleApplicationActivationStateChanged);
+	}
+}
+
+
+void FLogiLedManager::HandleSdkConnected()
+{
+	// execute commands that were issued while connecting
+	TArray<TFunction<void()>> Commands = MoveTemp(DeferredCommands);
+
+	for (const auto& Command : Commands)
+	{
+		Command();
+	}
+
+	// replay the current lighting
+	Invalidate();
+	WakeUp();
+}
+
+
+#if WITH_EDITOR
+
+void FLogiLedManager::HandleEditorEndPIE(bool bIsSimulating)
+{
+	// the PIE instances' lighting ends with their worlds
+	for (auto It = LogiLedManagers::Managers.CreateIterator(); It; ++It)
+	{
+		if (It.Key() != INDEX_NONE)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	LogiLedManagers::LastManager = nullptr;
+	LogiLedManagers::LastInstance = INDEX_NONE;
+
+	if (FLogiLedSdk::IsAvailable())
+	{
+		::LogiLedSetTargetDevice(LOGI_DEVICETYPE_ALL);
+		::LogiLedStopEffects();
+	}
+
+	// the editor's manager takes over, and resends its lighting
+	LogiLedManagers::UpdateActive();
 }
 
 #endif
@@ -2,26 +2,113 @@
 
 #pragma once
 
+#include "Containers/Array.h"
 #include "Containers/Map.h"
-#include "Templates/SharedPointer.h"
-#include "Tickable.h"
+#include "Math/Color.h"
+#include "Templates/Function.h"
+#include "UObject/NameTypes.h"
 #include "UObject/WeakObjectPtr.h"
+#include "Tickable.h"
 
+#include "LogiLedEffectPool.h"
+#include "LogiLedEffectProgram.h"
+#include "LogiLedFrame.h"
+#include "LogiLedTypes.h"
 #include "LogitechLEDLib.h"
 
 class UCurveLinearColor;
+class ULogiLedEffectGraph;
+class ULogiLedEventMap;
+
+
+/**
+ * Enumerates the sources that can override keys, in ascending priority.
+ */
+enum class ELogiLedOverrideLayer : uint8
+{
+	/** Keys driven by Sequencer tracks. */
+	Sequencer,
+
+	/** Keys received from another process' mirror. */
+	Mirror,
+
+	/** Number of layers. */
+	Count
+};
 
 
 /**
  * Manages Logitech LED state and timing.
+ *
+ * The manager composes lighting commands and animations into one output state
+ * per device class: a per-key frame for per-key RGB keyboards, and a single
+ * color each for RGB and monochrome devices, which is derived from the per-key
+ * frame unless it was set explicitly. Once per tick, the output states that
+ * changed are flushed to the SDK, grouped by target device so that as few
+ * target switches as possible are needed.
+ *
+ * Gameplay events play on a layer of their own, on top of static lighting and
+ * animations, so that the keys return to their previous lighting when an
+ * event ends.
+ *
+ * Keys can also be overridden by external sources, such as Sequencer tracks
+ * or a mirror, which take precedence over commands and animations. Each source
+ * has its own override layer, and layers of higher priority take precedence.
+ *
+ * Output is suspended while the application is in the background or the game
+ * is paused, because other applications take over the lighting then, and the
+ * lighting is resent when output resumes.
+ *
+ * The composed lighting can be saved in named snapshots, which are kept on a
+ * stack for nested states, such as menus, and restored without SDK calls.
+ *
+ * Managers are created on first use, so that games that never use LEDs do not
+ * pay for them. In the editor, each PIE instance has its own manager, so that
+ * the clients of multi-client PIE sessions do not share one lighting state.
+ * Only one manager is active at a time: the one of the first PIE instance
+ * while PIE is running, otherwise the editor's. Inactive managers keep their
+ * state, but do not tick or send anything.
+ *
+ * Once all animations have settled on a constant value and the output has been
+ * flushed, the manager stops ticking until the next command arrives.
  */
 class FLogiLedManager
 	: public FTickableGameObject
 {
-	struct FAnimation
+	/** Running estimate of how long an SDK call takes. */
+	struct FCallCost
 	{
-		TWeakObjectPtr<UCurveLinearColor> Curve;
-		float Time;
+		double Seconds;
+
+		explicit FCallCost(double InitialSeconds)
+			: Seconds(InitialSeconds)
+		{ }
+
+		void Add(double TotalSeconds, int32 NumCalls)
+		{
+			if (NumCalls > 0)
+			{
+				Seconds += (TotalSeconds / NumCalls - Seconds) * 0.1;
+			}
+		}
+
+		double Get() const
+		{
+			return Seconds;
+		}
+	};
+
+	/** Ways of sending the per-key frame to the SDK. */
+	enum class EFlushStrategy
+	{
+		/** One LogiLedSetLighting call for all keys. */
+		Global,
+
+		/** One LogiLedSetLightingFromBitmap call, plus individual calls for keys outside the bitmap. */
+		Bitmap,
+
+		/** One LogiLedSetLightingForKeyWithKeyName call per changed key. */
+		PerKey
 	};
 
 public:
@@ -35,36 +122,358 @@ public:
 public:
 
 	/**
-	 * Play a color curve animation on all keys.
+	 * Remove the key overrides of a layer from all managers.
+	 *
+	 * @param Layer The layer to clear.
+	 * @see ClearOverrideFrame
+	 */
+	static void ClearAllOverrideFrames(ELogiLedOverrideLayer Layer);
+
+	/**
+	 * Destroy all managers.
+	 *
+	 * Must be called before the module is unloaded.
+	 *
+	 * @see Get
+	 */
+	static void DestroyAll();
+
+	/**
+	 * Get the manager of the current PIE instance, or the global manager outside of PIE.
+	 *
+	 * Creates the manager and starts connecting to the SDK on first use.
+	 *
+	 * @return The manager.
+	 * @see DestroyAll, GetActive
+	 */
+	static FLogiLedManager& Get();
+
+	/**
+	 * Get the manager that currently sends its lighting to the devices.
+	 *
+	 * Sources that do not belong to a world, such as tickable objects, must
+	 * use this instead of Get, because they run outside of PIE instances.
+	 * Creates the manager of the current PIE instance, or the global manager,
+	 * if no manager exists yet.
+	 *
+	 * @return The active manager.
+	 * @see Get
+	 */
+	static FLogiLedManager& GetActive();
+
+public:
+
+	/**
+	 * Set the SDK's target device to the manager's current target device.
+	 *
+	 * Must be called before making SDK calls that depend on the target device
+	 * outside of the manager, because the manager switches targets when flushing.
+	 *
+	 * @see SetTargetDevice
+	 */
+	void ApplyTargetDevice();
+
+	/**
+	 * Bind a meter to a sequence of keys.
+	 *
+	 * The meter's key colors are computed once here. Its keys are only updated
+	 * when a new value crosses a step that changes at least one key.
+	 *
+	 * @param Name The meter's name (replaces any meter with the same name).
+	 * @param Meter The meter's keys and colors.
+	 * @see SetMeterValue, UnbindMeter
+	 */
+	void BindMeter(FName Name, const FLogiLedMeter& Meter);
+
+	/**
+	 * Defer an SDK command until the SDK has been connected.
+	 *
+	 * Commands are only deferred while the SDK is connecting. They are executed
+	 * in order once the connection succeeds, before the current lighting is
+	 * replayed. Commands issued while the SDK is disconnected are dropped.
+	 *
+	 * @param Command The command to defer.
+	 */
+	void DeferCommand(TFunction<void()>&& Command);
+
+	/**
+	 * Set the keys that are not affected by bitmap updates.
+	 *
+	 * @param Keys The keys to exclude.
+	 */
+	void ExcludeKeysFromBitmap(const TArray<ELogiLedKeys>& Keys);
+
+	/**
+	 * Get the percentage of time the manager spent idle.
+	 *
+	 * @return Idle time percentage since the first command was received.
+	 */
+	float GetIdlePercentage() const;
+
+	/**
+	 * Remove all key overrides of a layer.
+	 *
+	 * @param Layer The layer to clear.
+	 * @see SetOverrideFrame
+	 */
+	void ClearOverrideFrame(ELogiLedOverrideLayer Layer);
+
+	/**
+	 * Notify the manager that lighting was changed outside of it.
+	 *
+	 * All output will be sent again on the next flush.
+	 */
+	void Invalidate();
+
+	/**
+	 * Play a color curve animation on all keys of the target device(s).
+	 *
+	 * Replaces the previous animation on all keys.
 	 *
 	 * @param ColorCurve The color curve.
-	 * @see StopAnimations
+	 * @return Handle to the animation, or an invalid handle if it could not be played.
+	 * @see SetAnimationTime, SetTargetDevice, StopAnimation, StopAnimations
 	 */
-	void PlayAnimation(UCurveLinearColor* ColorCurve);
+	FLogiLedEffectHandle PlayAnimation(UCurveLinearColor* ColorCurve);
 
 	/**
 	 * Play a color curve animation on the specified key.
 	 *
-	 * @param KeyName The key to play the animation on.
+	 * Replaces the previous animation on the key.
+	 *
+	 * @param Key The key to play the animation on.
 	 * @param ColorCurve The color curve.
-	 * @see StopAnimations
+	 * @return Handle to the animation, or an invalid handle if it could not be played.
+	 * @see SetAnimationTime, StopAnimation, StopAnimations
+	 */
+	FLogiLedEffectHandle PlayAnimation(ELogiLedKeys Key, UCurveLinearColor* ColorCurve);
+
+	/**
+	 * Play an effect graph on all per-key devices.
+	 *
+	 * Replaces the previous effect graph. The graph's output replaces the
+	 * static lighting and the global animation, and key animations play on
+	 * top of it.
+	 *
+	 * @param Graph The effect graph.
+	 * @return true if the graph was compiled and is playing, false otherwise.
+	 * @see SetEffectParameter, StopEffectGraph
+	 */
+	bool PlayEffectGraph(const ULogiLedEffectGraph& Graph);
+
+	/**
+	 * Queue a gameplay event.
+	 *
+	 * Queued events are started on the next tick, in order. An event that is
+	 * queued more than once per tick is only started once. Events are dropped
+	 * while output is suspended. Events play on top of animations, and only
+	 * replace earlier events on the same keys.
+	 *
+	 * @param Map The event map.
+	 * @param EventIndex The event's index in the map's dispatch table.
+	 * @see ULogiLedEventMap::FireEvent
+	 */
+	void QueueEvent(const ULogiLedEventMap& Map, int32 EventIndex);
+
+	/**
+	 * Move a playing animation to the given time.
+	 *
+	 * @param Handle The animation's handle.
+	 * @param Time The curve time to move to.
+	 * @return true if the animation is playing, false otherwise.
+	 * @see PlayAnimation
+	 */
+	bool SetAnimationTime(FLogiLedEffectHandle Handle, float Time);
+
+	/**
+	 * Restore lighting from a snapshot.
+	 *
+	 * The restored keys become the static lighting, and their animations are
+	 * stopped. If all keys are restored, the global animation is stopped, too.
+	 *
+	 * @param Name The name of the snapshot.
+	 * @param FadeSeconds Time over which to cross-fade from the current lighting (0 = instantly).
+	 * @param Discard Whether to remove the snapshot and all snapshots saved after it.
+	 * @param Keys The keys to restore, or nullptr for all keys in the snapshot.
+	 * @return true if the snapshot was found, false otherwise.
+	 * @see SaveLighting
+	 */
+	bool RestoreLighting(FName Name, float FadeSeconds, bool Discard, const TArray<ELogiLedKeys>* Keys = nullptr);
+
+	/**
+	 * Save the current lighting in a snapshot.
+	 *
+	 * The snapshot captures the lighting as composed on the last tick. If a
+	 * snapshot with the same name exists, the given keys are saved into it;
+	 * otherwise a new snapshot is put on top of the stack.
+	 *
+	 * @param Name The name of the snapshot.
+	 * @param Keys The keys to save, or nullptr to replace the snapshot with all keys.
+	 * @see RestoreLighting
+	 */
+	void SaveLighting(FName Name, const TArray<ELogiLedKeys>* Keys = nullptr);
+
+	/**
+	 * Set the SDK time budget per flush.
+	 *
+	 * When the estimated cost of sending all changes exceeds the budget, changed
+	 * keys are sent in priority order until the budget is used up, and the rest
+	 * are deferred to the next flush. Deferred keys gain priority with every
+	 * flush they wait, so that low priority keys are never starved.
+	 *
+	 * @param Seconds The budget (0 = unlimited).
+	 * @see SetPriority
+	 */
+	void SetBudget(double Seconds);
+
+	/**
+	 * Enable or disable temporal dithering of animations.
+	 *
+	 * The SDK only accepts integer percentages, so slow or dim fades visibly
+	 * step. With dithering, keys whose animated color is changing alternate
+	 * between the neighboring percentages, so that their average over time
+	 * matches the curve. Keys with constant colors are not dithered.
+	 *
+	 * @param Enabled Whether to dither.
+	 */
+	void SetDithering(bool Enabled);
+
+	/**
+	 * Set the value of a gameplay parameter of effect graphs.
+	 *
+	 * Values are kept when effect graphs change.
+	 *
+	 * @param Name The parameter's name.
+	 * @param Value The value to set.
+	 * @see PlayEffectGraph
+	 */
+	void SetEffectParameter(FName Name, float Value);
+
+	/**
+	 * Set the lighting on the target device(s).
+	 *
+	 * @param Color The color to set.
+	 * @see SetLightingForKey, SetTargetDevice
+	 */
+	void SetLighting(const FLinearColor& Color);
+
+	/**
+	 * Set the lighting of all keys from a bitmap.
+	 *
+	 * Keys that are not in the bitmap or that are excluded from bitmap updates
+	 * keep their lighting.
+	 *
+	 * @param Pixels The LOGI_LED_BITMAP_WIDTH x LOGI_LED_BITMAP_HEIGHT colors of the bitmap.
+	 * @see ExcludeKeysFromBitmap
+	 */
+	void SetLightingFromBitmap(const FColor* Pixels);
+
+	/**
+	 * Set the lighting on the specified key.
+	 *
+	 * @param Key The key to set the lighting on.
+	 * @param Color The color to set.
+	 * @see SetLighting
+	 */
+	void SetLightingForKey(ELogiLedKeys Key, const FLinearColor& Color);
+
+	/**
+	 * Set the value that a meter shows.
+	 *
+	 * This is cheap if the value stays within the current step, so it can be
+	 * called every tick.
+	 *
+	 * @param Name The meter's name.
+	 * @param Value The value to show (0 = empty, 1 = full).
+	 * @return true if any of the meter's keys changed, false otherwise.
+	 * @see BindMeter
+	 */
+	bool SetMeterValue(FName Name, float Value);
+
+	/**
+	 * Override the lighting of individual keys.
+	 *
+	 * Keys whose color has a non-zero alpha value override static lighting,
+	 * animations and layers of lower priority until the layer's overrides are
+	 * changed or cleared. Nothing is sent to the SDK if the overrides did not
+	 * change.
+	 *
+	 * @param Layer The layer that the overrides belong to.
+	 * @param Frame The percentage colors of overridden keys.
+	 * @see ClearOverrideFrame
+	 */
+	void SetOverrideFrame(ELogiLedOverrideLayer Layer, const FLogiLedFrame& Frame);
+
+	/**
+	 * Set the priority of subsequent commands.
+	 *
+	 * Keys take the priority of the last command that changed them.
+	 *
+	 * @param InPriority The priority.
+	 * @see SetBudget
+	 */
+	void SetPriority(ELogiLedPriority InPriority);
+
+	/**
+	 * Set whether output is suspended while the game is paused.
+	 *
+	 * Output is always suspended while the application is in the background.
+	 *
+	 * @param Suspend Whether to suspend output while paused (default = true).
+	 */
+	void SetSuspendWhenPaused(bool Suspend);
+
+	/**
+	 * Set the target device type(s) for subsequent commands.
+	 *
+	 * @param InTargetDevice Combination of LOGI_DEVICETYPE_* flags.
+	 * @see ApplyTargetDevice
+	 */
+	void SetTargetDevice(int32 InTargetDevice);
+
+	/**
+	 * Stop a color curve animation.
+	 *
+	 * The keys keep the animation's last color.
+	 *
+	 * @param Handle The animation's handle.
+	 * @see PlayAnimation
 	 */
-	void PlayAnimation(LogiLed::KeyName KeyName, UCurveLinearColor* ColorCurve);
+	void StopAnimation(FLogiLedEffectHandle Handle);
 
 	/**
-	 * Stop color curve animations on all keys.
+	 * Stop color curve animations on all keys, including the effects of gameplay events.
 	 *
 	 * @see PlayAnimation
 	 */
 	void StopAnimations();
 
 	/**
-	 * Stop color curve animation on the specified key.
+	 * Stop color curve animation on the specified key, including the effect of a gameplay event.
 	 *
-	 * @param KeyName The name of the key to stop the animation on.
+	 * @param Key The key to stop the animation on.
 	 * @see PlayAnimation
 	 */
-	void StopAnimations(LogiLed::KeyName KeyName);
+	void StopAnimations(ELogiLedKeys Key);
+
+	/**
+	 * Stop the effect graph.
+	 *
+	 * The keys return to the static lighting.
+	 *
+	 * @see PlayEffectGraph
+	 */
+	void StopEffectGraph();
+
+	/**
+	 * Remove a meter.
+	 *
+	 * The meter's keys keep their lighting.
+	 *
+	 * @param Name The meter's name.
+	 * @see BindMeter
+	 */
+	void UnbindMeter(FName Name);
 
 public:
 
@@ -72,22 +481,375 @@ public:
 
 	virtual TStatId GetStatId() const override;
 	virtual bool IsTickable() const override;
+	virtual bool IsTickableInEditor() const override;
 	virtual void Tick(float DeltaTime) override;
 
-#if WITH_EDITOR
+protected:
+
+	/**
+	 * Compose the output states from static lighting and animations.
+	 *
+	 * @param DeltaTime Time since the last tick.
+	 * @return true if all animations have settled on a constant value, false otherwise.
+	 */
+	bool Compose(float DeltaTime);
+
+	/**
+	 * Make an animation's last color the static lighting of its keys.
+	 *
+	 * @param Effect The animation.
+	 */
+	void BakeAnimation(const FLogiLedEffect& Effect);
+
+	/**
+	 * Send all output states that changed since the last flush to the SDK.
+	 *
+	 * @return true if all changes were sent, false if keys were deferred.
+	 */
+	bool Flush();
+
+	/**
+	 * Send the per-key frame to the SDK using the planned strategy.
+	 *
+	 * @param Budget The remaining SDK time budget (in seconds).
+	 * @return Number of changed keys that were deferred.
+	 */
+	int32 FlushPerKeyFrame(double Budget);
+
+	/**
+	 * Get how urgently a changed key needs to be sent.
+	 *
+	 * @param KeyIndex Index of the key.
+	 * @return Urgency, based on the key's priority and the number of flushes it was deferred.
+	 */
+	int32 GetUrgency(int32 KeyIndex) const;
+
+	/**
+	 * Check whether the given key is updated by bitmap uploads.
+	 *
+	 * @param KeyIndex Index of the key to check.
+	 * @return true if the key is in the bitmap and not excluded, false otherwise.
+	 */
+	bool IsInBitmap(int32 KeyIndex) const;
+
+	/**
+	 * Choose the cheapest strategy for sending the changes in the per-key frame.
+	 *
+	 * The estimate is based on the number of changed keys and on SDK call
+	 * latencies that are measured while flushing.
+	 *
+	 * @return The planned strategy.
+	 */
+	EFlushStrategy PlanPerKeyFlush();
+
+	/**
+	 * Play an animation on a single key, replacing the key's current animation.
+	 *
+	 * @param Key The key to play on.
+	 * @param CurveIndex Index of the curve copy in the effect pool, or INDEX_NONE to only stop the current animation.
+	 * @return Handle to the new animation, or an invalid handle if it was not started.
+	 * @see FLogiLedEffectPool::AcquireCurve, PlayAnimation
+	 */
+	FLogiLedEffectHandle PlayKeyEffect(ELogiLedKeys Key, int32 CurveIndex);
+
+	/**
+	 * Play the curve of a gameplay event on top of other animations, replacing the previous event on the same keys.
+	 *
+	 * @param KeyIndex The key to play on, or INDEX_NONE for all keys of all devices.
+	 * @param CurveIndex Index of the curve copy in the effect pool.
+	 * @see FLogiLedEffectPool::AcquireCurve, StartQueuedEvents
+	 */
+	void PlayEventEffect(int32 KeyIndex, int32 CurveIndex);
+
+	/**
+	 * Quantize an animation's color to percentages.
+	 *
+	 * @param Effect The animation.
+	 * @param Residual The quantization error carried over from previous frames.
+	 * @return Percentage color.
+	 */
+	FColor Quantize(const FLogiLedEffect& Effect, FVector& Residual) const;
+
+	/** Reset the dithering residuals to their initial pattern. */
+	void ResetResiduals();
+
+	/** Start the actions of all queued gameplay events. */
+	void StartQueuedEvents();
+
+	/**
+	 * Check whether all game worlds are paused.
+	 *
+	 * @return true if there is at least one game world and all are paused, false otherwise.
+	 */
+	bool IsGamePaused() const;
+
+	/**
+	 * Check whether output is suspended.
+	 *
+	 * @return true if suspended, false otherwise.
+	 */
+	bool IsSuspended() const
+	{
+		return Backgrounded || FocusLost || Inactive || Paused;
+	}
+
+	/**
+	 * Activate or deactivate the manager.
+	 *
+	 * Inactive managers do not tick or send anything. When activated, the
+	 * current lighting is resent.
+	 *
+	 * @param Active Whether the manager is active.
+	 * @see Get
+	 */
+	void SetActive(bool Active);
+
+	/**
+	 * Set the static lighting of the given device type(s).
+	 *
+	 * @param InTargetDevice Combination of LOGI_DEVICETYPE_* flags.
+	 * @param Color The percentage color to set.
+	 */
+	void SetBaseColor(int32 InTargetDevice, FColor Color);
+
+	/**
+	 * Set the priority of all keys to the current priority.
+	 *
+	 * @see SetPriority
+	 */
+	void SetKeyPriorities();
+
+	/**
+	 * Set the SDK's target device if it is not set already.
+	 *
+	 * @param InTargetDevice Combination of LOGI_DEVICETYPE_* flags.
+	 */
+	void SetSdkTargetDevice(int32 InTargetDevice);
+
+	/**
+	 * Set one of the reasons for suspending output.
+	 *
+	 * When output resumes, the current lighting is resent.
+	 *
+	 * @param Reason The reason to set (Backgrounded, FocusLost, Inactive or Paused).
+	 * @param Value Whether the reason applies.
+	 */
+	void SetSuspended(bool& Reason, bool Value);
+
+	/** Put the manager to sleep until the next command arrives. */
+	void Sleep();
+
+	/** Wake the manager up after it went to sleep. */
+	void WakeUp();
 
 private:
 
+	/** Callback for when the application's activation state changed. */
+	void HandleApplicationActivationStateChanged(const bool IsActive);
+
+	/** Callback for when the application has entered the foreground. */
+	void HandleApplicationHasEnteredForeground();
+
+	/** Callback for when the application will enter the background. */
+	void HandleApplicationWillEnterBackground();
+
+	/** Callback for when the engine has been initialized. */
+	void HandlePostEngineInit();
+
+	/** Callback for when the SDK has been (re-)connected. */
+	void HandleSdkConnected();
+
+#if WITH_EDITOR
+
 	/** Callback for when PIE or SIE ends. */
-	void HandleEditorEndPIE(bool bIsSimulating);
+	static void HandleEditorEndPIE(bool bIsSimulating);
 
 #endif
 
 private:
 
-	/** Color animation for all keys. */
-	FAnimation Animation;
+	/** Playing color animations. */
+	FLogiLedEffectPool Effects;
+
+	/** The color animation for all keys. */
+	FLogiLedEffectHandle GlobalEffect;
+
+	/** The color animation for each key. */
+	FLogiLedEffectHandle KeyEffects[LogiLedKeys::Count];
+
+	/** The gameplay event effect for all keys, which plays on top of other animations. */
+	FLogiLedEffectHandle EventGlobalEffect;
+
+	/** The gameplay event effect for each key, which plays on top of other animations. */
+	FLogiLedEffectHandle EventKeyEffects[LogiLedKeys::Count];
+
+	/** The playing effect graph (empty if none). */
+	FLogiLedEffectProgram EffectProgram;
+
+	/** Current time of the effect graph (in seconds). */
+	float EffectTime;
+
+	/** Values of effect graph parameters. */
+	TMap<FName, float> EffectParameters;
+
+	/** A bound meter. */
+	struct FBoundMeter
+	{
+		/** The meter's keys, from empty to full. */
+		TArray<int32> KeyIndices;
+
+		/** Colors of the fully lit keys. */
+		TArray<FLinearColor> FullColors;
+
+		/** Color of unlit keys. */
+		FLinearColor EmptyColor;
+
+		/** Number of brightness steps per key. */
+		int32 StepsPerKey;
+
+		/** Number of currently lit steps (INDEX_NONE if no value was set yet). */
+		int32 Level;
+	};
+
+	/** Bound meters by name. */
+	TMap<FName, FBoundMeter> Meters;
+
+	/** A queued gameplay event. */
+	struct FQueuedEvent
+	{
+		/** The event map. */
+		TWeakObjectPtr<const ULogiLedEventMap> Map;
+
+		/** The event's index in the map's dispatch table. */
+		int32 EventIndex;
+	};
+
+	/** Gameplay events to start on the next tick. */
+	TArray<FQueuedEvent> QueuedEvents;
+
+	/** Static per-key lighting set by commands. */
+	FLogiLedFrame BaseFrame;
+
+	/** Key overrides by layer (only keys with non-zero alpha are overridden). */
+	FLogiLedFrame OverrideFrames[(int32)ELogiLedOverrideLayer::Count];
+
+	/** Whether any keys are overridden, by layer. */
+	bool HasOverrides[(int32)ELogiLedOverrideLayer::Count];
+
+	/** Explicitly set colors for RGB and monochrome devices (only valid if the corresponding flag is set). */
+	FColor ExplicitRgbColor;
+	FColor ExplicitMonochromeColor;
+	bool HasExplicitRgbColor;
+	bool HasExplicitMonochromeColor;
+
+	/** The composed output state for each device class. */
+	FLogiLedFrame PerKeyFrame;
+	FColor RgbColor;
+	FColor MonochromeColor;
+
+	/** The output state for each device class at the time of the last flush. */
+	FLogiLedFrame FlushedPerKeyFrame;
+	FColor FlushedRgbColor;
+	FColor FlushedMonochromeColor;
+
+	/** Whether the flushed output states are valid (false = resend everything). */
+	bool FlushedValid;
+
+	/** Keys that are not affected by bitmap updates. */
+	bool ExcludedFromBitmap[LogiLedKeys::Count];
+
+	/** Measured SDK call latencies. */
+	FCallCost BitmapCallCost;
+	FCallCost LightingCallCost;
+	FCallCost PerKeyCallCost;
+
+	/** The strategy chosen for the current per-key flush. */
+	EFlushStrategy PlannedStrategy;
+
+	/** SDK time budget per flush (in seconds, 0 = unlimited). */
+	double Budget;
+
+	/** The priority for commands. */
+	ELogiLedPriority Priority;
+
+	/** Priority of the last command that changed each key. */
+	ELogiLedPriority KeyPriorities[LogiLedKeys::Count];
+
+	/** Number of flushes each changed key has been deferred. */
+	int32 KeyAges[LogiLedKeys::Count];
+
+	/** A saved lighting state. */
+	struct FSavedLighting
+	{
+		/** The snapshot's name. */
+		FName Name;
+
+		/** The composed per-key frame. */
+		FLogiLedFrame Frame;
+
+		/** Which keys were saved. */
+		bool SavedKeys[LogiLedKeys::Count];
+
+		/** The composed colors of RGB and monochrome devices (only valid if all keys were saved). */
+		FColor RgbColor;
+		FColor MonochromeColor;
+		bool SavedSingleColors;
+	};
+
+	/** Saved lighting states, most recent last. */
+	TArray<FSavedLighting> SavedLightings;
+
+	/** The per-key frame at the start of a cross-fade. */
+	FLogiLedFrame FadeFrame;
+
+	/** Keys that are cross-fading. */
+	bool FadingKeys[LogiLedKeys::Count];
+
+	/** Duration and elapsed time of the current cross-fade (in seconds). */
+	float FadeDuration;
+	float FadeTime;
+
+	/** Whether animations are dithered. */
+	bool Dithering;
+
+	/** Dithering quantization errors of each key and of RGB and monochrome devices. */
+	FVector KeyResiduals[LogiLedKeys::Count];
+	FVector RgbResidual;
+	FVector MonochromeResidual;
+
+	/** The target device type(s) for commands. */
+	int32 TargetDevice;
+
+	/** The target device type(s) that were last set on the SDK (0 = unknown). */
+	int32 SdkTargetDevice;
+
+	/** SDK commands issued while the SDK was connecting. */
+	TArray<TFunction<void()>> DeferredCommands;
+
+	/** Whether the manager is sleeping. */
+	bool Sleeping;
+
+	/** Whether output is suspended because the application is in the background. */
+	bool Backgrounded;
+
+	/** Whether output is suspended because the application lost focus. */
+	bool FocusLost;
+
+	/** Whether output is suspended because another manager is active. */
+	bool Inactive;
+
+	/** Whether output is suspended because the game is paused. */
+	bool Paused;
+
+	/** Whether to suspend output while the game is paused. */
+	bool SuspendWhenPaused;
+
+	/** Total time spent sleeping (in seconds). */
+	double IdleSeconds;
+
+	/** Time at which the manager went to sleep. */
+	double SleepStartTime;
 
-	/** Color animation for specific keys. */
-	TMap<LogiLed::KeyName, FAnimation> KeyAnimations;
+	/** Time at which the manager received its first command (0 = never). */
+	double StartTime;
 };
@@ -0,0 +1,132 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedMaterialComponent.h"
+#include "LogiLedBlueprintLibrary.h"
+#include "LogiLedReadback.h"
+
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/World.h"
+#include "Kismet/KismetRenderingLibrary.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/App.h"
+
+#include "LogitechLEDLib.h"
+
+
+/* ULogiLedMaterialComponent structors
+ *****************************************************************************/
+
+ULogiLedMaterialComponent::ULogiLedMaterialComponent()
+	: Material(nullptr)
+	, UpdatesPerSecond(30.0f)
+	, RenderTarget(nullptr)
+	, TimeUntilUpdate(0.0f)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+
+/* ULogiLedMaterialComponent interface
+ *****************************************************************************/
+
+void ULogiLedMaterialComponent::SetCpuFunction(FCpuFunction&& InCpuFunction)
+{
+	CpuFunction = MoveTemp(InCpuFunction);
+}
+
+
+/* UActorComponent interface
+ *****************************************************************************/
+
+void ULogiLedMaterialComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (FApp::CanEverRender() && (RenderTarget == nullptr))
+	{
+		RenderTarget = NewObject<UTextureRenderTarget2D>(this);
+		{
+			RenderTarget->ClearColor = FLinearColor::Black;
+			RenderTarget->InitCustomFormat(LOGI_LED_BITMAP_WIDTH, LOGI_LED_BITMAP_HEIGHT, PF_B8G8R8A8, true);
+		}
+
+		Readback = MakeShareable(new FLogiLedReadback());
+	}
+
+	TimeUntilUpdate = 0.0f;
+}
+
+
+void ULogiLedMaterialComponent::OnUnregister()
+{
+	if (Readback.IsValid())
+	{
+		Readback->ReleaseResources();
+		Readback.Reset();
+	}
+
+	RenderTarget = nullptr;
+
+	Super::OnUnregister();
+}
+
+
+void ULogiLedMaterialComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// pick up pixels that were read back since the last tick
+	if (Readback.IsValid() && Readback->GetResult(Pixels))
+	{
+		ULogiLedBlueprintLibrary::GetManager().SetLightingFromBitmap(Pixels.GetData());
+	}
+
+	TimeUntilUpdate -= DeltaTime;
+
+	if (TimeUntilUpdate > 0.0f)
+	{
+		return;
+	}
+
+	TimeUntilUpdate = FMath::Max(TimeUntilUpdate + 1.0f / FMath::Max(UpdatesPerSecond, 1.0f), 0.0f);
+
+	if ((Material != nullptr) && (RenderTarget != nullptr))
+	{
+		RenderMaterial();
+	}
+	else if (CpuFunction)
+	{
+		RunCpuFunction();
+	}
+}
+
+
+/* ULogiLedMaterialComponent implementation
+ *****************************************************************************/
+
+void ULogiLedMaterialComponent::RenderMaterial()
+{
+	UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, RenderTarget, Material);
+	Readback->Request(RenderTarget->GameThread_GetRenderTargetResource());
+}
+
+
+void ULogiLedMaterialComponent::RunCpuFunction()
+{
+	const UWorld* World = GetWorld();
+	const float Time = (World != nullptr) ? World->GetTimeSeconds() : 0.0f;
+
+	Pixels.SetNumUninitialized(LOGI_LED_BITMAP_WIDTH * LOGI_LED_BITMAP_HEIGHT, false);
+
+	// sample pixel centers, like the material does
+	for (int32 Y = 0; Y < LOGI_LED_BITMAP_HEIGHT; ++Y)
+	{
+		for (int32 X = 0; X < LOGI_LED_BITMAP_WIDTH; ++X)
+		{
+			const FVector2D UV((X + 0.5f) / LOGI_LED_BITMAP_WIDTH, (Y + 0.5f) / LOGI_LED_BITMAP_HEIGHT);
+			Pixels[Y * LOGI_LED_BITMAP_WIDTH + X] = CpuFunction(UV, Time).ToFColor(false);
+		}
+	}
+
+	ULogiLedBlueprintLibrary::GetManager().SetLightingFromBitmap(Pixels.GetData());
+}
@@ -0,0 +1,437 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedMirror.h"
+#include "LogiLedKeys.h"
+#include "LogiLedManager.h"
+#include "LogiLedPrivate.h"
+
+#include "Common/UdpSocketBuilder.h"
+#include "IPAddress.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Mirror Bytes Per Second"), STAT_LogiLedMirrorBytesPerSecond, STATGROUP_LogiLed);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mirror Packets"), STAT_LogiLedMirrorPackets, STATGROUP_LogiLed);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Mirror Dropped Packets"), STAT_LogiLedMirrorDroppedPackets, STATGROUP_LogiLed);
+
+
+/** Packet header values. */
+static const uint8 LogiLedMirrorMagic = 0x4c;
+static const uint8 LogiLedMirrorVersion = 1;
+static const uint8 LogiLedMirrorKeyframeFlag = 0x1;
+
+/** Number of distinct values per color channel (percentages fit into 7 bits). */
+static const uint32 LogiLedMirrorChannelValues = 128;
+
+/** Default bandwidth cap (in bytes per second). */
+static const int32 LogiLedMirrorDefaultMaxBytesPerSecond = 8 * 1024;
+
+/** Lowest bandwidth cap, which still allows for one keyframe per second (in bytes per second). */
+static const int32 LogiLedMirrorMinMaxBytesPerSecond = 512;
+
+/** Interval between keyframes (in seconds). */
+static const float LogiLedMirrorKeyframeInterval = 1.0f;
+
+/** Interval between packets (in seconds). */
+static const float LogiLedMirrorSendInterval = 1.0f / 60.0f;
+
+/** Size of the socket buffers (in bytes). */
+static const int32 LogiLedMirrorBufferSize = 64 * 1024;
+
+
+/* FLogiLedMirror structors
+ *****************************************************************************/
+
+FLogiLedMirror::FLogiLedMirror()
+	: Mode(EMode::None)
+	, Socket(nullptr)
+	, MirroredValid(false)
+	, Sequence(0)
+	, MaxBytesPerSecond(LogiLedMirrorDefaultMaxBytesPerSecond)
+	, ByteBudget(0.0f)
+	, TimeUntilSend(0.0f)
+	, TimeUntilKeyframe(0.0f)
+	, WindowBytes(0)
+	, WindowSeconds(0.0f)
+	, BytesPerSecond(0.0f)
+{
+	FMemory::Memzero(Colors);
+}
+
+
+FLogiLedMirror::~FLogiLedMirror()
+{
+	// the socket is closed by Stop, see ULogiLedBlueprintLibrary::DestroyAll
+}
+
+
+/* FLogiLedMirror interface
+ *****************************************************************************/
+
+void FLogiLedMirror::SetMaxBytesPerSecond(int32 InMaxBytesPerSecond)
+{
+	MaxBytesPerSecond = FMath::Max(InMaxBytesPerSecond, LogiLedMirrorMinMaxBytesPerSecond);
+}
+
+
+bool FLogiLedMirror::StartReceiving(int32 Port)
+{
+	Stop();
+
+	Socket = FUdpSocketBuilder(TEXT("LogiLedMirrorReceiver"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToPort(Port)
+		.WithReceiveBufferSize(LogiLedMirrorBufferSize);
+
+	if (Socket == nullptr)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to create LED mirror receiver on port %i"), Port);
+		return false;
+	}
+
+	Mode = EMode::Receive;
+	MirroredFrame.Fill(FColor(0, 0, 0, 0));
+	UE_LOG(LogLogiLed, Log, TEXT("Receiving LED mirror on port %i"), Port);
+
+	return true;
+}
+
+
+bool FLogiLedMirror::StartSending(const FString& Address)
+{
+	Stop();
+
+	FString Host;
+	FString PortString;
+
+	if (!Address.Split(TEXT(":"), &Host, &PortString, ESearchCase::CaseSensitive, ESearchDir::FromEnd) || !PortString.IsNumeric())
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Invalid LED mirror address %s (expected host:port)"), *Address);
+		return false;
+	}
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	if (SocketSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	bool IsValid = false;
+	ReceiverAddress = SocketSubsystem->CreateInternetAddr();
+	ReceiverAddress->SetIp(*Host, IsValid);
+	ReceiverAddress->SetPort(FCString::Atoi(*PortString));
+
+	if (!IsValid)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Invalid LED mirror address %s (expected host:port)"), *Address);
+		ReceiverAddress.Reset();
+		return false;
+	}
+
+	Socket = FUdpSocketBuilder(TEXT("LogiLedMirrorSender"))
+		.AsNonBlocking()
+		.WithSendBufferSize(LogiLedMirrorBufferSize);
+
+	if (Socket == nullptr)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to create LED mirror sender"));
+		ReceiverAddress.Reset();
+		return false;
+	}
+
+	// the manager publishes frames only while someone is watching
+	FLogiLedSnapshot::Get().AddViewer();
+
+	Mode = EMode::Send;
+	ByteBudget = MaxBytesPerSecond;
+	UE_LOG(LogLogiLed, Log, TEXT("Sending LED mirror to %s"), *Address);
+
+	return true;
+}
+
+
+void FLogiLedMirror::Stop()
+{
+	if (Mode == EMode::Send)
+	{
+		FLogiLedSnapshot::Get().RemoveViewer();
+	}
+	else if (Mode == EMode::Receive)
+	{
+		// the active manager may have changed since the overrides were set
+		FLogiLedManager::ClearAllOverrideFrames(ELogiLedOverrideLayer::Mirror);
+	}
+
+	if (Socket != nullptr)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+
+	Mode = EMode::None;
+	ReceiverAddress.Reset();
+	MirroredValid = false;
+	Sequence = 0;
+	TimeUntilSend = 0.0f;
+	TimeUntilKeyframe = 0.0f;
+	WindowBytes = 0;
+	WindowSeconds = 0.0f;
+	BytesPerSecond = 0.0f;
+
+	SET_FLOAT_STAT(STAT_LogiLedMirrorBytesPerSecond, 0.0f);
+}
+
+
+/* FTickableGameObject interface
+ *****************************************************************************/
+
+TStatId FLogiLedMirror::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FLogiLedMirror, STATGROUP_Tickables);
+}
+
+
+bool FLogiLedMirror::IsTickable() const
+{
+	return (Mode != EMode::None);
+}
+
+
+bool FLogiLedMirror::IsTickableInEditor() const
+{
+	return true;
+}
+
+
+void FLogiLedMirror::Tick(float DeltaTime)
+{
+	if (Mode == EMode::Receive)
+	{
+		Receive();
+
+		// the mirror does not belong to a world, so it drives whichever manager is active,
+		// which only wakes up if the overrides changed
+		FLogiLedManager::GetActive().SetOverrideFrame(ELogiLedOverrideLayer::Mirror, MirroredFrame);
+	}
+	else if (Mode == EMode::Send)
+	{
+		Send(DeltaTime);
+	}
+
+	UpdateBytesPerSecond(0, DeltaTime);
+}
+
+
+/* FLogiLedMirror implementation
+ *****************************************************************************/
+
+bool FLogiLedMirror::ApplyPacket(const uint8* Data, int32 Size)
+{
+	FBitReader Reader(const_cast<uint8*>(Data), Size * 8);
+
+	uint8 Magic = 0;
+	uint8 Version = 0;
+	uint8 Flags = 0;
+	uint16 PacketSequence = 0;
+	uint8 NumKeys = 0;
+
+	Reader << Magic << Version << Flags << PacketSequence << NumKeys;
+
+	if (Reader.IsError() || (Magic != LogiLedMirrorMagic) || (Version != LogiLedMirrorVersion) || (NumKeys != LogiLedKeys::Count))
+	{
+		return false;
+	}
+
+	const bool Keyframe = (Flags & LogiLedMirrorKeyframeFlag) != 0;
+
+	// deltas only apply to the frame they were computed from
+	if (!Keyframe && (!MirroredValid || (PacketSequence != (uint16)(Sequence + 1))))
+	{
+		MirroredValid = false;
+		return false;
+	}
+
+	FLogiLedFrame Frame = MirroredFrame;
+	bool Changed[LogiLedKeys::Count];
+
+	for (bool& KeyChanged : Changed)
+	{
+		KeyChanged = Keyframe || Reader.ReadBit();
+	}
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		if (Changed[KeyIndex])
+		{
+			uint32 R = 0, G = 0, B = 0;
+
+			Reader.SerializeInt(R, LogiLedMirrorChannelValues);
+			Reader.SerializeInt(G, LogiLedMirrorChannelValues);
+			Reader.SerializeInt(B, LogiLedMirrorChannelValues);
+
+			// non-zero alpha marks the key as overridden
+			Frame.Colors[KeyIndex] = FColor(FMath::Min<uint32>(R, 100), FMath::Min<uint32>(G, 100), FMath::Min<uint32>(B, 100), 255);
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		MirroredValid = false;
+		return false;
+	}
+
+	MirroredFrame = Frame;
+	MirroredValid = true;
+	Sequence = PacketSequence;
+
+	return true;
+}
+
+
+void FLogiLedMirror::Receive()
+{
+	TSharedRef<FInternetAddr> SenderAddress = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	uint32 PendingSize = 0;
+
+	while (Socket->HasPendingData(PendingSize))
+	{
+		ReceiveBuffer.SetNumUninitialized(FMath::Min(PendingSize, 65507u), false);
+
+		int32 NumRead = 0;
+
+		if (!Socket->RecvFrom(ReceiveBuffer.GetData(), ReceiveBuffer.Num(), NumRead, *SenderAddress) || (NumRead <= 0))
+		{
+			break;
+		}
+
+		UpdateBytesPerSecond(NumRead, 0.0f);
+
+		if (!ApplyPacket(ReceiveBuffer.GetData(), NumRead))
+		{
+			INC_DWORD_STAT(STAT_LogiLedMirrorDroppedPackets);
+		}
+	}
+}
+
+
+void FLogiLedMirror::Send(float DeltaTime)
+{
+	FLogiLedSnapshot::Get().Read(Colors);
+
+	ByteBudget = FMath::Min(ByteBudget + MaxBytesPerSecond * DeltaTime, (float)MaxBytesPerSecond);
+	TimeUntilKeyframe -= DeltaTime;
+	TimeUntilSend -= DeltaTime;
+
+	if (TimeUntilSend > 0.0f)
+	{
+		return;
+	}
+
+	TimeUntilSend = FMath::Max(TimeUntilSend + LogiLedMirrorSendInterval, 0.0f);
+
+	const bool Keyframe = !MirroredValid || (TimeUntilKeyframe <= 0.0f);
+	bool Changed[LogiLedKeys::Count];
+	int32 NumChanged = 0;
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		const FColor& Color = Colors[KeyIndex];
+		const FColor& Mirrored = MirroredFrame.Colors[KeyIndex];
+
+		Changed[KeyIndex] = Keyframe || (Color.R != Mirrored.R) || (Color.G != Mirrored.G) || (Color.B != Mirrored.B);
+		NumChanged += Changed[KeyIndex] ? 1 : 0;
+	}
+
+	if (NumChanged == 0)
+	{
+		return;
+	}
+
+	// header, change mask (deltas only) and 21 bits per changed key
+	const int32 HeaderBits = 6 * 8;
+	const int32 MaskBits = Keyframe ? 0 : LogiLedKeys::Count;
+	const int32 PacketBytes = (HeaderBits + MaskBits + NumChanged * 21 + 7) / 8;
+
+	// coalesce changes until there is enough bandwidth
+	if (PacketBytes > ByteBudget)
+	{
+		return;
+	}
+
+	uint8 Magic = LogiLedMirrorMagic;
+	uint8 Version = LogiLedMirrorVersion;
+	uint8 Flags = Keyframe ? LogiLedMirrorKeyframeFlag : 0;
+	uint16 PacketSequence = Sequence + 1;
+	uint8 NumKeys = LogiLedKeys::Count;
+
+	FBitWriter Writer(PacketBytes * 8);
+	Writer << Magic << Version << Flags << PacketSequence << NumKeys;
+
+	if (!Keyframe)
+	{
+		for (bool KeyChanged : Changed)
+		{
+			Writer.WriteBit(KeyChanged ? 1 : 0);
+		}
+	}
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		if (Changed[KeyIndex])
+		{
+			uint32 R = FMath::Min<uint32>(Colors[KeyIndex].R, 100);
+			uint32 G = FMath::Min<uint32>(Colors[KeyIndex].G, 100);
+			uint32 B = FMath::Min<uint32>(Colors[KeyIndex].B, 100);
+
+			Writer.SerializeInt(R, LogiLedMirrorChannelValues);
+			Writer.SerializeInt(G, LogiLedMirrorChannelValues);
+			Writer.SerializeInt(B, LogiLedMirrorChannelValues);
+		}
+	}
+
+	check(!Writer.IsError());
+
+	int32 NumSent = 0;
+
+	if (!Socket->SendTo(Writer.GetData(), Writer.GetNumBytes(), NumSent, *ReceiverAddress))
+	{
+		// try again with a keyframe
+		MirroredValid = false;
+		return;
+	}
+
+	FMemory::Memcpy(MirroredFrame.Colors, Colors, sizeof(MirroredFrame.Colors));
+	MirroredValid = true;
+	Sequence = PacketSequence;
+	ByteBudget -= NumSent;
+
+	if (Keyframe)
+	{
+		TimeUntilKeyframe = LogiLedMirrorKeyframeInterval;
+	}
+
+	UpdateBytesPerSecond(NumSent, 0.0f);
+	INC_DWORD_STAT(STAT_LogiLedMirrorPackets);
+}
+
+
+void FLogiLedMirror::UpdateBytesPerSecond(int32 NumBytes, float DeltaTime)
+{
+	WindowBytes += NumBytes;
+	WindowSeconds += DeltaTime;
+
+	if (WindowSeconds >= 1.0f)
+	{
+		BytesPerSecond = WindowBytes / WindowSeconds;
+		WindowBytes = 0;
+		WindowSeconds = 0.0f;
+
+		SET_FLOAT_STAT(STAT_LogiLedMirrorBytesPerSecond, BytesPerSecond);
+	}
+}
@@ -0,0 +1,187 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "Math/Color.h"
+#include "Templates/SharedPointer.h"
+#include "Tickable.h"
+
+#include "LogiLedFrame.h"
+#include "LogiLedSnapshot.h"
+
+class FInternetAddr;
+class FSocket;
+
+
+/**
+ * Mirrors the LED manager's per-key lighting to other processes.
+ *
+ * A sender sends the manager's flushed frames to a receiver over UDP, and the
+ * receiver applies them as key overrides on the mirror layer, which takes
+ * precedence over Sequencer tracks, so that second-screen or spectator machines
+ * show the same lighting as the player's machine.
+ *
+ * Packets are compact deltas: a bit mask of the keys that changed since the
+ * last packet, followed by the 7-bit red, green and blue percentages of each
+ * changed key. Changes are coalesced while the bandwidth cap is reached, and
+ * a keyframe with all keys is sent periodically, so that receivers recover
+ * from lost packets and can join at any time. Receivers ignore deltas after a
+ * lost packet until the next keyframe arrives.
+ */
+class FLogiLedMirror
+	: public FTickableGameObject
+{
+public:
+
+	/** Default constructor. */
+	FLogiLedMirror();
+
+	/** Virtual destructor. */
+	~FLogiLedMirror();
+
+public:
+
+	/**
+	 * Get the number of bytes sent or received per second, averaged over the last second.
+	 *
+	 * @return Bytes per second (UDP payload only).
+	 */
+	float GetBytesPerSecond() const
+	{
+		return BytesPerSecond;
+	}
+
+	/**
+	 * Set the maximum number of bytes to send per second.
+	 *
+	 * The cap is raised to at least 512 bytes per second, so that keyframes
+	 * can still be sent.
+	 *
+	 * @param InMaxBytesPerSecond The bandwidth cap.
+	 */
+	void SetMaxBytesPerSecond(int32 InMaxBytesPerSecond);
+
+	/**
+	 * Start receiving lighting from a sender.
+	 *
+	 * Stops any previous sending or receiving.
+	 *
+	 * @param Port The UDP port to receive on.
+	 * @return true on success, false if the socket could not be created.
+	 * @see StartSending, Stop
+	 */
+	bool StartReceiving(int32 Port);
+
+	/**
+	 * Start sending lighting to a receiver.
+	 *
+	 * Stops any previous sending or receiving.
+	 *
+	 * @param Address The receiver's address and port, i.e. 127.0.0.1:7788.
+	 * @return true on success, false if the address is invalid or the socket could not be created.
+	 * @see StartReceiving, Stop
+	 */
+	bool StartSending(const FString& Address);
+
+	/**
+	 * Stop sending or receiving.
+	 *
+	 * A receiver's key overrides are removed.
+	 */
+	void Stop();
+
+public:
+
+	//~ FTickableGameObject interface
+
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableInEditor() const override;
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+
+	/**
+	 * Apply a received packet to the mirrored frame.
+	 *
+	 * @param Data The packet data.
+	 * @param Size The packet size (in bytes).
+	 * @return true if the packet was applied, false if it was invalid or had to be dropped.
+	 */
+	bool ApplyPacket(const uint8* Data, int32 Size);
+
+	/** Receive and apply all pending packets to the mirrored frame. */
+	void Receive();
+
+	/**
+	 * Send the latest frame if it changed and the bandwidth cap allows.
+	 *
+	 * @param DeltaTime Time since the last tick.
+	 */
+	void Send(float DeltaTime);
+
+	/**
+	 * Update the bandwidth statistics.
+	 *
+	 * @param NumBytes Number of bytes sent or received this tick.
+	 * @param DeltaTime Time since the last tick.
+	 */
+	void UpdateBytesPerSecond(int32 NumBytes, float DeltaTime);
+
+private:
+
+	/** Whether the mirror sends or receives. */
+	enum class EMode : uint8
+	{
+		None,
+		Receive,
+		Send
+	};
+
+	/** The current mode. */
+	EMode Mode;
+
+	/** The socket (only valid while sending or receiving). */
+	FSocket* Socket;
+
+	/** The receiver's address (only valid while sending). */
+	TSharedPtr<FInternetAddr> ReceiverAddress;
+
+	/** The most recently read frame (sender only). */
+	FColor Colors[FLogiLedSnapshot::MaxKeys];
+
+	/** The frame as the receiver knows it, or the received frame. */
+	FLogiLedFrame MirroredFrame;
+
+	/** Whether MirroredFrame is valid (false = a keyframe is needed). */
+	bool MirroredValid;
+
+	/** Sequence number of the last sent or received packet. */
+	uint16 Sequence;
+
+	/** Maximum number of bytes to send per second. */
+	int32 MaxBytesPerSecond;
+
+	/** Number of bytes that may be sent right now. */
+	float ByteBudget;
+
+	/** Time until the next packet may be sent (in seconds). */
+	float TimeUntilSend;
+
+	/** Time until the next keyframe is due (in seconds). */
+	float TimeUntilKeyframe;
+
+	/** Number of bytes sent or received in the current measurement window. */
+	int32 WindowBytes;
+
+	/** Duration of the current measurement window (in seconds). */
+	float WindowSeconds;
+
+	/** Bytes sent or received per second in the last measurement window. */
+	float BytesPerSecond;
+
+	/** Buffer for received packets. */
+	TArray<uint8> ReceiveBuffer;
+};
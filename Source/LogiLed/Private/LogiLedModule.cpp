@@ -1,15 +1,23 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
+#include "LogiLedBlueprintLibrary.h"
+#include "LogiLedEffectPool.h"
 #include "LogiLedPrivate.h"
+#include "LogiLedSdk.h"
+#include "LogiLedSharedFrame.h"
 
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Parse.h"
 #include "Modules/ModuleInterface.h"
 #include "Modules/ModuleManager.h"
 
-#include "LogitechLEDLib.h"
-
 
 DEFINE_LOG_CATEGORY(LogLogiLed);
 
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Module Startup Time (ms)"), STAT_LogiLedStartupTime, STATGROUP_LogiLed);
+
 #define LOCTEXT_NAMESPACE "FLogiLedModule"
 
 
@@ -19,63 +27,83 @@ DEFINE_LOG_CATEGORY(LogLogiLed);
 class FLogiLedModule
 	: public IModuleInterface
 {
-public:
-
-	/** Default constructor. */
-	FLogiLedModule()
-		: Initialized(false)
-	{ }
-
 public:
 
 	//~ IModuleInterface interface
 
 	virtual void StartupModule() override
 	{
-#if LOGILED_SUPPORTED_PLATFORM
-		// initialize Logitech SDK
-		if (!::LogiLedInit())
-		{
-			UE_LOG(LogLogiLed, Error, TEXT("Failed to initialize Logitech LED SDK"));
-			return;
-		}
-#else
-		return;
-#endif //LOGILED_SUPPORTED_PLATFORM
+		const double StartTime = FPlatformTime::Seconds();
 
-		int Major, Minor, Build;
+		// the SDK is connected when LEDs are first used, see FLogiLedManager::Get
 
-		if (::LogiLedGetSdkVersion(&Major, &Minor, &Build))
-		{
-			UE_LOG(LogLogiLed, Log, TEXT("Initialized Logitech LED SDK %i.%i.%i."), Major, Minor, Build);
-		}
-		else
-		{
-			UE_LOG(LogLogiLed, Log, TEXT("Initialized Logitech LED SDK (unknown version)"));
-		}
+		// cached curve copies must be refreshed when curve assets are edited
+		FLogiLedEffectPool::StartTrackingCurveChanges();
+
+		// sockets are available once the engine is up
+		FCoreDelegates::OnPostEngineInit.AddRaw(this, &FLogiLedModule::HandlePostEngineInit);
+
+		const float StartupMilliseconds = (float)((FPlatformTime::Seconds() - StartTime) * 1000.0);
 
-		Initialized = true;
+		SET_FLOAT_STAT(STAT_LogiLedStartupTime, StartupMilliseconds);
+		UE_LOG(LogLogiLed, Log, TEXT("Started LogiLed module in %.2f ms"), StartupMilliseconds);
 	}
 
 	virtual void ShutdownModule() override
 	{
-		if (!Initialized)
+		FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+
+		ULogiLedBlueprintLibrary::DestroyAll();
+		FLogiLedSharedFrame::Get().Close();
+		FLogiLedManager::DestroyAll();
+		FLogiLedEffectPool::StopTrackingCurveChanges();
+		FLogiLedSdk::Disconnect();
+	}
+
+private:
+
+	/** Callback for when the engine has been initialized. */
+	void HandlePostEngineInit()
+	{
+		// lighting can be mirrored between processes from the command line, i.e. over loopback:
+		// -LogiLedMirrorSend=127.0.0.1:7788 and -LogiLedMirrorReceive=7788
+		FString Address;
+		int32 Port = 0;
+
+		if (FParse::Value(FCommandLine::Get(), TEXT("LogiLedMirrorSend="), Address))
+		{
+			ULogiLedBlueprintLibrary::GetMirror().StartSending(Address);
+		}
+		else if (FParse::Value(FCommandLine::Get(), TEXT("LogiLedMirrorReceive="), Port))
 		{
-			return;
+			ULogiLedBlueprintLibrary::GetMirror().StartReceiving(Port);
 		}
 
-#if LOGILED_SUPPORTED_PLATFORM
-		// shut down SDK
-		::LogiLedShutdown();
+		// other devices can be driven through OpenRGB, i.e. -LogiLedOpenRgb=127.0.0.1:6742,
+		// which is the default where the Logitech SDK is not available
+		if (FParse::Value(FCommandLine::Get(), TEXT("LogiLedOpenRgb="), Address))
+		{
+			ULogiLedBlueprintLibrary::GetOpenRgb().Start(Address);
+		}
+#if !LOGILED_SUPPORTED_PLATFORM
+		else if (!IsRunningCommandlet() && !FParse::Param(FCommandLine::Get(), TEXT("NoLogiLedOpenRgb")))
+		{
+			ULogiLedBlueprintLibrary::GetOpenRgb().Start(TEXT("127.0.0.1:6742"));
+		}
 #endif
 
-		Initialized = false;
-	}
-
-private:
+		// frames can be exported to shared memory for external tools: -LogiLedSharedFrame[=Name]
+		FString SharedFrameName;
 
-	/** Whether the module has been initialized. */
-	bool Initialized;
+		if (FParse::Value(FCommandLine::Get(), TEXT("LogiLedSharedFrame="), SharedFrameName))
+		{
+			FLogiLedSharedFrame::Get().Open(SharedFrameName);
+		}
+		else if (FParse::Param(FCommandLine::Get(), TEXT("LogiLedSharedFrame")))
+		{
+			FLogiLedSharedFrame::Get().Open(FLogiLedSharedFrame::DefaultName);
+		}
+	}
 };
 
 
@@ -0,0 +1,729 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedOpenRgb.h"
+#include "LogiLedKeys.h"
+#include "LogiLedPrivate.h"
+
+#include "IPAddress.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("OpenRGB Bytes Per Second"), STAT_LogiLedOpenRgbBytesPerSecond, STATGROUP_LogiLed);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("OpenRGB Packets Per Second"), STAT_LogiLedOpenRgbPacketsPerSecond, STATGROUP_LogiLed);
+DECLARE_DWORD_COUNTER_STAT(TEXT("OpenRGB Packets"), STAT_LogiLedOpenRgbPackets, STATGROUP_LogiLed);
+
+
+/** Packet header values. */
+static const uint8 LogiLedOpenRgbMagic[] = { 'O', 'R', 'G', 'B' };
+static const int32 LogiLedOpenRgbHeaderSize = 16;
+
+/** Packet identifiers (protocol version 0). */
+static const uint32 LogiLedOpenRgbRequestControllerCount = 0;
+static const uint32 LogiLedOpenRgbRequestControllerData = 1;
+static const uint32 LogiLedOpenRgbSetClientName = 50;
+static const uint32 LogiLedOpenRgbDeviceListUpdated = 100;
+static const uint32 LogiLedOpenRgbUpdateLeds = 1050;
+static const uint32 LogiLedOpenRgbUpdateZoneLeds = 1051;
+static const uint32 LogiLedOpenRgbSetCustomMode = 1100;
+
+/** Device type of keyboards, whose LEDs are matched to keys by name. */
+static const int32 LogiLedOpenRgbKeyboardType = 5;
+
+/** Default port of the OpenRGB SDK server. */
+static const int32 LogiLedOpenRgbDefaultPort = 6742;
+
+/** Largest packet that is accepted from the server (in bytes). */
+static const uint32 LogiLedOpenRgbMaxPacketSize = 1024 * 1024;
+
+/** Largest number of devices that are driven. */
+static const uint32 LogiLedOpenRgbMaxDevices = 256;
+
+/** Number of bytes to receive at a time. */
+static const int32 LogiLedOpenRgbReceiveChunkSize = 4096;
+
+/** Time after which a connection attempt is given up (in seconds). */
+static const float LogiLedOpenRgbConnectTimeout = 5.0f;
+
+/** Interval between connection attempts (in seconds). */
+static const float LogiLedOpenRgbRetryInterval = 5.0f;
+
+/** Interval between frames (in seconds). */
+static const float LogiLedOpenRgbSendInterval = 1.0f / 60.0f;
+
+/** OpenRGB LED names that are not the primary name of a key. */
+static const struct
+{
+	const ANSICHAR* Name;
+	ELogiLedKeys Key;
+}
+LogiLedOpenRgbAliases[] =
+{
+	{ "Key: Enter (ISO)", ELogiLedKeys::Enter },
+};
+
+static_assert(LogiLedKeys::Count < 255, "LED tables must be able to address all keys and the average");
+
+
+/**
+ * Reads little-endian values from a packet.
+ *
+ * Reading past the end of the packet sets the error flag and returns zeros.
+ */
+struct FLogiLedOpenRgbReader
+{
+	FLogiLedOpenRgbReader(const uint8* InData, uint32 InSize)
+		: Data(InData)
+		, Size(InSize)
+		, Offset(0)
+		, Error(false)
+	{ }
+
+	const ANSICHAR* ReadString()
+	{
+		// lengths include the null terminator
+		const uint32 Length = ReadUint16();
+		const uint8* String = Data + Offset;
+
+		if (!Skip(Length) || (Length == 0) || (String[Length - 1] != 0))
+		{
+			Error = true;
+			return "";
+		}
+
+		return (const ANSICHAR*)String;
+	}
+
+	uint16 ReadUint16()
+	{
+		return Skip(2) ? (uint16)(Data[Offset - 2] | (Data[Offset - 1] << 8)) : 0;
+	}
+
+	uint32 ReadUint32()
+	{
+		return Skip(4) ? ((uint32)Data[Offset - 4] | ((uint32)Data[Offset - 3] << 8) | ((uint32)Data[Offset - 2] << 16) | ((uint32)Data[Offset - 1] << 24)) : 0;
+	}
+
+	bool Skip(uint32 NumBytes)
+	{
+		if (Error || (NumBytes > Size - Offset))
+		{
+			Error = true;
+			return false;
+		}
+
+		Offset += NumBytes;
+
+		return true;
+	}
+
+	const uint8* Data;
+	uint32 Size;
+	uint32 Offset;
+	bool Error;
+};
+
+
+/** Append a little-endian value to a packet. */
+static void LogiLedOpenRgbWriteUint16(TArray<uint8>& Buffer, uint16 Value)
+{
+	Buffer.Add((uint8)Value);
+	Buffer.Add((uint8)(Value >> 8));
+}
+
+
+/** Append a little-endian value to a packet. */
+static void LogiLedOpenRgbWriteUint32(TArray<uint8>& Buffer, uint32 Value)
+{
+	Buffer.Add((uint8)Value);
+	Buffer.Add((uint8)(Value >> 8));
+	Buffer.Add((uint8)(Value >> 16));
+	Buffer.Add((uint8)(Value >> 24));
+}
+
+
+/** Append the colors of a range of LEDs to a packet, and remember them as sent. */
+static void LogiLedOpenRgbWriteColors(TArray<uint8>& Buffer, const uint32* KeyColors, const uint8* LedKeys, uint32* SentColors, int32 NumLeds)
+{
+	LogiLedOpenRgbWriteUint16(Buffer, (uint16)NumLeds);
+
+	for (int32 LedIndex = 0; LedIndex < NumLeds; ++LedIndex)
+	{
+		const uint32 Color = KeyColors[LedKeys[LedIndex]];
+
+		LogiLedOpenRgbWriteUint32(Buffer, Color);
+		SentColors[LedIndex] = Color;
+	}
+}
+
+
+/** Find the key with the given OpenRGB LED name (LogiLedKeys::Count if none). */
+static uint8 LogiLedOpenRgbFindKey(const ANSICHAR* Name)
+{
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		const ANSICHAR* KeyName = LogiLedKeys::ToOpenRgbName((ELogiLedKeys)KeyIndex);
+
+		if ((KeyName != nullptr) && (FCStringAnsi::Strcmp(KeyName, Name) == 0))
+		{
+			return (uint8)KeyIndex;
+		}
+	}
+
+	for (const auto& Alias : LogiLedOpenRgbAliases)
+	{
+		if (FCStringAnsi::Strcmp(Alias.Name, Name) == 0)
+		{
+			return (uint8)Alias.Key;
+		}
+	}
+
+	return (uint8)LogiLedKeys::Count;
+}
+
+
+/* FLogiLedOpenRgb structors
+ *****************************************************************************/
+
+FLogiLedOpenRgb::FLogiLedOpenRgb()
+	: State(EState::Stopped)
+	, Socket(nullptr)
+	, TimeUntilConnect(0.0f)
+	, TimeUntilSend(0.0f)
+	, WindowPackets(0)
+	, WindowBytes(0)
+	, WindowSeconds(0.0f)
+	, BytesPerSecond(0.0f)
+	, PacketsPerSecond(0.0f)
+{
+	FMemory::Memzero(Colors);
+	FMemory::Memzero(KeyColors);
+}
+
+
+/* FLogiLedOpenRgb interface
+ *****************************************************************************/
+
+bool FLogiLedOpenRgb::Start(const FString& Address)
+{
+	Stop();
+
+	FString Host = Address;
+	FString PortString;
+	int32 Port = LogiLedOpenRgbDefaultPort;
+
+	if (Address.Split(TEXT(":"), &Host, &PortString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+	{
+		if (!PortString.IsNumeric())
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Invalid OpenRGB server address %s (expected ip[:port])"), *Address);
+			return false;
+		}
+
+		Port = FCString::Atoi(*PortString);
+	}
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	if (SocketSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	bool IsValid = false;
+	ServerAddress = SocketSubsystem->CreateInternetAddr();
+	ServerAddress->SetIp(*Host, IsValid);
+	ServerAddress->SetPort(Port);
+
+	if (!IsValid)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Invalid OpenRGB server address %s (expected ip[:port])"), *Address);
+		ServerAddress.Reset();
+		return false;
+	}
+
+	// the manager publishes frames only while someone is watching
+	FLogiLedSnapshot::Get().AddViewer();
+
+	State = EState::Disconnected;
+	TimeUntilConnect = 0.0f;
+	UE_LOG(LogLogiLed, Log, TEXT("Sending LED output to OpenRGB server %s"), *ServerAddress->ToString(true));
+
+	return true;
+}
+
+
+void FLogiLedOpenRgb::Stop()
+{
+	if (State == EState::Stopped)
+	{
+		return;
+	}
+
+	Disconnect(false);
+	FLogiLedSnapshot::Get().RemoveViewer();
+
+	State = EState::Stopped;
+	ServerAddress.Reset();
+	WindowPackets = 0;
+	WindowBytes = 0;
+	WindowSeconds = 0.0f;
+	BytesPerSecond = 0.0f;
+	PacketsPerSecond = 0.0f;
+
+	SET_FLOAT_STAT(STAT_LogiLedOpenRgbBytesPerSecond, 0.0f);
+	SET_FLOAT_STAT(STAT_LogiLedOpenRgbPacketsPerSecond, 0.0f);
+}
+
+
+/* FTickableGameObject interface
+ *****************************************************************************/
+
+TStatId FLogiLedOpenRgb::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FLogiLedOpenRgb, STATGROUP_Tickables);
+}
+
+
+bool FLogiLedOpenRgb::IsTickable() const
+{
+	return (State != EState::Stopped);
+}
+
+
+bool FLogiLedOpenRgb::IsTickableInEditor() const
+{
+	return true;
+}
+
+
+void FLogiLedOpenRgb::Tick(float DeltaTime)
+{
+	if (State == EState::Disconnected)
+	{
+		TimeUntilConnect -= DeltaTime;
+
+		if (TimeUntilConnect <= 0.0f)
+		{
+			Connect();
+		}
+	}
+
+	if (State == EState::Connecting)
+	{
+		const ESocketConnectionState ConnectionState = Socket->GetConnectionState();
+		TimeUntilConnect -= DeltaTime;
+
+		if (ConnectionState == SCS_Connected)
+		{
+			State = EState::Connected;
+			UE_LOG(LogLogiLed, Log, TEXT("Connected to OpenRGB server %s"), *ServerAddress->ToString(true));
+
+			static const ANSICHAR ClientName[] = "LogiLed";
+
+			QueueHeader(0, LogiLedOpenRgbSetClientName, sizeof(ClientName));
+			SendBuffer.Append((const uint8*)ClientName, sizeof(ClientName));
+			QueueHeader(0, LogiLedOpenRgbRequestControllerCount, 0);
+		}
+		else if ((ConnectionState == SCS_ConnectionError) || (TimeUntilConnect <= 0.0f))
+		{
+			Disconnect(true);
+		}
+	}
+
+	if (State == EState::Connected)
+	{
+		if (!Receive())
+		{
+			Disconnect(true);
+		}
+		else
+		{
+			QueueUpdates(DeltaTime);
+
+			if (!Flush())
+			{
+				Disconnect(true);
+			}
+		}
+	}
+
+	UpdateRates(0, 0, DeltaTime);
+}
+
+
+/* FLogiLedOpenRgb implementation
+ *****************************************************************************/
+
+void FLogiLedOpenRgb::Connect()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	if (SocketSubsystem != nullptr)
+	{
+		Socket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("LogiLedOpenRgb"), false);
+	}
+
+	if (Socket == nullptr)
+	{
+		Disconnect(true);
+		return;
+	}
+
+	// LED updates are small and should not wait for more data
+	Socket->SetNonBlocking(true);
+	Socket->SetNoDelay(true);
+
+	if (!Socket->Connect(*ServerAddress))
+	{
+		Disconnect(true);
+		return;
+	}
+
+	State = EState::Connecting;
+	TimeUntilConnect = LogiLedOpenRgbConnectTimeout;
+}
+
+
+void FLogiLedOpenRgb::Disconnect(bool Retry)
+{
+	if (State == EState::Connected)
+	{
+		UE_LOG(LogLogiLed, Log, TEXT("Disconnected from OpenRGB server %s"), *ServerAddress->ToString(true));
+	}
+
+	if (Socket != nullptr)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+
+	Devices.Reset();
+	SendBuffer.Reset();
+	ReceiveBuffer.Reset();
+
+	State = EState::Disconnected;
+	TimeUntilConnect = Retry ? LogiLedOpenRgbRetryInterval : 0.0f;
+	TimeUntilSend = 0.0f;
+}
+
+
+bool FLogiLedOpenRgb::Flush()
+{
+	if (SendBuffer.Num() == 0)
+	{
+		return true;
+	}
+
+	int32 NumSent = 0;
+
+	if (!Socket->Send(SendBuffer.GetData(), SendBuffer.Num(), NumSent))
+	{
+		// the socket buffer is full while the server catches up
+		return (ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() == SE_EWOULDBLOCK);
+	}
+
+	SendBuffer.RemoveAt(0, NumSent, false);
+	UpdateRates(0, NumSent, 0.0f);
+
+	return true;
+}
+
+
+void FLogiLedOpenRgb::HandlePacket(uint32 DeviceIndex, uint32 PacketId, const uint8* Payload, uint32 Size)
+{
+	if (PacketId == LogiLedOpenRgbRequestControllerCount)
+	{
+		FLogiLedOpenRgbReader Reader(Payload, Size);
+		const uint32 NumDevices = FMath::Min(Reader.ReadUint32(), LogiLedOpenRgbMaxDevices);
+
+		Devices.Reset();
+		Devices.SetNum(NumDevices);
+
+		// the server answers in order, so all descriptions can be requested at once
+		for (uint32 Index = 0; Index < NumDevices; ++Index)
+		{
+			QueueHeader(Index, LogiLedOpenRgbRequestControllerData, 0);
+		}
+	}
+	else if (PacketId == LogiLedOpenRgbRequestControllerData)
+	{
+		if ((DeviceIndex < (uint32)Devices.Num()) && !ParseDevice(DeviceIndex, Payload, Size))
+		{
+			UE_LOG(LogLogiLed, Warning, TEXT("Ignoring invalid description of OpenRGB device %u"), DeviceIndex);
+		}
+	}
+	else if (PacketId == LogiLedOpenRgbDeviceListUpdated)
+	{
+		QueueHeader(0, LogiLedOpenRgbRequestControllerCount, 0);
+	}
+}
+
+
+bool FLogiLedOpenRgb::ParseDevice(uint32 DeviceIndex, const uint8* Payload, uint32 Size)
+{
+	FLogiLedOpenRgbReader Reader(Payload, Size);
+
+	Reader.ReadUint32(); // data size
+	const int32 Type = (int32)Reader.ReadUint32();
+	const FString Name = ANSI_TO_TCHAR(Reader.ReadString());
+
+	Reader.ReadString(); // description
+	Reader.ReadString(); // version
+	Reader.ReadString(); // serial
+	Reader.ReadString(); // location
+
+	// modes: name, nine 32-bit values, colors
+	const uint16 NumModes = Reader.ReadUint16();
+	Reader.ReadUint32(); // active mode
+
+	for (uint16 ModeIndex = 0; (ModeIndex < NumModes) && !Reader.Error; ++ModeIndex)
+	{
+		Reader.ReadString();
+		Reader.Skip(9 * 4);
+		Reader.Skip(Reader.ReadUint16() * 4);
+	}
+
+	// zones: name, type, LED counts, matrix map
+	FDevice& Device = Devices[DeviceIndex];
+	const uint16 NumZones = Reader.ReadUint16();
+	int32 NumZoneLeds = 0;
+
+	Device.Zones.Reset(NumZones);
+
+	for (uint16 ZoneIndex = 0; (ZoneIndex < NumZones) && !Reader.Error; ++ZoneIndex)
+	{
+		Reader.ReadString();
+		Reader.Skip(3 * 4); // type, minimum and maximum LED count
+
+		FZone& Zone = Device.Zones[Device.Zones.AddDefaulted()];
+		Zone.FirstLed = NumZoneLeds;
+		Zone.NumLeds = (int32)FMath::Min<uint32>(Reader.ReadUint32(), MAX_uint16);
+		NumZoneLeds += Zone.NumLeds;
+
+		Reader.Skip(Reader.ReadUint16());
+	}
+
+	// LEDs: name, value
+	const uint16 NumLeds = Reader.ReadUint16();
+	int32 NumMapped = 0;
+
+	Device.LedKeys.Reset(NumLeds);
+
+	for (uint16 LedIndex = 0; (LedIndex < NumLeds) && !Reader.Error; ++LedIndex)
+	{
+		const ANSICHAR* LedName = Reader.ReadString();
+		Reader.Skip(4);
+
+		const uint8 Key = (Type == LogiLedOpenRgbKeyboardType) ? LogiLedOpenRgbFindKey(LedName) : (uint8)LogiLedKeys::Count;
+
+		Device.LedKeys.Add(Key);
+		NumMapped += (Key < LogiLedKeys::Count) ? 1 : 0;
+	}
+
+	if (Reader.Error || (NumZoneLeds != NumLeds))
+	{
+		Device.Valid = false;
+		return false;
+	}
+
+	Device.SentColors.SetNumZeroed(NumLeds);
+	Device.Valid = true;
+	Device.SentValid = false;
+
+	// direct control of the LEDs
+	QueueHeader(DeviceIndex, LogiLedOpenRgbSetCustomMode, 0);
+
+	UE_LOG(LogLogiLed, Log, TEXT("Found OpenRGB device %u: %s (%i LEDs, %i mapped to keys)"), DeviceIndex, *Name, (int32)NumLeds, NumMapped);
+
+	return true;
+}
+
+
+void FLogiLedOpenRgb::QueueHeader(uint32 DeviceIndex, uint32 PacketId, uint32 PayloadSize)
+{
+	SendBuffer.Append(LogiLedOpenRgbMagic, ARRAY_COUNT(LogiLedOpenRgbMagic));
+	LogiLedOpenRgbWriteUint32(SendBuffer, DeviceIndex);
+	LogiLedOpenRgbWriteUint32(SendBuffer, PacketId);
+	LogiLedOpenRgbWriteUint32(SendBuffer, PayloadSize);
+}
+
+
+bool FLogiLedOpenRgb::Receive()
+{
+	int32 NumRead = 0;
+
+	do
+	{
+		const int32 Offset = ReceiveBuffer.Num();
+		ReceiveBuffer.AddUninitialized(LogiLedOpenRgbReceiveChunkSize);
+
+		// false if the server closed the connection
+		const bool Received = Socket->Recv(ReceiveBuffer.GetData() + Offset, LogiLedOpenRgbReceiveChunkSize, NumRead);
+		ReceiveBuffer.SetNum(Offset + NumRead, false);
+
+		if (!Received)
+		{
+			return false;
+		}
+	}
+	while (NumRead == LogiLedOpenRgbReceiveChunkSize);
+
+	int32 Consumed = 0;
+
+	while (ReceiveBuffer.Num() - Consumed >= LogiLedOpenRgbHeaderSize)
+	{
+		const uint8* Header = ReceiveBuffer.GetData() + Consumed;
+
+		if (FMemory::Memcmp(Header, LogiLedOpenRgbMagic, sizeof(LogiLedOpenRgbMagic)) != 0)
+		{
+			UE_LOG(LogLogiLed, Warning, TEXT("Received invalid packet from OpenRGB server"));
+			return false;
+		}
+
+		FLogiLedOpenRgbReader Reader(Header + sizeof(LogiLedOpenRgbMagic), LogiLedOpenRgbHeaderSize - sizeof(LogiLedOpenRgbMagic));
+
+		const uint32 DeviceIndex = Reader.ReadUint32();
+		const uint32 PacketId = Reader.ReadUint32();
+		const uint32 Size = Reader.ReadUint32();
+
+		if (Size > LogiLedOpenRgbMaxPacketSize)
+		{
+			UE_LOG(LogLogiLed, Warning, TEXT("Received oversized packet from OpenRGB server"));
+			return false;
+		}
+
+		if ((uint32)(ReceiveBuffer.Num() - Consumed - LogiLedOpenRgbHeaderSize) < Size)
+		{
+			break;
+		}
+
+		HandlePacket(DeviceIndex, PacketId, Header + LogiLedOpenRgbHeaderSize, Size);
+		Consumed += LogiLedOpenRgbHeaderSize + Size;
+	}
+
+	ReceiveBuffer.RemoveAt(0, Consumed, false);
+
+	return true;
+}
+
+
+void FLogiLedOpenRgb::QueueUpdates(float DeltaTime)
+{
+	FLogiLedSnapshot::Get().Read(Colors);
+
+	TimeUntilSend -= DeltaTime;
+
+	// coalesce changes while the server does not keep up
+	if ((TimeUntilSend > 0.0f) || (SendBuffer.Num() > 0))
+	{
+		return;
+	}
+
+	TimeUntilSend = FMath::Max(TimeUntilSend + LogiLedOpenRgbSendInterval, 0.0f);
+
+	// convert the frame once, so that the LED tables are plain lookups
+	uint32 SumR = 0;
+	uint32 SumG = 0;
+	uint32 SumB = 0;
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		const FColor Color = FLogiLedSnapshot::ToDisplayColor(Colors[KeyIndex]);
+
+		KeyColors[KeyIndex] = (uint32)Color.R | ((uint32)Color.G << 8) | ((uint32)Color.B << 16);
+		SumR += Color.R;
+		SumG += Color.G;
+		SumB += Color.B;
+	}
+
+	KeyColors[LogiLedKeys::Count] = (SumR / LogiLedKeys::Count) | ((SumG / LogiLedKeys::Count) << 8) | ((SumB / LogiLedKeys::Count) << 16);
+
+	int32 NumPackets = 0;
+
+	for (int32 DeviceIndex = 0; DeviceIndex < Devices.Num(); ++DeviceIndex)
+	{
+		FDevice& Device = Devices[DeviceIndex];
+		const int32 NumLeds = Device.LedKeys.Num();
+
+		if (!Device.Valid || (NumLeds == 0))
+		{
+			continue;
+		}
+
+		const uint8* LedKeys = Device.LedKeys.GetData();
+		uint32* SentColors = Device.SentColors.GetData();
+
+		TArray<int32, TInlineAllocator<16>> ChangedZones;
+		int32 NumChangedLeds = 0;
+
+		for (int32 ZoneIndex = 0; ZoneIndex < Device.Zones.Num(); ++ZoneIndex)
+		{
+			const FZone& Zone = Device.Zones[ZoneIndex];
+
+			for (int32 LedIndex = Zone.FirstLed; LedIndex < Zone.FirstLed + Zone.NumLeds; ++LedIndex)
+			{
+				if (!Device.SentValid || (KeyColors[LedKeys[LedIndex]] != SentColors[LedIndex]))
+				{
+					ChangedZones.Add(ZoneIndex);
+					NumChangedLeds += Zone.NumLeds;
+
+					break;
+				}
+			}
+		}
+
+		if (NumChangedLeds == 0)
+		{
+			continue;
+		}
+
+		// one packet for the whole device is smaller than many zone packets
+		if (2 * NumChangedLeds > NumLeds)
+		{
+			QueueHeader(DeviceIndex, LogiLedOpenRgbUpdateLeds, 4 + 2 + 4 * NumLeds);
+			LogiLedOpenRgbWriteUint32(SendBuffer, 4 + 2 + 4 * NumLeds);
+			LogiLedOpenRgbWriteColors(SendBuffer, KeyColors, LedKeys, SentColors, NumLeds);
+			++NumPackets;
+		}
+		else
+		{
+			for (int32 ZoneIndex : ChangedZones)
+			{
+				const FZone& Zone = Device.Zones[ZoneIndex];
+
+				QueueHeader(DeviceIndex, LogiLedOpenRgbUpdateZoneLeds, 4 + 4 + 2 + 4 * Zone.NumLeds);
+				LogiLedOpenRgbWriteUint32(SendBuffer, 4 + 4 + 2 + 4 * Zone.NumLeds);
+				LogiLedOpenRgbWriteUint32(SendBuffer, ZoneIndex);
+				LogiLedOpenRgbWriteColors(SendBuffer, KeyColors, LedKeys + Zone.FirstLed, SentColors + Zone.FirstLed, Zone.NumLeds);
+				++NumPackets;
+			}
+		}
+
+		Device.SentValid = true;
+	}
+
+	UpdateRates(NumPackets, 0, 0.0f);
+	INC_DWORD_STAT_BY(STAT_LogiLedOpenRgbPackets, NumPackets);
+}
+
+
+void FLogiLedOpenRgb::UpdateRates(int32 NumPackets, int32 NumBytes, float DeltaTime)
+{
+	WindowPackets += NumPackets;
+	WindowBytes += NumBytes;
+	WindowSeconds += DeltaTime;
+
+	if (WindowSeconds >= 1.0f)
+	{
+		BytesPerSecond = WindowBytes / WindowSeconds;
+		PacketsPerSecond = WindowPackets / WindowSeconds;
+		WindowPackets = 0;
+		WindowBytes = 0;
+		WindowSeconds = 0.0f;
+
+		SET_FLOAT_STAT(STAT_LogiLedOpenRgbBytesPerSecond, BytesPerSecond);
+		SET_FLOAT_STAT(STAT_LogiLedOpenRgbPacketsPerSecond, PacketsPerSecond);
+	}
+}
@@ -0,0 +1,279 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "Math/Color.h"
+#include "Templates/SharedPointer.h"
+#include "Tickable.h"
+
+#include "LogiLedSnapshot.h"
+
+class FInternetAddr;
+class FSocket;
+
+
+/**
+ * Sends the LED manager's per-key lighting to an OpenRGB server.
+ *
+ * OpenRGB drives the lighting of devices from many vendors, and runs on
+ * platforms where the Logitech SDK is not available. The backend connects to
+ * the server's SDK port over TCP, enumerates its devices, and switches them to
+ * their custom mode. For each device, a table that maps its LEDs to keys is
+ * built once: keyboard LEDs are matched to keys by name, and all other LEDs
+ * show the average color of the keys.
+ *
+ * Frames are read from the snapshot, and only zones with changed LEDs are
+ * sent, batched into a single write per frame. The whole device is updated
+ * at once if most of its LEDs changed. While the server does not keep up,
+ * changes are coalesced until the pending packets have been written.
+ *
+ * The connection is retried periodically, so the server may be started after
+ * the game, and device list changes are picked up while connected.
+ */
+class FLogiLedOpenRgb
+	: public FTickableGameObject
+{
+public:
+
+	/** Default constructor. */
+	FLogiLedOpenRgb();
+
+public:
+
+	/**
+	 * Get the number of bytes sent per second, averaged over the last second.
+	 *
+	 * @return Bytes per second (TCP payload only).
+	 * @see GetPacketsPerSecond
+	 */
+	float GetBytesPerSecond() const
+	{
+		return BytesPerSecond;
+	}
+
+	/**
+	 * Get the number of LED update packets sent per second, averaged over the last second.
+	 *
+	 * @return Packets per second.
+	 * @see GetBytesPerSecond
+	 */
+	float GetPacketsPerSecond() const
+	{
+		return PacketsPerSecond;
+	}
+
+	/**
+	 * Check whether the backend is connected to a server.
+	 *
+	 * @return true if connected, false otherwise.
+	 */
+	bool IsConnected() const
+	{
+		return (State == EState::Connected);
+	}
+
+	/**
+	 * Check whether the backend is running.
+	 *
+	 * @return true if running, false otherwise.
+	 */
+	bool IsRunning() const
+	{
+		return (State != EState::Stopped);
+	}
+
+	/**
+	 * Start sending lighting to an OpenRGB server.
+	 *
+	 * Stops any previous connection.
+	 *
+	 * @param Address The server's IP address and optional port, i.e. 127.0.0.1:6742.
+	 * @return true on success, false if the address is invalid.
+	 * @see Stop
+	 */
+	bool Start(const FString& Address);
+
+	/**
+	 * Stop sending lighting.
+	 *
+	 * The devices keep their current lighting.
+	 *
+	 * @see Start
+	 */
+	void Stop();
+
+public:
+
+	//~ FTickableGameObject interface
+
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableInEditor() const override;
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+
+	/** Start connecting to the server. */
+	void Connect();
+
+	/**
+	 * Close the connection.
+	 *
+	 * @param Retry Whether to connect again after a while.
+	 */
+	void Disconnect(bool Retry);
+
+	/**
+	 * Write the pending packets to the socket.
+	 *
+	 * @return true on success, false if the connection was lost.
+	 */
+	bool Flush();
+
+	/**
+	 * Handle a packet from the server.
+	 *
+	 * @param DeviceIndex The device that the packet refers to.
+	 * @param PacketId The packet type.
+	 * @param Payload The packet's payload.
+	 * @param Size The payload size (in bytes).
+	 */
+	void HandlePacket(uint32 DeviceIndex, uint32 PacketId, const uint8* Payload, uint32 Size);
+
+	/**
+	 * Parse a device description and build its LED table.
+	 *
+	 * @param DeviceIndex The device's index.
+	 * @param Payload The device description.
+	 * @param Size The description size (in bytes).
+	 * @return true on success, false if the description is invalid.
+	 */
+	bool ParseDevice(uint32 DeviceIndex, const uint8* Payload, uint32 Size);
+
+	/**
+	 * Queue a packet header.
+	 *
+	 * The payload must be appended to the send buffer right after.
+	 *
+	 * @param DeviceIndex The device that the packet refers to.
+	 * @param PacketId The packet type.
+	 * @param PayloadSize The payload size (in bytes).
+	 */
+	void QueueHeader(uint32 DeviceIndex, uint32 PacketId, uint32 PayloadSize);
+
+	/**
+	 * Receive and handle all pending packets.
+	 *
+	 * @return true on success, false if the connection was lost.
+	 */
+	bool Receive();
+
+	/**
+	 * Queue updates for all LEDs that changed since they were last sent.
+	 *
+	 * @param DeltaTime Time since the last tick.
+	 */
+	void QueueUpdates(float DeltaTime);
+
+	/**
+	 * Update the rate statistics.
+	 *
+	 * @param NumPackets Number of LED update packets sent this tick.
+	 * @param NumBytes Number of bytes sent this tick.
+	 * @param DeltaTime Time since the last tick.
+	 */
+	void UpdateRates(int32 NumPackets, int32 NumBytes, float DeltaTime);
+
+private:
+
+	/** Connection states. */
+	enum class EState : uint8
+	{
+		Stopped,
+		Disconnected,
+		Connecting,
+		Connected
+	};
+
+	/** A zone of LEDs on a device. */
+	struct FZone
+	{
+		/** Index of the zone's first LED on the device. */
+		int32 FirstLed;
+
+		/** Number of LEDs in the zone. */
+		int32 NumLeds;
+	};
+
+	/** A device on the server. */
+	struct FDevice
+	{
+		/** Default constructor. */
+		FDevice()
+			: Valid(false)
+			, SentValid(false)
+		{ }
+
+		/** The device's zones, in LED order. */
+		TArray<FZone> Zones;
+
+		/** The key that each LED shows (LogiLedKeys::Count = average of all keys). */
+		TArray<uint8> LedKeys;
+
+		/** The colors that were last sent to each LED (0x00BBGGRR). */
+		TArray<uint32> SentColors;
+
+		/** Whether the device description was received. */
+		bool Valid;
+
+		/** Whether SentColors matches the device (false = send all LEDs). */
+		bool SentValid;
+	};
+
+	/** The current connection state. */
+	EState State;
+
+	/** The socket (only valid while connecting or connected). */
+	FSocket* Socket;
+
+	/** The server's address (only valid while running). */
+	TSharedPtr<FInternetAddr> ServerAddress;
+
+	/** The server's devices, indexed like on the server. */
+	TArray<FDevice> Devices;
+
+	/** The most recently read frame (percentages). */
+	FColor Colors[FLogiLedSnapshot::MaxKeys];
+
+	/** The colors of the current frame (0x00BBGGRR), followed by their average. */
+	uint32 KeyColors[FLogiLedSnapshot::MaxKeys + 1];
+
+	/** Packets that were queued but not written yet. */
+	TArray<uint8> SendBuffer;
+
+	/** Bytes that were received but not handled yet. */
+	TArray<uint8> ReceiveBuffer;
+
+	/** Time until the next connection attempt, or until the current attempt times out (in seconds). */
+	float TimeUntilConnect;
+
+	/** Time until the next frame may be sent (in seconds). */
+	float TimeUntilSend;
+
+	/** Number of LED update packets sent in the current measurement window. */
+	int32 WindowPackets;
+
+	/** Number of bytes sent in the current measurement window. */
+	int32 WindowBytes;
+
+	/** Duration of the current measurement window (in seconds). */
+	float WindowSeconds;
+
+	/** Bytes sent per second in the last measurement window. */
+	float BytesPerSecond;
+
+	/** LED update packets sent per second in the last measurement window. */
+	float PacketsPerSecond;
+};
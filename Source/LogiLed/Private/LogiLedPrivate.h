@@ -5,6 +5,8 @@
 #define LOGILED_SUPPORTED_PLATFORM (PLATFORM_WINDOWS)
 
 #include "Logging/LogMacros.h"
+#include "Stats/Stats.h"
 
 
 DECLARE_LOG_CATEGORY_EXTERN(LogLogiLed, Log, All);
+DECLARE_STATS_GROUP(TEXT("LogiLed"), STATGROUP_LogiLed, STATCAT_Advanced);
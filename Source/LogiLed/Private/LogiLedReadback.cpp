@@ -0,0 +1,162 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedReadback.h"
+#include "LogiLedPrivate.h"
+
+#include "Misc/ScopeLock.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "TextureResource.h"
+
+#include "LogitechLEDLib.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Readbacks"), STAT_LogiLedReadbacks, STATGROUP_LogiLed);
+
+
+/* FLogiLedReadback structors
+ *****************************************************************************/
+
+FLogiLedReadback::FLogiLedReadback()
+	: StagingSize(0, 0)
+	, NextStagingTexture(0)
+	, NumPending(0)
+	, ResultSize(0, 0)
+	, HasResult(false)
+{ }
+
+
+/* FLogiLedReadback interface
+ *****************************************************************************/
+
+bool FLogiLedReadback::GetResult(TArray<FColor>& OutPixels)
+{
+	FIntPoint Size;
+
+	return GetResult(OutPixels, Size) && (Size == FIntPoint(LOGI_LED_BITMAP_WIDTH, LOGI_LED_BITMAP_HEIGHT));
+}
+
+
+bool FLogiLedReadback::GetResult(TArray<FColor>& OutPixels, FIntPoint& OutSize)
+{
+	FScopeLock Lock(&ResultLock);
+
+	if (!HasResult)
+	{
+		return false;
+	}
+
+	OutPixels = Result;
+	OutSize = ResultSize;
+	HasResult = false;
+
+	return true;
+}
+
+
+void FLogiLedReadback::ReleaseResources()
+{
+	TSharedRef<FLogiLedReadback, ESPMode::ThreadSafe> Readback = AsShared();
+
+	ENQUEUE_RENDER_COMMAND(LogiLedReleaseReadback)(
+		[Readback](FRHICommandListImmediate& RHICmdList)
+		{
+			for (FTexture2DRHIRef& StagingTexture : Readback->StagingTextures)
+			{
+				StagingTexture.SafeRelease();
+			}
+
+			Readback->StagingSize = FIntPoint(0, 0);
+			Readback->NumPending = 0;
+		});
+}
+
+
+void FLogiLedReadback::Request(FTextureRenderTargetResource* Resource)
+{
+	if (Resource == nullptr)
+	{
+		return;
+	}
+
+	TSharedRef<FLogiLedReadback, ESPMode::ThreadSafe> Readback = AsShared();
+
+	ENQUEUE_RENDER_COMMAND(LogiLedRequestReadback)(
+		[Readback, Resource](FRHICommandListImmediate& RHICmdList)
+		{
+			Readback->RenderThread_Request(RHICmdList, Resource->GetRenderTargetTexture());
+		});
+}
+
+
+void FLogiLedReadback::RenderThread_Request(FRHICommandListImmediate& RHICmdList, FTexture2DRHIParamRef SourceTexture)
+{
+	check(IsInRenderingThread());
+
+	if (SourceTexture == nullptr)
+	{
+		return;
+	}
+
+	const FIntPoint Size(SourceTexture->GetSizeX(), SourceTexture->GetSizeY());
+
+	if (Size != StagingSize)
+	{
+		for (FTexture2DRHIRef& OldStagingTexture : StagingTextures)
+		{
+			OldStagingTexture.SafeRelease();
+		}
+
+		StagingSize = Size;
+		NextStagingTexture = 0;
+		NumPending = 0;
+	}
+
+	FTexture2DRHIRef& StagingTexture = StagingTextures[NextStagingTexture];
+
+	if (!StagingTexture.IsValid())
+	{
+		FRHIResourceCreateInfo CreateInfo;
+		StagingTexture = RHICreateTexture2D(Size.X, Size.Y, PF_B8G8R8A8, 1, 1, TexCreate_CPUReadback, CreateInfo);
+	}
+
+	RHICmdList.CopyToResolveTarget(SourceTexture, StagingTexture, true, FResolveParams());
+
+	NextStagingTexture = (NextStagingTexture + 1) % NumStagingTextures;
+	++NumPending;
+
+	if (NumPending <= Latency)
+	{
+		return;
+	}
+
+	// the oldest copy has had enough frames to complete
+	const int32 OldestIndex = (NextStagingTexture + NumStagingTextures - NumPending) % NumStagingTextures;
+	--NumPending;
+
+	void* Data = nullptr;
+	int32 Width = 0;
+	int32 Height = 0;
+
+	RHICmdList.MapStagingSurface(StagingTextures[OldestIndex], Data, Width, Height);
+
+	if (Data != nullptr)
+	{
+		const FColor* Pixels = (const FColor*)Data;
+
+		FScopeLock Lock(&ResultLock);
+		Result.SetNumUninitialized(StagingSize.X * StagingSize.Y, false);
+		ResultSize = StagingSize;
+
+		// rows may be padded
+		for (int32 Row = 0; Row < StagingSize.Y; ++Row)
+		{
+			FMemory::Memcpy(&Result[Row * StagingSize.X], Pixels + Row * Width, StagingSize.X * sizeof(FColor));
+		}
+
+		HasResult = true;
+		INC_DWORD_STAT(STAT_LogiLedReadbacks);
+	}
+
+	RHICmdList.UnmapStagingSurface(StagingTextures[OldestIndex]);
+}
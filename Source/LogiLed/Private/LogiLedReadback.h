@@ -0,0 +1,101 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "RHIResources.h"
+#include "Templates/SharedPointer.h"
+
+class FTextureRenderTargetResource;
+
+
+/**
+ * Reads back the pixels of a lighting render target without stalling.
+ *
+ * Each request copies the render target into one of a small ring of staging
+ * textures on the render thread. A staging texture is only mapped once newer
+ * copies have been queued behind it, at which point the GPU has finished with
+ * it, so neither the game thread nor the render thread ever wait for the GPU.
+ * The most recent result can be picked up on the game thread.
+ */
+class FLogiLedReadback
+	: public TSharedFromThis<FLogiLedReadback, ESPMode::ThreadSafe>
+{
+public:
+
+	/** Default constructor. */
+	FLogiLedReadback();
+
+public:
+
+	/**
+	 * Get the most recent pixels that were read back from a key bitmap sized texture.
+	 *
+	 * @param OutPixels Will contain the pixels, in rows of LOGI_LED_BITMAP_WIDTH.
+	 * @return true if new pixels were available, false otherwise.
+	 */
+	bool GetResult(TArray<FColor>& OutPixels);
+
+	/**
+	 * Get the most recent pixels that were read back, and their size.
+	 *
+	 * @param OutPixels Will contain the pixels, in rows.
+	 * @param OutSize Will contain the width and height of the pixels.
+	 * @return true if new pixels were available, false otherwise.
+	 */
+	bool GetResult(TArray<FColor>& OutPixels, FIntPoint& OutSize);
+
+	/** Release the staging textures (must be called on the game thread). */
+	void ReleaseResources();
+
+	/**
+	 * Queue a copy of the given render target (must be called on the game thread).
+	 *
+	 * @param Resource The render target resource to read back.
+	 */
+	void Request(FTextureRenderTargetResource* Resource);
+
+	/**
+	 * Copy the given texture into the next staging texture, and map the oldest one if it is ready.
+	 *
+	 * The whole texture is read back. When its size changes, the staging textures
+	 * are recreated, and pending copies are dropped (must be called on the render thread).
+	 *
+	 * @param RHICmdList The command list to use.
+	 * @param SourceTexture The texture to copy.
+	 */
+	void RenderThread_Request(FRHICommandListImmediate& RHICmdList, FTexture2DRHIParamRef SourceTexture);
+
+private:
+
+	/** Number of staging textures in the ring. */
+	static const int32 NumStagingTextures = 3;
+
+	/** Number of newer copies that must be queued behind a staging texture before it is mapped. */
+	static const int32 Latency = NumStagingTextures - 1;
+
+	/** The staging textures (render thread only). */
+	FTexture2DRHIRef StagingTextures[NumStagingTextures];
+
+	/** Size of the staging textures (render thread only). */
+	FIntPoint StagingSize;
+
+	/** Index of the staging texture to copy into next (render thread only). */
+	int32 NextStagingTexture;
+
+	/** Number of staging textures that were copied into but not mapped yet (render thread only). */
+	int32 NumPending;
+
+	/** The most recent pixels that were read back. */
+	TArray<FColor> Result;
+
+	/** Size of the result. */
+	FIntPoint ResultSize;
+
+	/** Whether the result was updated since it was last picked up. */
+	bool HasResult;
+
+	/** Protects the result. */
+	FCriticalSection ResultLock;
+};
@@ -0,0 +1,351 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedSdk.h"
+#include "LogiLedPrivate.h"
+
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#include "LogitechLEDLib.h"
+
+
+/** Minimum time between two failure summaries for the same entry point (in seconds). */
+static const double LogiLedFailureLogInterval = 1.0;
+
+/** Number of failed calls within the failure window after which the connection is considered lost. */
+static const int32 LogiLedLostConnectionFailures = 16;
+
+/** Initial and maximum delay between two connection attempts (in seconds). */
+static const float LogiLedInitialRetryDelay = 1.0f;
+static const float LogiLedMaxRetryDelay = 30.0f;
+
+/** Initial and maximum time between two reconnects that are forced by failing calls (in seconds). */
+static const double LogiLedInitialReconnectBackoff = 10.0;
+static const double LogiLedMaxReconnectBackoff = 300.0;
+
+/** Time at which connecting was started. */
+static double LogiLedConnectStartTime = 0.0;
+
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SDK Init Time (ms)"), STAT_LogiLedSdkInitTime, STATGROUP_LogiLed);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SDK Connect Time (ms)"), STAT_LogiLedSdkConnectTime, STATGROUP_LogiLed);
+
+
+/* FLogiLedSdkConnector
+ *****************************************************************************/
+
+/**
+ * Runnable that (re-)initializes the Logitech LED SDK in the background.
+ */
+class FLogiLedSdkConnector
+	: public FRunnable
+{
+public:
+
+	/** Default constructor. */
+	FLogiLedSdkConnector()
+		: WakeEvent(FPlatformProcess::GetSynchEventFromPool())
+	{ }
+
+	/** Virtual destructor. */
+	virtual ~FLogiLedSdkConnector()
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+	}
+
+public:
+
+	/** Wake up the connector thread, i.e. after the connection was lost. */
+	void Wake()
+	{
+		WakeEvent->Trigger();
+	}
+
+public:
+
+	//~ FRunnable interface
+
+	virtual uint32 Run() override
+	{
+		bool Initialized = false;
+		float RetryDelay = LogiLedInitialRetryDelay;
+
+		while (!Stopping)
+		{
+			// the game thread makes no SDK calls while connecting
+			if (FLogiLedSdk::GetState() == ELogiLedSdkState::Connecting)
+			{
+				if (Initialized)
+				{
+					::LogiLedShutdown();
+					Initialized = false;
+				}
+
+				const double InitStartTime = FPlatformTime::Seconds();
+
+				if (!::LogiLedInit())
+				{
+					UE_LOG(LogLogiLed, Verbose, TEXT("Failed to initialize Logitech LED SDK, retrying in %.0f seconds"), RetryDelay);
+
+					WakeEvent->Wait((uint32)(RetryDelay * 1000.0f));
+					RetryDelay = FMath::Min(RetryDelay * 2.0f, LogiLedMaxRetryDelay);
+
+					continue;
+				}
+
+				const double Now = FPlatformTime::Seconds();
+				const float InitMilliseconds = (float)((Now - InitStartTime) * 1000.0);
+				const float ConnectMilliseconds = (float)((Now - LogiLedConnectStartTime) * 1000.0);
+
+				int Major, Minor, Build;
+
+				if (::LogiLedGetSdkVersion(&Major, &Minor, &Build))
+				{
+					UE_LOG(LogLogiLed, Log, TEXT("Initialized Logitech LED SDK %i.%i.%i in %.1f ms (%.1f ms after connecting started)."), Major, Minor, Build, InitMilliseconds, ConnectMilliseconds);
+				}
+				else
+				{
+					UE_LOG(LogLogiLed, Log, TEXT("Initialized Logitech LED SDK (unknown version) in %.1f ms (%.1f ms after connecting started)."), InitMilliseconds, ConnectMilliseconds);
+				}
+
+				Initialized = true;
+				RetryDelay = LogiLedInitialRetryDelay;
+
+				SetState(ELogiLedSdkState::Connected);
+
+				AsyncTask(ENamedThreads::GameThread, [InitMilliseconds, ConnectMilliseconds]() {
+					SET_FLOAT_STAT(STAT_LogiLedSdkInitTime, InitMilliseconds);
+					SET_FLOAT_STAT(STAT_LogiLedSdkConnectTime, ConnectMilliseconds);
+
+					if (FLogiLedSdk::IsAvailable())
+					{
+						FLogiLedSdk::OnConnected().Broadcast();
+					}
+				});
+			}
+
+			WakeEvent->Wait();
+		}
+
+		if (Initialized)
+		{
+			::LogiLedShutdown();
+		}
+
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		Stopping = true;
+		WakeEvent->Trigger();
+	}
+
+public:
+
+	/** Set the connection state. */
+	static void SetState(ELogiLedSdkState NewState)
+	{
+		State.Set((int32)NewState);
+	}
+
+	/** The current connection state. */
+	static FThreadSafeCounter State;
+
+private:
+
+	/** Whether the thread should stop. */
+	FThreadSafeBool Stopping;
+
+	/** Event used to wake up the thread. */
+	FEvent* WakeEvent;
+};
+
+
+FThreadSafeCounter FLogiLedSdkConnector::State((int32)ELogiLedSdkState::Disconnected);
+
+
+/* Local state
+ *****************************************************************************/
+
+/** The background connector, if connecting is in progress or has finished. */
+static FLogiLedSdkConnector* LogiLedConnector = nullptr;
+
+/** The connector's thread. */
+static FRunnableThread* LogiLedConnectorThread = nullptr;
+
+/** Number of failed SDK calls in the current failure window. */
+static int32 LogiLedRecentFailures = 0;
+
+/** Time at which the current failure window started. */
+static double LogiLedFailureWindowStart = 0.0;
+
+/** Whether a reconnect was scheduled on the game thread, but has not happened yet. */
+static bool LogiLedReconnectPending = false;
+
+/** Time between the last forced reconnect and the next one. */
+static double LogiLedReconnectBackoff = LogiLedInitialReconnectBackoff;
+
+/** Time before which no reconnect is forced. */
+static double LogiLedNextReconnectTime = 0.0;
+
+
+/* FLogiLedSdk interface
+ *****************************************************************************/
+
+void FLogiLedSdk::Connect()
+{
+#if LOGILED_SUPPORTED_PLATFORM
+	if (LogiLedConnector != nullptr)
+	{
+		return;
+	}
+
+	LogiLedConnectStartTime = FPlatformTime::Seconds();
+
+	FLogiLedSdkConnector::SetState(ELogiLedSdkState::Connecting);
+	LogiLedConnector = new FLogiLedSdkConnector();
+
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		LogiLedConnectorThread = FRunnableThread::Create(LogiLedConnector, TEXT("FLogiLedSdkConnector"), 0, TPri_Lowest);
+	}
+	else if (::LogiLedInit())
+	{
+		FLogiLedSdkConnector::SetState(ELogiLedSdkState::Connected);
+		OnConnected().Broadcast();
+	}
+	else
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to initialize Logitech LED SDK"));
+		FLogiLedSdkConnector::SetState(ELogiLedSdkState::Disconnected);
+	}
+#endif //LOGILED_SUPPORTED_PLATFORM
+}
+
+
+void FLogiLedSdk::Disconnect()
+{
+	if (LogiLedConnector == nullptr)
+	{
+		return;
+	}
+
+#if LOGILED_SUPPORTED_PLATFORM
+	const bool WasConnected = IsAvailable();
+#endif
+
+	FLogiLedSdkConnector::SetState(ELogiLedSdkState::Disconnected);
+
+	if (LogiLedConnectorThread != nullptr)
+	{
+		// the thread shuts down the SDK when it exits
+		LogiLedConnectorThread->Kill(true);
+		delete LogiLedConnectorThread;
+		LogiLedConnectorThread = nullptr;
+	}
+#if LOGILED_SUPPORTED_PLATFORM
+	else if (WasConnected)
+	{
+		::LogiLedShutdown();
+	}
+#endif
+
+	delete LogiLedConnector;
+	LogiLedConnector = nullptr;
+}
+
+
+ELogiLedSdkState FLogiLedSdk::GetState()
+{
+	return (ELogiLedSdkState)FLogiLedSdkConnector::State.GetValue();
+}
+
+
+void FLogiLedSdk::ReportFailure()
+{
+	check(IsInGameThread());
+
+	const double Now = FPlatformTime::Seconds();
+
+	if (Now - LogiLedFailureWindowStart > 1.0)
+	{
+		LogiLedFailureWindowStart = Now;
+		LogiLedRecentFailures = 0;
+	}
+
+	if ((++LogiLedRecentFailures < LogiLedLostConnectionFailures) || !IsAvailable() || (LogiLedConnectorThread == nullptr) || LogiLedReconnectPending)
+	{
+		return;
+	}
+
+	LogiLedRecentFailures = 0;
+
+	// reconnecting does not help if calls keep failing for other reasons, so reconnects back off
+	if (Now < LogiLedNextReconnectTime)
+	{
+		return;
+	}
+
+	// ...unless the connection was fine for a while
+	if (Now - LogiLedNextReconnectTime > LogiLedMaxReconnectBackoff)
+	{
+		LogiLedReconnectBackoff = LogiLedInitialReconnectBackoff;
+	}
+
+	UE_LOG(LogLogiLed, Log, TEXT("Lost connection to Logitech LED SDK, reconnecting (next forced reconnect in %.0f seconds at the earliest)"), LogiLedReconnectBackoff);
+
+	LogiLedNextReconnectTime = Now + LogiLedReconnectBackoff;
+	LogiLedReconnectBackoff = FMath::Min(LogiLedReconnectBackoff * 2.0, LogiLedMaxReconnectBackoff);
+	LogiLedReconnectPending = true;
+
+	// the caller may still be making SDK calls, so the connector must not shut down the SDK before they are done
+	AsyncTask(ENamedThreads::GameThread, []() {
+		LogiLedReconnectPending = false;
+
+		if (FLogiLedSdk::IsAvailable() && (LogiLedConnector != nullptr))
+		{
+			FLogiLedSdkConnector::SetState(ELogiLedSdkState::Connecting);
+			LogiLedConnector->Wake();
+		}
+	});
+}
+
+
+/* FLogiLedFailureCounter interface
+ *****************************************************************************/
+
+void FLogiLedFailureCounter::Add()
+{
+	++Count;
+
+	if (SignalsLostConnection)
+	{
+		FLogiLedSdk::ReportFailure();
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	if (Now >= NextLogTime)
+	{
+		Flush();
+		NextLogTime = Now + LogiLedFailureLogInterval;
+	}
+}
+
+
+void FLogiLedFailureCounter::Flush()
+{
+	if (Count > 0)
+	{
+		UE_LOG(LogLogiLed, Verbose, TEXT("%s failed %i times"), EntryPoint, Count);
+		Count = 0;
+	}
+}
@@ -0,0 +1,168 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Delegates/Delegate.h"
+
+
+/**
+ * Enumerates connection states of the Logitech LED SDK.
+ */
+enum class ELogiLedSdkState : uint8
+{
+	/** Not connected, and not trying to connect. */
+	Disconnected,
+
+	/** Trying to (re-)connect in the background. */
+	Connecting,
+
+	/** Connected and accepting calls. */
+	Connected
+};
+
+
+/**
+ * Tracks the connection to the Logitech LED SDK.
+ *
+ * Connecting happens on a background thread, which keeps retrying with an
+ * increasing delay until Logitech Gaming Software or G HUB is available. When
+ * SDK calls keep failing while connected, the connection is considered lost
+ * and the background thread re-initializes the SDK.
+ *
+ * The background thread only calls LogiLedInit, LogiLedGetSdkVersion and
+ * LogiLedShutdown, and only while the state is Connecting (or while Disconnect
+ * waits for it to exit). All other SDK calls must be made from the game thread,
+ * and only while the SDK is available. The state only leaves Connected on the
+ * game thread, in Disconnect or in a reconnect that ReportFailure schedules for
+ * the game thread's next task update, so the background thread never starts
+ * while a game thread call is in progress. Callers should check IsAvailable
+ * before doing any work for an SDK call, so that nothing is computed or logged
+ * while the SDK is down.
+ */
+class FLogiLedSdk
+{
+public:
+
+	/**
+	 * Start connecting to the SDK in the background.
+	 *
+	 * @see Disconnect, GetState, OnConnected
+	 */
+	static void Connect();
+
+	/**
+	 * Stop connecting to the SDK and shut it down.
+	 *
+	 * @see Connect
+	 */
+	static void Disconnect();
+
+	/**
+	 * Get the current connection state.
+	 *
+	 * @return Connection state.
+	 * @see IsAvailable
+	 */
+	static ELogiLedSdkState GetState();
+
+	/**
+	 * Check whether the SDK is connected and accepting calls.
+	 *
+	 * @return true if available, false otherwise.
+	 * @see GetState
+	 */
+	static bool IsAvailable()
+	{
+		return (GetState() == ELogiLedSdkState::Connected);
+	}
+
+	/**
+	 * Convert a string for SDK calls, which take wchar_t strings.
+	 *
+	 * TCHAR is wchar_t on all platforms that the SDK supports. Elsewhere, the SDK
+	 * functions are stubs that never read their arguments.
+	 *
+	 * @param String The string to convert.
+	 * @return The SDK string.
+	 */
+	static wchar_t* ToSdkString(const TCHAR* String)
+	{
+		return (wchar_t*)String;
+	}
+
+	/**
+	 * Notify the connection that an SDK call failed.
+	 *
+	 * Must be called on the game thread, and only for failures that indicate a
+	 * lost connection. If too many calls fail in a short time, the connection
+	 * is considered lost and will be re-established once the
+	 * current game thread work has finished, so that the SDK is not shut down
+	 * while the caller is still making calls.
+	 */
+	static void ReportFailure();
+
+public:
+
+	/** Get a delegate that is executed on the game thread when the SDK has been (re-)connected. */
+	DECLARE_MULTICAST_DELEGATE(FOnConnected);
+	static FOnConnected& OnConnected()
+	{
+		// function local, because the delegate may be bound during static initialization
+		static FOnConnected ConnectedDelegate;
+		return ConnectedDelegate;
+	}
+};
+
+
+/**
+ * Counts failed SDK calls for an entry point and periodically logs a summary.
+ *
+ * Failures are only counted on the hot path. A single log message with the
+ * number of failures is emitted at most once per second, and the message
+ * arguments are static strings, so failing calls never allocate.
+ *
+ * Only entry points that affect all keys can tell a lost connection apart from
+ * other failures. Calls for single keys or config options also fail for keys
+ * that the device does not have or options that are not registered, so their
+ * failures are not reported to FLogiLedSdk.
+ */
+class FLogiLedFailureCounter
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InEntryPoint Name of the entry point to count failures for (must be a static string).
+	 * @param InSignalsLostConnection Whether failures of the entry point indicate that the connection to the SDK was lost.
+	 */
+	FLogiLedFailureCounter(const TCHAR* InEntryPoint, bool InSignalsLostConnection)
+		: Count(0)
+		, EntryPoint(InEntryPoint)
+		, NextLogTime(0.0)
+		, SignalsLostConnection(InSignalsLostConnection)
+	{ }
+
+public:
+
+	/** Count a failure, and log a summary if the log interval has elapsed. */
+	void Add();
+
+	/** Log any failures that have not been logged yet. */
+	void Flush();
+
+private:
+
+	/** Number of failures since the last summary. */
+	int32 Count;
+
+	/** Name of the entry point. */
+	const TCHAR* EntryPoint;
+
+	/** Time at which the next summary may be logged. */
+	double NextLogTime;
+
+	/** Whether failures are reported to FLogiLedSdk. */
+	bool SignalsLostConnection;
+};
@@ -0,0 +1,172 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedPrivate.h"
+
+#if !LOGILED_SUPPORTED_PLATFORM
+
+#include "LogitechLEDLib.h"
+
+
+/* Logitech SDK stubs
+ *
+ * The SDK only ships for Windows. On other platforms, the plugin still runs
+ * without hardware, so that lighting can be previewed and dumped on machines
+ * without Logitech devices. The SDK never connects there, so these functions
+ * are never called; they only satisfy the linker.
+ *****************************************************************************/
+
+bool LogiLedInit()
+{
+	return false;
+}
+
+
+bool LogiLedGetSdkVersion(int *majorNum, int *minorNum, int *buildNum)
+{
+	return false;
+}
+
+
+bool LogiLedGetConfigOptionNumber(const wchar_t *configPath, double *defaultValue)
+{
+	return false;
+}
+
+
+bool LogiLedGetConfigOptionBool(const wchar_t *configPath, bool *defaultValue)
+{
+	return false;
+}
+
+
+bool LogiLedGetConfigOptionColor(const wchar_t *configPath, int *defaultRed, int *defaultGreen, int *defaultBlue)
+{
+	return false;
+}
+
+
+bool LogiLedGetConfigOptionKeyInput(const wchar_t *configPath, wchar_t *defaultValue, int bufferSize)
+{
+	return false;
+}
+
+
+bool LogiLedSetConfigOptionLabel(const wchar_t *configPath, wchar_t *label)
+{
+	return false;
+}
+
+
+bool LogiLedSetTargetDevice(int targetDevice)
+{
+	return false;
+}
+
+
+bool LogiLedSaveCurrentLighting()
+{
+	return false;
+}
+
+
+bool LogiLedSetLighting(int redPercentage, int greenPercentage, int bluePercentage)
+{
+	return false;
+}
+
+
+bool LogiLedRestoreLighting()
+{
+	return false;
+}
+
+
+bool LogiLedFlashLighting(int redPercentage, int greenPercentage, int bluePercentage, int milliSecondsDuration, int milliSecondsInterval)
+{
+	return false;
+}
+
+
+bool LogiLedPulseLighting(int redPercentage, int greenPercentage, int bluePercentage, int milliSecondsDuration, int milliSecondsInterval)
+{
+	return false;
+}
+
+
+bool LogiLedStopEffects()
+{
+	return false;
+}
+
+
+bool LogiLedSetLightingFromBitmap(unsigned char bitmap[])
+{
+	return false;
+}
+
+
+bool LogiLedSetLightingForKeyWithScanCode(int keyCode, int redPercentage, int greenPercentage, int bluePercentage)
+{
+	return false;
+}
+
+
+bool LogiLedSetLightingForKeyWithHidCode(int keyCode, int redPercentage, int greenPercentage, int bluePercentage)
+{
+	return false;
+}
+
+
+bool LogiLedSetLightingForKeyWithQuartzCode(int keyCode, int redPercentage, int greenPercentage, int bluePercentage)
+{
+	return false;
+}
+
+
+bool LogiLedSetLightingForKeyWithKeyName(LogiLed::KeyName keyName, int redPercentage, int greenPercentage, int bluePercentage)
+{
+	return false;
+}
+
+
+bool LogiLedSaveLightingForKey(LogiLed::KeyName keyName)
+{
+	return false;
+}
+
+
+bool LogiLedRestoreLightingForKey(LogiLed::KeyName keyName)
+{
+	return false;
+}
+
+
+bool LogiLedExcludeKeysFromBitmap(LogiLed::KeyName *keyList, int listCount)
+{
+	return false;
+}
+
+
+bool LogiLedFlashSingleKey(LogiLed::KeyName keyName, int redPercentage, int greenPercentage, int bluePercentage, int msDuration, int msInterval)
+{
+	return false;
+}
+
+
+bool LogiLedPulseSingleKey(LogiLed::KeyName keyName, int startRedPercentage, int startGreenPercentage, int startBluePercentage, int finishRedPercentage, int finishGreenPercentage, int finishBluePercentage, int msDuration, bool isInfinite)
+{
+	return false;
+}
+
+
+bool LogiLedStopEffectsOnKey(LogiLed::KeyName keyName)
+{
+	return false;
+}
+
+
+void LogiLedShutdown()
+{ }
+
+
+#endif //!LOGILED_SUPPORTED_PLATFORM
@@ -0,0 +1,169 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedSharedFrame.h"
+#include "LogiLedPrivate.h"
+
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/UnrealMemory.h"
+#include "Misc/DateTime.h"
+#include "Misc/Timespan.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shared Frames Published"), STAT_LogiLedSharedFramesPublished, STATGROUP_LogiLed);
+
+
+static_assert(sizeof(FLogiLedSharedFrameData) == 24 + 4 * FLogiLedSnapshot::MaxKeys, "The shared frame layout must not contain padding");
+
+
+const TCHAR* FLogiLedSharedFrame::DefaultName = TEXT("LogiLedFrame");
+
+
+/* FLogiLedSharedFrame static functions
+ *****************************************************************************/
+
+FLogiLedSharedFrame& FLogiLedSharedFrame::Get()
+{
+	static FLogiLedSharedFrame SharedFrame;
+	return SharedFrame;
+}
+
+
+bool FLogiLedSharedFrame::Read(const FLogiLedSharedFrameData& Shared, FLogiLedSharedFrameData& OutFrame, int32 MaxAttempts)
+{
+	const volatile uint32* Sequence = &Shared.Sequence;
+
+	for (int32 Attempt = 0; Attempt < MaxAttempts; ++Attempt)
+	{
+		const uint32 SequenceBefore = *Sequence;
+		FPlatformMisc::MemoryBarrier();
+
+		// a frame is being written
+		if ((SequenceBefore & 1) != 0)
+		{
+			continue;
+		}
+
+		FMemory::Memcpy(&OutFrame, &Shared, sizeof(FLogiLedSharedFrameData));
+		FPlatformMisc::MemoryBarrier();
+
+		// the copy is consistent if no frame was written in the meantime
+		if (*Sequence == SequenceBefore)
+		{
+			OutFrame.Sequence = SequenceBefore;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void FLogiLedSharedFrame::Write(FLogiLedSharedFrameData& Shared, const FColor* Colors, int32 NumColors, uint64 Timestamp)
+{
+	check(NumColors <= FLogiLedSnapshot::MaxKeys);
+
+	volatile int32* Sequence = (volatile int32*)&Shared.Sequence;
+	const uint32 SequenceBefore = Shared.Sequence;
+
+	// the exchanges are full barriers, so readers see the odd sequence before any color, and all colors before the even one
+	FPlatformAtomics::InterlockedExchange(Sequence, (int32)(SequenceBefore + 1));
+
+	Shared.Timestamp = Timestamp;
+	Shared.NumKeys = NumColors;
+
+	for (int32 KeyIndex = 0; KeyIndex < NumColors; ++KeyIndex)
+	{
+		const FColor& Color = Colors[KeyIndex];
+		uint8* SharedColor = Shared.Colors[KeyIndex];
+
+		SharedColor[0] = Color.R;
+		SharedColor[1] = Color.G;
+		SharedColor[2] = Color.B;
+		SharedColor[3] = Color.A;
+	}
+
+	FPlatformAtomics::InterlockedExchange(Sequence, (int32)(SequenceBefore + 2));
+}
+
+
+/* FLogiLedSharedFrame structors
+ *****************************************************************************/
+
+FLogiLedSharedFrame::FLogiLedSharedFrame()
+	: Region(nullptr)
+	, Data(nullptr)
+{
+	FMemory::Memzero(DisplayColors);
+}
+
+
+/* FLogiLedSharedFrame interface
+ *****************************************************************************/
+
+bool FLogiLedSharedFrame::Open(const FString& Name)
+{
+	Close();
+
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(
+		Name,
+		true,
+		(uint32)FPlatformMemory::ESharedMemoryAccess::Read | (uint32)FPlatformMemory::ESharedMemoryAccess::Write,
+		sizeof(FLogiLedSharedFrameData));
+
+	if (Region == nullptr)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to map shared LED frame %s"), *Name);
+		return false;
+	}
+
+	Data = (FLogiLedSharedFrameData*)Region->GetAddress();
+
+	FMemory::Memzero(*Data);
+	Data->Magic = LogiLedSharedFrameMagic;
+	Data->Version = LogiLedSharedFrameVersion;
+
+	// the manager publishes frames only while someone is watching
+	FLogiLedSnapshot::Get().AddViewer();
+
+	UE_LOG(LogLogiLed, Log, TEXT("Exporting LED frames to shared memory %s"), *Name);
+
+	return true;
+}
+
+
+void FLogiLedSharedFrame::Close()
+{
+	if (Region == nullptr)
+	{
+		return;
+	}
+
+	FLogiLedSnapshot::Get().RemoveViewer();
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+
+	Region = nullptr;
+	Data = nullptr;
+}
+
+
+void FLogiLedSharedFrame::Publish(const FColor* Colors)
+{
+	if (Data == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumKeys = FLogiLedSnapshot::GetNumKeys();
+
+	for (int32 KeyIndex = 0; KeyIndex < NumKeys; ++KeyIndex)
+	{
+		DisplayColors[KeyIndex] = FLogiLedSnapshot::ToDisplayColor(Colors[KeyIndex]);
+	}
+
+	const FDateTime UnixEpoch(1970, 1, 1);
+	const uint64 Timestamp = (uint64)((FDateTime::UtcNow() - UnixEpoch).GetTicks() / ETimespan::TicksPerMicrosecond);
+
+	Write(*Data, DisplayColors, NumKeys, Timestamp);
+	INC_DWORD_STAT(STAT_LogiLedSharedFramesPublished);
+}
@@ -0,0 +1,134 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedSnapshot.h"
+#include "LogiLedKeys.h"
+
+#include "HAL/PlatformAtomics.h"
+#include "HAL/UnrealMemory.h"
+
+
+static_assert(LogiLedKeys::Count <= FLogiLedSnapshot::MaxKeys, "Snapshot frames must be able to hold all keys");
+
+
+namespace LogiLedSnapshot
+{
+	/** Bits of FLogiLedSnapshot::Latest that hold the buffer index. */
+	constexpr int32 IndexMask = 0x3;
+
+	/** Bit of FLogiLedSnapshot::Latest that is set when the latest buffer was not read yet. */
+	constexpr int32 UnreadFlag = 0x4;
+
+	/** Keys that are not part of the bitmap, placed in an extra row below it. */
+	struct FExtraKeys
+	{
+		/** Column of each key in the extra row (INDEX_NONE for keys in the bitmap). */
+		int32 Columns[LogiLedKeys::Count];
+
+		FExtraKeys()
+		{
+			int32 NextColumn = 0;
+
+			for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+			{
+				Columns[KeyIndex] = (LogiLedKeys::BitmapCells[KeyIndex] == INDEX_NONE) ? NextColumn++ : INDEX_NONE;
+			}
+		}
+	};
+
+	/** Space between keys (in key cells). */
+	constexpr float KeyGap = 0.1f;
+
+	/** Space between the bitmap and the extra row (in key cells). */
+	constexpr float RowGap = 0.5f;
+}
+
+
+/* FLogiLedSnapshot static functions
+ *****************************************************************************/
+
+FLogiLedSnapshot& FLogiLedSnapshot::Get()
+{
+	static FLogiLedSnapshot Snapshot;
+	return Snapshot;
+}
+
+
+FBox2D FLogiLedSnapshot::GetKeyBounds(int32 KeyIndex)
+{
+	check((KeyIndex >= 0) && (KeyIndex < LogiLedKeys::Count));
+
+	static const LogiLedSnapshot::FExtraKeys ExtraKeys;
+
+	const int32 Cell = LogiLedKeys::BitmapCells[KeyIndex];
+	FVector2D Min;
+
+	if (Cell != INDEX_NONE)
+	{
+		Min = FVector2D(Cell % LOGI_LED_BITMAP_WIDTH, Cell / LOGI_LED_BITMAP_WIDTH);
+	}
+	else
+	{
+		Min = FVector2D(ExtraKeys.Columns[KeyIndex], LOGI_LED_BITMAP_HEIGHT + LogiLedSnapshot::RowGap);
+	}
+
+	return FBox2D(Min, Min + FVector2D(1.0f - LogiLedSnapshot::KeyGap, 1.0f - LogiLedSnapshot::KeyGap));
+}
+
+
+const TCHAR* FLogiLedSnapshot::GetKeyName(int32 KeyIndex)
+{
+	return LogiLedKeys::ToString((ELogiLedKeys)KeyIndex);
+}
+
+
+FVector2D FLogiLedSnapshot::GetLayoutSize()
+{
+	return FVector2D(LOGI_LED_BITMAP_WIDTH, LOGI_LED_BITMAP_HEIGHT + LogiLedSnapshot::RowGap + 1.0f);
+}
+
+
+int32 FLogiLedSnapshot::GetNumKeys()
+{
+	return LogiLedKeys::Count;
+}
+
+
+/* FLogiLedSnapshot structors
+ *****************************************************************************/
+
+FLogiLedSnapshot::FLogiLedSnapshot()
+	: Latest(1)
+	, FrameRequested(false)
+	, ReadIndex(2)
+	, WriteIndex(0)
+{
+	FMemory::Memzero(Buffers);
+}
+
+
+/* FLogiLedSnapshot interface
+ *****************************************************************************/
+
+void FLogiLedSnapshot::Publish(const FColor* Colors)
+{
+	FMemory::Memcpy(Buffers[WriteIndex], Colors, LogiLedKeys::Count * sizeof(FColor));
+
+	// swap the written buffer with the latest one; the exchange is a full barrier
+	const int32 Previous = FPlatformAtomics::InterlockedExchange(&Latest, WriteIndex | LogiLedSnapshot::UnreadFlag);
+	WriteIndex = Previous & LogiLedSnapshot::IndexMask;
+
+	FrameRequested = false;
+}
+
+
+void FLogiLedSnapshot::Read(FColor* OutColors)
+{
+	if ((Latest & LogiLedSnapshot::UnreadFlag) != 0)
+	{
+		// swap the read buffer with the latest one
+		const int32 Previous = FPlatformAtomics::InterlockedExchange(&Latest, ReadIndex);
+		ReadIndex = Previous & LogiLedSnapshot::IndexMask;
+	}
+
+	FMemory::Memcpy(OutColors, Buffers[ReadIndex], LogiLedKeys::Count * sizeof(FColor));
+}
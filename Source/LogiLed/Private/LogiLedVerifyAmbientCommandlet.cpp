@@ -0,0 +1,257 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedVerifyAmbientCommandlet.h"
+#include "LogiLedAmbient.h"
+#include "LogiLedPrivate.h"
+
+#include "HAL/PlatformTime.h"
+#include "HAL/UnrealMemory.h"
+#include "Misc/Parse.h"
+#include "Templates/Function.h"
+
+
+/** Maximum difference between a cell and its expected color. */
+static const float LogiLedAmbientTolerance = 0.0001f;
+
+
+/**
+ * Fill an image with a pattern.
+ *
+ * @param Width The image's width.
+ * @param Height The image's height.
+ * @param Pattern Returns the color of a pixel.
+ * @param OutPixels Will contain the pixels, in rows.
+ */
+static void LogiLedAmbientTestImage(int32 Width, int32 Height, TFunctionRef<FColor(int32 X, int32 Y)> Pattern, TArray<FColor>& OutPixels)
+{
+	OutPixels.SetNumUninitialized(Width * Height);
+
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			OutPixels[Y * Width + X] = Pattern(X, Y);
+		}
+	}
+}
+
+
+/**
+ * Compare downsampled cells with their expected colors, and log the first mismatch.
+ *
+ * @param Name The name of the check.
+ * @param Cells The downsampled cells.
+ * @param Expected Returns the expected color of a cell.
+ * @return true if all cells match, false otherwise.
+ */
+static bool LogiLedAmbientCheckCells(const TCHAR* Name, const FLinearColor* Cells, TFunctionRef<FLinearColor(int32 CellX, int32 CellY)> Expected)
+{
+	for (int32 CellY = 0; CellY < LOGI_LED_BITMAP_HEIGHT; ++CellY)
+	{
+		for (int32 CellX = 0; CellX < LOGI_LED_BITMAP_WIDTH; ++CellX)
+		{
+			const FLinearColor& Cell = Cells[CellY * LOGI_LED_BITMAP_WIDTH + CellX];
+			const FLinearColor ExpectedCell = Expected(CellX, CellY);
+
+			if (!Cell.Equals(ExpectedCell, LogiLedAmbientTolerance))
+			{
+				UE_LOG(LogLogiLed, Error, TEXT("%s: cell (%i, %i) is %s, expected %s"), Name, CellX, CellY, *Cell.ToString(), *ExpectedCell.ToString());
+				return false;
+			}
+		}
+	}
+
+	UE_LOG(LogLogiLed, Display, TEXT("%s: passed"), Name);
+
+	return true;
+}
+
+
+/**
+ * Compare a smoothed value with its expected value, and log a mismatch.
+ *
+ * @param Name The name of the check.
+ * @param Smoothed The smoothed cells (all cells are compared).
+ * @param Expected The expected red, green and blue value of all cells.
+ * @return true if all cells match, false otherwise.
+ */
+static bool LogiLedAmbientCheckSmoothed(const TCHAR* Name, const FLinearColor* Smoothed, float Expected)
+{
+	return LogiLedAmbientCheckCells(Name, Smoothed, [Expected](int32, int32) {
+		return FLinearColor(Expected, Expected, Expected, 0.0f);
+	});
+}
+
+
+/* ULogiLedVerifyAmbientCommandlet structors
+ *****************************************************************************/
+
+ULogiLedVerifyAmbientCommandlet::ULogiLedVerifyAmbientCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 ULogiLedVerifyAmbientCommandlet::Main(const FString& Params)
+{
+	int32 Iterations = 100;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+
+	const int32 NumCells = FLogiLedAmbient::NumCells;
+
+	TArray<FColor> Pixels;
+	FLinearColor Cells[NumCells];
+	bool Passed = true;
+
+	// a uniform image has its color in all cells
+	LogiLedAmbientTestImage(1920, 1080, [](int32, int32) { return FColor(200, 100, 50); }, Pixels);
+	FLogiLedAmbient::Downsample(Pixels.GetData(), 1920, 1080, Cells);
+
+	Passed &= LogiLedAmbientCheckCells(TEXT("Uniform"), Cells, [](int32, int32) {
+		return FLinearColor(200.0f / 255.0f, 100.0f / 255.0f, 50.0f / 255.0f);
+	});
+
+	// so does one whose size does not divide evenly into cells
+	LogiLedAmbientTestImage(100, 37, [](int32, int32) { return FColor(10, 20, 30); }, Pixels);
+	FLogiLedAmbient::Downsample(Pixels.GetData(), 100, 37, Cells);
+
+	Passed &= LogiLedAmbientCheckCells(TEXT("Uneven"), Cells, [](int32, int32) {
+		return FLinearColor(10.0f / 255.0f, 20.0f / 255.0f, 30.0f / 255.0f);
+	});
+
+	// cells of an evenly divided image only average their own pixels
+	const int32 CellWidth = 8;
+	const int32 CellHeight = 5;
+
+	// the checkerboard pattern below only averages out over an even number of pixels per cell
+	static_assert((CellWidth * CellHeight) % 2 == 0, "Test cells must have an even number of pixels");
+
+	auto CellColor = [](int32 CellX, int32 CellY) {
+		return FColor(CellX * 12 + 1, CellY * 40 + 1, (CellX + CellY) * 7 + 1);
+	};
+
+	LogiLedAmbientTestImage(LOGI_LED_BITMAP_WIDTH * CellWidth, LOGI_LED_BITMAP_HEIGHT * CellHeight, [&](int32 X, int32 Y) {
+		// alternate between two colors that average to the cell's color
+		const FColor Color = CellColor(X / CellWidth, Y / CellHeight);
+		const int32 Offset = ((X + Y) % 2 == 0) ? 1 : -1;
+
+		return FColor((uint8)(Color.R + Offset), (uint8)(Color.G + Offset), (uint8)(Color.B + Offset));
+	}, Pixels);
+
+	FLogiLedAmbient::Downsample(Pixels.GetData(), LOGI_LED_BITMAP_WIDTH * CellWidth, LOGI_LED_BITMAP_HEIGHT * CellHeight, Cells);
+
+	Passed &= LogiLedAmbientCheckCells(TEXT("Cells"), Cells, [&](int32 CellX, int32 CellY) {
+		const FColor Color = CellColor(CellX, CellY);
+		return FLinearColor(Color.R / 255.0f, Color.G / 255.0f, Color.B / 255.0f);
+	});
+
+	// images smaller than the bitmap cover each cell with at least one pixel
+	auto SmallColor = [](int32 X, int32 Y) {
+		return FColor(X * 30 + 10, Y * 80 + 10, 10);
+	};
+
+	LogiLedAmbientTestImage(7, 3, SmallColor, Pixels);
+	FLogiLedAmbient::Downsample(Pixels.GetData(), 7, 3, Cells);
+
+	Passed &= LogiLedAmbientCheckCells(TEXT("Small"), Cells, [&](int32 CellX, int32 CellY) {
+		const FColor Color = SmallColor(CellX * 7 / LOGI_LED_BITMAP_WIDTH, CellY * 3 / LOGI_LED_BITMAP_HEIGHT);
+		return FLinearColor(Color.R / 255.0f, Color.G / 255.0f, Color.B / 255.0f);
+	});
+
+	// missing images are black
+	FLogiLedAmbient::Downsample(nullptr, 0, 0, Cells);
+
+	Passed &= LogiLedAmbientCheckCells(TEXT("Empty"), Cells, [](int32, int32) {
+		return FLinearColor::Black;
+	});
+
+	// without smoothing, new colors are taken over immediately
+	FLinearColor Targets[NumCells];
+	FLinearColor Smoothed[NumCells];
+
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		Targets[CellIndex] = FLinearColor(1.0f, 1.0f, 1.0f, 0.0f);
+		Smoothed[CellIndex] = FLinearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	FLogiLedAmbient::Smooth(Targets, 0.016f, 0.0f, Smoothed);
+	Passed &= LogiLedAmbientCheckSmoothed(TEXT("Unsmoothed"), Smoothed, 1.0f);
+
+	// a step reaches 1 - 1/e after one time constant
+	for (FLinearColor& Cell : Smoothed)
+	{
+		Cell = FLinearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	FLogiLedAmbient::Smooth(Targets, 0.25f, 0.25f, Smoothed);
+	Passed &= LogiLedAmbientCheckSmoothed(TEXT("Time constant"), Smoothed, 1.0f - FMath::Exp(-1.0f));
+
+	// and gets there at the same time regardless of the capture rate
+	for (FLinearColor& Cell : Smoothed)
+	{
+		Cell = FLinearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	for (int32 Step = 0; Step < 25; ++Step)
+	{
+		FLogiLedAmbient::Smooth(Targets, 0.01f, 0.25f, Smoothed);
+	}
+
+	Passed &= LogiLedAmbientCheckSmoothed(TEXT("Capture rate"), Smoothed, 1.0f - FMath::Exp(-1.0f));
+
+	// time never runs backwards
+	const FLinearColor Before = Smoothed[0];
+	FLogiLedAmbient::Smooth(Targets, -1.0f, 0.25f, Smoothed);
+	Passed &= LogiLedAmbientCheckSmoothed(TEXT("Negative time"), Smoothed, Before.R);
+
+	// a new instance takes over its first image, even if its memory held garbage (all ones are NaNs)
+	{
+		void* Memory = FMemory::Malloc(sizeof(FLogiLedAmbient), alignof(FLogiLedAmbient));
+		FMemory::Memset(Memory, 0xff, sizeof(FLogiLedAmbient));
+
+		FLogiLedAmbient* Ambient = new(Memory) FLogiLedAmbient();
+
+		LogiLedAmbientTestImage(64, 32, [](int32, int32) { return FColor(51, 102, 204); }, Pixels);
+		Ambient->Start(1, 0.25f);
+		Ambient->SubmitImage(Pixels.GetData(), 64, 32, 0.016f);
+
+		Passed &= LogiLedAmbientCheckCells(TEXT("First image"), Ambient->GetSmoothed(), [](int32, int32) {
+			return FLinearColor(51.0f / 255.0f, 102.0f / 255.0f, 204.0f / 255.0f);
+		});
+
+		Ambient->Stop();
+		Ambient->~FLogiLedAmbient();
+		FMemory::Free(Memory);
+	}
+
+	// time the reference downsample of a full HD frame
+	LogiLedAmbientTestImage(1920, 1080, [](int32 X, int32 Y) { return FColor((uint8)X, (uint8)Y, (uint8)(X ^ Y)); }, Pixels);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		FLogiLedAmbient::Downsample(Pixels.GetData(), 1920, 1080, Cells);
+	}
+
+	const double Milliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0 / FMath::Max(Iterations, 1);
+
+	UE_LOG(LogLogiLed, Display, TEXT("Downsampled 1920x1080 in %.3f ms on average (%i iterations)"), Milliseconds, Iterations);
+
+	if (!Passed)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Ambient reference checks failed"));
+		return 1;
+	}
+
+	UE_LOG(LogLogiLed, Display, TEXT("All ambient reference checks passed"));
+
+	return 0;
+}
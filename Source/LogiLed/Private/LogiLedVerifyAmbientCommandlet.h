@@ -0,0 +1,44 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedVerifyAmbientCommandlet.generated.h"
+
+
+/**
+ * Verifies the CPU reference of the ambient mode's downsample and smoothing.
+ *
+ * Synthetic images with known cell averages are downsampled, including images
+ * that are smaller than the key bitmap or do not divide evenly into cells, and
+ * the smoothing is checked for its time constant and for being independent of
+ * the capture rate. A new ambient instance is checked to take over the first
+ * image it is given. Nothing is rendered, so the checks run on any platform,
+ * including headless Linux build machines. The time to downsample a full HD
+ * image is reported as well.
+ *
+ * Usage:
+ *     UE4Editor-Cmd.exe <Project> -run=LogiLedVerifyAmbient [-Iterations=<Count>]
+ *
+ * The number of timed downsamples defaults to 100.
+ */
+UCLASS()
+class ULogiLedVerifyAmbientCommandlet
+	: public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Default constructor. */
+	ULogiLedVerifyAmbientCommandlet();
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,143 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedVerifyMaterialCommandlet.h"
+#include "LogiLedBlueprintLibrary.h"
+#include "LogiLedFrame.h"
+#include "LogiLedKeys.h"
+#include "LogiLedMaterialComponent.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedSnapshot.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Templates/Function.h"
+
+
+/** Time between manual ticks (in seconds). */
+static const float LogiLedMaterialFrameTime = 0.05f;
+
+
+/**
+ * Compare the published per-key frame with the colors of a CPU function, and log the first mismatch.
+ *
+ * Only keys that are part of the key bitmap are compared.
+ *
+ * @param Name The name of the check.
+ * @param Colors The published percentage colors, indexed by ELogiLedKeys.
+ * @param Function The function that the keys should show (evaluated at time 0).
+ * @return true if all keys match, false otherwise.
+ */
+static bool LogiLedMaterialCheckFrame(const TCHAR* Name, const FColor* Colors, const ULogiLedMaterialComponent::FCpuFunction& Function)
+{
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		const int32 Cell = LogiLedKeys::BitmapCells[KeyIndex];
+
+		if (Cell == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FVector2D UV(((Cell % LOGI_LED_BITMAP_WIDTH) + 0.5f) / LOGI_LED_BITMAP_WIDTH, ((Cell / LOGI_LED_BITMAP_WIDTH) + 0.5f) / LOGI_LED_BITMAP_HEIGHT);
+		const FColor Expected = FLogiLedFrame::BytesToPercentage(Function(UV, 0.0f).ToFColor(false));
+		const FColor& Color = Colors[KeyIndex];
+
+		if ((Color.R != Expected.R) || (Color.G != Expected.G) || (Color.B != Expected.B))
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("%s: key %i is %s, expected %s"), Name, KeyIndex, *Color.ToString(), *Expected.ToString());
+			return false;
+		}
+	}
+
+	UE_LOG(LogLogiLed, Display, TEXT("%s: passed"), Name);
+
+	return true;
+}
+
+
+/* ULogiLedVerifyMaterialCommandlet structors
+ *****************************************************************************/
+
+ULogiLedVerifyMaterialCommandlet::ULogiLedVerifyMaterialCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 ULogiLedVerifyMaterialCommandlet::Main(const FString& Params)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	AActor* Actor = World->SpawnActor<AActor>();
+
+	if (Actor == nullptr)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to spawn an actor for the component"));
+		World->DestroyWorld(false);
+
+		return 1;
+	}
+
+	// gradients across the bitmap, so that every cell has its own color
+	const ULogiLedMaterialComponent::FCpuFunction Gradient = [](const FVector2D& UV, float Time) {
+		return FLinearColor(UV.X, UV.Y, 0.5f + Time);
+	};
+
+	const ULogiLedMaterialComponent::FCpuFunction InverseGradient = [](const FVector2D& UV, float Time) {
+		return FLinearColor(1.0f - UV.X, 1.0f - UV.Y, 0.25f + Time);
+	};
+
+	ULogiLedMaterialComponent* Component = NewObject<ULogiLedMaterialComponent>(Actor);
+	{
+		Component->UpdatesPerSecond = 10.0f;
+		Component->SetCpuFunction(ULogiLedMaterialComponent::FCpuFunction(Gradient));
+		Component->RegisterComponent();
+	}
+
+	// the manager publishes frames only while someone is watching
+	FLogiLedSnapshot& Snapshot = FLogiLedSnapshot::Get();
+	Snapshot.AddViewer();
+
+	FLogiLedManager& Manager = ULogiLedBlueprintLibrary::GetManager();
+	FColor Colors[FLogiLedSnapshot::MaxKeys];
+	bool Passed = true;
+
+	auto TickFrame = [&](float DeltaTime)
+	{
+		Component->TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+		Manager.Tick(DeltaTime);
+		Snapshot.Read(Colors);
+	};
+
+	// the first tick computes the pixels right away (nothing is rendered in commandlets)
+	TickFrame(LogiLedMaterialFrameTime);
+	Passed &= LogiLedMaterialCheckFrame(TEXT("Per-key frame"), Colors, Gradient);
+
+	// a new function only shows with the next update, which is due a tenth of a second after the first
+	Component->SetCpuFunction(ULogiLedMaterialComponent::FCpuFunction(InverseGradient));
+
+	TickFrame(LogiLedMaterialFrameTime * 0.5f);
+	Passed &= LogiLedMaterialCheckFrame(TEXT("Update pending"), Colors, Gradient);
+
+	TickFrame(LogiLedMaterialFrameTime * 1.5f);
+	Passed &= LogiLedMaterialCheckFrame(TEXT("Update rate"), Colors, InverseGradient);
+
+	Snapshot.RemoveViewer();
+	Component->UnregisterComponent();
+	World->DestroyWorld(false);
+
+	if (!Passed)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Material component checks failed"));
+		return 1;
+	}
+
+	UE_LOG(LogLogiLed, Display, TEXT("All material component checks passed"));
+
+	return 0;
+}
@@ -0,0 +1,46 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedVerifyMaterialCommandlet.generated.h"
+
+
+/**
+ * Verifies the CPU path of the LED material component.
+ *
+ * A component without a material is registered in a transient world and given
+ * a CPU function, and the component and the lighting manager are ticked by
+ * hand. The commandlet checks that:
+ *
+ *     - each key of the key bitmap shows the function's color at the center
+ *       of the key's cell, as an SDK percentage,
+ *     - a new function does not show before the next update is due, and shows
+ *       once it is.
+ *
+ * Nothing is rendered, so the checks run on any platform, including headless
+ * Linux build machines.
+ *
+ * Usage:
+ *     UE4Editor-Cmd.exe <Project> -run=LogiLedVerifyMaterial
+ */
+UCLASS()
+class ULogiLedVerifyMaterialCommandlet
+	: public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Default constructor. */
+	ULogiLedVerifyMaterialCommandlet();
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+};
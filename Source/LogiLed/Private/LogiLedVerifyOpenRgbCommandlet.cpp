@@ -0,0 +1,848 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedVerifyOpenRgbCommandlet.h"
+#include "LogiLedKeys.h"
+#include "LogiLedOpenRgb.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedSnapshot.h"
+
+#include "Common/TcpSocketBuilder.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Interfaces/IPv4/IPv4Address.h"
+#include "Misc/Parse.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Templates/Function.h"
+
+
+/** Packet header values. */
+static const uint8 LogiLedStandInMagic[] = { 'O', 'R', 'G', 'B' };
+static const int32 LogiLedStandInHeaderSize = 16;
+
+/** Packet identifiers (protocol version 0). */
+static const uint32 LogiLedStandInRequestControllerCount = 0;
+static const uint32 LogiLedStandInRequestControllerData = 1;
+static const uint32 LogiLedStandInSetClientName = 50;
+static const uint32 LogiLedStandInUpdateLeds = 1050;
+static const uint32 LogiLedStandInUpdateZoneLeds = 1051;
+static const uint32 LogiLedStandInSetCustomMode = 1100;
+
+/** Device types. */
+static const uint32 LogiLedStandInKeyboardType = 5;
+static const uint32 LogiLedStandInMouseType = 6;
+
+/** Interval between the backend's frames (in seconds), see FLogiLedOpenRgb. */
+static const float LogiLedStandInSendInterval = 1.0f / 60.0f;
+
+/** Time to wait for packets that should arrive (in seconds). */
+static const double LogiLedStandInTimeout = 2.0;
+
+/** Time to wait for packets that should not arrive (in seconds). */
+static const double LogiLedStandInQuietTime = 0.05;
+
+
+/** Read a little-endian value from a packet. */
+static uint16 LogiLedStandInReadUint16(const uint8* Data)
+{
+	return (uint16)(Data[0] | (Data[1] << 8));
+}
+
+
+/** Read a little-endian value from a packet. */
+static uint32 LogiLedStandInReadUint32(const uint8* Data)
+{
+	return (uint32)Data[0] | ((uint32)Data[1] << 8) | ((uint32)Data[2] << 16) | ((uint32)Data[3] << 24);
+}
+
+
+/** Append a little-endian value to a packet. */
+static void LogiLedStandInWriteUint16(TArray<uint8>& Buffer, uint16 Value)
+{
+	Buffer.Add((uint8)Value);
+	Buffer.Add((uint8)(Value >> 8));
+}
+
+
+/** Append a little-endian value to a packet. */
+static void LogiLedStandInWriteUint32(TArray<uint8>& Buffer, uint32 Value)
+{
+	Buffer.Add((uint8)Value);
+	Buffer.Add((uint8)(Value >> 8));
+	Buffer.Add((uint8)(Value >> 16));
+	Buffer.Add((uint8)(Value >> 24));
+}
+
+
+/** Append a string to a packet (length including the null terminator, then the characters). */
+static void LogiLedStandInWriteString(TArray<uint8>& Buffer, const ANSICHAR* String)
+{
+	const int32 Length = FCStringAnsi::Strlen(String) + 1;
+
+	LogiLedStandInWriteUint16(Buffer, (uint16)Length);
+	Buffer.Append((const uint8*)String, Length);
+}
+
+
+/** A packet that the stand-in server received. */
+struct FLogiLedStandInPacket
+{
+	uint32 DeviceIndex;
+	uint32 PacketId;
+
+	/** The updated zone (INDEX_NONE if the packet is not a zone update). */
+	int32 ZoneIndex;
+};
+
+
+/**
+ * A minimal OpenRGB SDK server that records the packets it receives.
+ *
+ * It accepts one connection, answers the enumeration requests, and applies LED
+ * updates to its devices. Protocol errors are logged and set the error flag.
+ */
+struct FLogiLedStandIn
+{
+	struct FZone
+	{
+		int32 FirstLed;
+		int32 NumLeds;
+	};
+
+	struct FDevice
+	{
+		uint32 Type;
+		const ANSICHAR* Name;
+		TArray<FZone> Zones;
+
+		/** The key that each LED shows (INDEX_NONE = average of all keys). */
+		TArray<int32> LedKeys;
+
+		/** The current color of each LED (0x00BBGGRR). */
+		TArray<uint32> Colors;
+
+		bool CustomMode;
+		bool Updated;
+	};
+
+	FLogiLedStandIn()
+		: Listener(nullptr)
+		, Connection(nullptr)
+		, NumUpdates(0)
+		, NumBytes(0)
+		, Error(false)
+	{ }
+
+	~FLogiLedStandIn()
+	{
+		Close();
+	}
+
+	FDevice& AddDevice(uint32 Type, const ANSICHAR* Name)
+	{
+		FDevice& Device = Devices[Devices.AddDefaulted()];
+
+		Device.Type = Type;
+		Device.Name = Name;
+		Device.CustomMode = false;
+		Device.Updated = false;
+
+		return Device;
+	}
+
+	void AddZone(FDevice& Device, const TArray<int32>& Keys)
+	{
+		FZone& Zone = Device.Zones[Device.Zones.AddDefaulted()];
+
+		Zone.FirstLed = Device.LedKeys.Num();
+		Zone.NumLeds = Keys.Num();
+
+		Device.LedKeys.Append(Keys);
+		Device.Colors.SetNumZeroed(Device.LedKeys.Num());
+	}
+
+	bool AllUpdated() const
+	{
+		for (const FDevice& Device : Devices)
+		{
+			if (!Device.Updated)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/** Compare the colors of all LEDs with a frame (percentages), and log the first mismatch. */
+	bool CheckColors(const TCHAR* Name, const FColor* Frame) const
+	{
+		uint32 SumR = 0;
+		uint32 SumG = 0;
+		uint32 SumB = 0;
+
+		for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+		{
+			const FColor Color = FLogiLedSnapshot::ToDisplayColor(Frame[KeyIndex]);
+
+			SumR += Color.R;
+			SumG += Color.G;
+			SumB += Color.B;
+		}
+
+		const uint32 Average = (SumR / LogiLedKeys::Count) | ((SumG / LogiLedKeys::Count) << 8) | ((SumB / LogiLedKeys::Count) << 16);
+
+		for (int32 DeviceIndex = 0; DeviceIndex < Devices.Num(); ++DeviceIndex)
+		{
+			const FDevice& Device = Devices[DeviceIndex];
+
+			for (int32 LedIndex = 0; LedIndex < Device.LedKeys.Num(); ++LedIndex)
+			{
+				const int32 Key = Device.LedKeys[LedIndex];
+				const FColor Color = (Key != INDEX_NONE) ? FLogiLedSnapshot::ToDisplayColor(Frame[Key]) : FColor::Black;
+				const uint32 Expected = (Key != INDEX_NONE) ? ((uint32)Color.R | ((uint32)Color.G << 8) | ((uint32)Color.B << 16)) : Average;
+
+				if (Device.Colors[LedIndex] != Expected)
+				{
+					UE_LOG(LogLogiLed, Error, TEXT("%s: LED %i of device %i is %06x, expected %06x"), Name, LedIndex, DeviceIndex, Device.Colors[LedIndex], Expected);
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void Close()
+	{
+		ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+		if (Connection != nullptr)
+		{
+			Connection->Close();
+			SocketSubsystem->DestroySocket(Connection);
+			Connection = nullptr;
+		}
+
+		if (Listener != nullptr)
+		{
+			Listener->Close();
+			SocketSubsystem->DestroySocket(Listener);
+			Listener = nullptr;
+		}
+	}
+
+	void HandlePacket(uint32 DeviceIndex, uint32 PacketId, const uint8* Payload, uint32 Size)
+	{
+		FLogiLedStandInPacket& Packet = Packets[Packets.AddDefaulted()];
+
+		Packet.DeviceIndex = DeviceIndex;
+		Packet.PacketId = PacketId;
+		Packet.ZoneIndex = INDEX_NONE;
+
+		if ((PacketId == LogiLedStandInSetClientName) || (PacketId == LogiLedStandInRequestControllerCount))
+		{
+			if (PacketId == LogiLedStandInRequestControllerCount)
+			{
+				TArray<uint8> Count;
+				LogiLedStandInWriteUint32(Count, Devices.Num());
+				Send(0, PacketId, Count);
+			}
+
+			return;
+		}
+
+		if (DeviceIndex >= (uint32)Devices.Num())
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Received packet %u for unknown device %u"), PacketId, DeviceIndex);
+			Error = true;
+
+			return;
+		}
+
+		FDevice& Device = Devices[DeviceIndex];
+
+		if (PacketId == LogiLedStandInRequestControllerData)
+		{
+			Send(DeviceIndex, PacketId, Describe(Device));
+		}
+		else if (PacketId == LogiLedStandInSetCustomMode)
+		{
+			Device.CustomMode = true;
+		}
+		else if ((PacketId == LogiLedStandInUpdateLeds) || (PacketId == LogiLedStandInUpdateZoneLeds))
+		{
+			const bool IsZone = (PacketId == LogiLedStandInUpdateZoneLeds);
+			const uint32 HeaderSize = IsZone ? 10 : 6;
+
+			if (!Device.CustomMode)
+			{
+				UE_LOG(LogLogiLed, Error, TEXT("LEDs of device %u were updated before its custom mode was set"), DeviceIndex);
+				Error = true;
+			}
+
+			if ((Size < HeaderSize) || (LogiLedStandInReadUint32(Payload) != Size))
+			{
+				UE_LOG(LogLogiLed, Error, TEXT("Received LED update for device %u with invalid size"), DeviceIndex);
+				Error = true;
+
+				return;
+			}
+
+			int32 FirstLed = 0;
+			int32 NumLeds = Device.LedKeys.Num();
+
+			if (IsZone)
+			{
+				Packet.ZoneIndex = (int32)LogiLedStandInReadUint32(Payload + 4);
+
+				if (!Device.Zones.IsValidIndex(Packet.ZoneIndex))
+				{
+					UE_LOG(LogLogiLed, Error, TEXT("Received LED update for unknown zone %i of device %u"), Packet.ZoneIndex, DeviceIndex);
+					Error = true;
+
+					return;
+				}
+
+				FirstLed = Device.Zones[Packet.ZoneIndex].FirstLed;
+				NumLeds = Device.Zones[Packet.ZoneIndex].NumLeds;
+			}
+
+			if ((LogiLedStandInReadUint16(Payload + HeaderSize - 2) != NumLeds) || (Size != HeaderSize + 4 * NumLeds))
+			{
+				UE_LOG(LogLogiLed, Error, TEXT("Received LED update for device %u with wrong number of LEDs"), DeviceIndex);
+				Error = true;
+
+				return;
+			}
+
+			for (int32 LedIndex = 0; LedIndex < NumLeds; ++LedIndex)
+			{
+				Device.Colors[FirstLed + LedIndex] = LogiLedStandInReadUint32(Payload + HeaderSize + 4 * LedIndex);
+			}
+
+			Device.Updated = true;
+			++NumUpdates;
+		}
+		else
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Received unexpected packet %u"), PacketId);
+			Error = true;
+		}
+	}
+
+	TArray<uint8> Describe(const FDevice& Device) const
+	{
+		TArray<uint8> Payload;
+
+		LogiLedStandInWriteUint32(Payload, 0); // data size, set below
+		LogiLedStandInWriteUint32(Payload, Device.Type);
+		LogiLedStandInWriteString(Payload, Device.Name);
+		LogiLedStandInWriteString(Payload, "LogiLed stand-in device");
+		LogiLedStandInWriteString(Payload, "1.0");
+		LogiLedStandInWriteString(Payload, "");
+		LogiLedStandInWriteString(Payload, "Loopback");
+
+		// modes: none, active mode
+		LogiLedStandInWriteUint16(Payload, 0);
+		LogiLedStandInWriteUint32(Payload, 0);
+
+		// zones: name, type, LED counts, empty matrix map
+		LogiLedStandInWriteUint16(Payload, (uint16)Device.Zones.Num());
+
+		for (const FZone& Zone : Device.Zones)
+		{
+			LogiLedStandInWriteString(Payload, "Zone");
+			LogiLedStandInWriteUint32(Payload, 0);
+			LogiLedStandInWriteUint32(Payload, Zone.NumLeds);
+			LogiLedStandInWriteUint32(Payload, Zone.NumLeds);
+			LogiLedStandInWriteUint32(Payload, Zone.NumLeds);
+			LogiLedStandInWriteUint16(Payload, 0);
+		}
+
+		// LEDs: name, value
+		LogiLedStandInWriteUint16(Payload, (uint16)Device.LedKeys.Num());
+
+		for (int32 Key : Device.LedKeys)
+		{
+			LogiLedStandInWriteString(Payload, (Key != INDEX_NONE) ? LogiLedKeys::ToOpenRgbName((ELogiLedKeys)Key) : "Logo");
+			LogiLedStandInWriteUint32(Payload, 0);
+		}
+
+		// colors
+		LogiLedStandInWriteUint16(Payload, (uint16)Device.Colors.Num());
+
+		for (uint32 Color : Device.Colors)
+		{
+			LogiLedStandInWriteUint32(Payload, Color);
+		}
+
+		TArray<uint8> DataSize;
+		LogiLedStandInWriteUint32(DataSize, Payload.Num());
+		FMemory::Memcpy(Payload.GetData(), DataSize.GetData(), DataSize.Num());
+
+		return Payload;
+	}
+
+	bool Listen(int32 Port)
+	{
+		Listener = FTcpSocketBuilder(TEXT("LogiLedStandInListener"))
+			.AsNonBlocking()
+			.AsReusable()
+			.BoundToAddress(FIPv4Address(127, 0, 0, 1))
+			.BoundToPort(Port)
+			.Listening(1)
+			.Build();
+
+		return (Listener != nullptr);
+	}
+
+	void Poll()
+	{
+		if (Connection == nullptr)
+		{
+			bool Pending = false;
+
+			if (!Listener->HasPendingConnection(Pending) || !Pending)
+			{
+				return;
+			}
+
+			Connection = Listener->Accept(TEXT("LogiLedStandInConnection"));
+
+			if (Connection == nullptr)
+			{
+				return;
+			}
+
+			Connection->SetNonBlocking(true);
+		}
+
+		uint8 Chunk[4096];
+		int32 NumRead = 0;
+
+		while (Connection->Recv(Chunk, sizeof(Chunk), NumRead) && (NumRead > 0))
+		{
+			ReceiveBuffer.Append(Chunk, NumRead);
+			NumBytes += NumRead;
+		}
+
+		int32 Consumed = 0;
+
+		while (ReceiveBuffer.Num() - Consumed >= LogiLedStandInHeaderSize)
+		{
+			const uint8* Header = ReceiveBuffer.GetData() + Consumed;
+
+			if (FMemory::Memcmp(Header, LogiLedStandInMagic, sizeof(LogiLedStandInMagic)) != 0)
+			{
+				UE_LOG(LogLogiLed, Error, TEXT("Received packet without magic"));
+				Error = true;
+				ReceiveBuffer.Reset();
+
+				return;
+			}
+
+			const uint32 DeviceIndex = LogiLedStandInReadUint32(Header + 4);
+			const uint32 PacketId = LogiLedStandInReadUint32(Header + 8);
+			const uint32 Size = LogiLedStandInReadUint32(Header + 12);
+
+			if ((uint32)(ReceiveBuffer.Num() - Consumed - LogiLedStandInHeaderSize) < Size)
+			{
+				break;
+			}
+
+			HandlePacket(DeviceIndex, PacketId, Header + LogiLedStandInHeaderSize, Size);
+			Consumed += LogiLedStandInHeaderSize + Size;
+		}
+
+		ReceiveBuffer.RemoveAt(0, Consumed, false);
+	}
+
+	void Send(uint32 DeviceIndex, uint32 PacketId, const TArray<uint8>& Payload)
+	{
+		TArray<uint8> Packet;
+
+		Packet.Append(LogiLedStandInMagic, ARRAY_COUNT(LogiLedStandInMagic));
+		LogiLedStandInWriteUint32(Packet, DeviceIndex);
+		LogiLedStandInWriteUint32(Packet, PacketId);
+		LogiLedStandInWriteUint32(Packet, Payload.Num());
+		Packet.Append(Payload);
+
+		int32 Offset = 0;
+
+		while (Offset < Packet.Num())
+		{
+			int32 NumSent = 0;
+
+			if (!Connection->Send(Packet.GetData() + Offset, Packet.Num() - Offset, NumSent) && (ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() != SE_EWOULDBLOCK))
+			{
+				UE_LOG(LogLogiLed, Error, TEXT("Failed to send packet %u"), PacketId);
+				Error = true;
+
+				return;
+			}
+
+			Offset += NumSent;
+		}
+	}
+
+	FSocket* Listener;
+	FSocket* Connection;
+	TArray<FDevice> Devices;
+	TArray<FLogiLedStandInPacket> Packets;
+	TArray<uint8> ReceiveBuffer;
+	int32 NumUpdates;
+	int64 NumBytes;
+	bool Error;
+};
+
+
+/**
+ * Receive packets until a condition is met.
+ *
+ * @param StandIn The stand-in server.
+ * @param Done Returns whether to stop waiting.
+ * @param Timeout Maximum time to wait (in seconds).
+ * @return true if the condition was met, false on timeout.
+ */
+static bool LogiLedStandInWait(FLogiLedStandIn& StandIn, TFunctionRef<bool()> Done, double Timeout)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	while (!Done())
+	{
+		if (FPlatformTime::Seconds() - StartTime >= Timeout)
+		{
+			return false;
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+		StandIn.Poll();
+	}
+
+	return true;
+}
+
+
+/**
+ * Compare the LED updates that the stand-in received with the expected ones, and log the first mismatch.
+ *
+ * @param Name The name of the check.
+ * @param Updates The received LED update packets.
+ * @param Expected The expected LED update packets.
+ * @return true if the updates match, false otherwise.
+ */
+static bool LogiLedStandInCheckUpdates(const TCHAR* Name, const TArray<FLogiLedStandInPacket>& Updates, const TArray<FLogiLedStandInPacket>& Expected)
+{
+	if (Updates.Num() != Expected.Num())
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("%s: received %i LED update packets, expected %i"), Name, Updates.Num(), Expected.Num());
+		return false;
+	}
+
+	for (int32 Index = 0; Index < Updates.Num(); ++Index)
+	{
+		const FLogiLedStandInPacket& Update = Updates[Index];
+		const FLogiLedStandInPacket& ExpectedUpdate = Expected[Index];
+
+		if ((Update.DeviceIndex != ExpectedUpdate.DeviceIndex) || (Update.PacketId != ExpectedUpdate.PacketId) || (Update.ZoneIndex != ExpectedUpdate.ZoneIndex))
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("%s: update %i is packet %u for device %u (zone %i), expected packet %u for device %u (zone %i)"),
+				Name, Index,
+				Update.PacketId, Update.DeviceIndex, Update.ZoneIndex,
+				ExpectedUpdate.PacketId, ExpectedUpdate.DeviceIndex, ExpectedUpdate.ZoneIndex);
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * Check that the client introduced itself and enumerated the devices, and that
+ * each device was switched to its custom mode before its LEDs were updated.
+ *
+ * @param StandIn The stand-in server.
+ * @return true if the sequence is correct, false otherwise.
+ */
+static bool LogiLedStandInCheckSequence(const FLogiLedStandIn& StandIn)
+{
+	const TArray<FLogiLedStandInPacket>& Packets = StandIn.Packets;
+
+	if ((Packets.Num() < 2) || (Packets[0].PacketId != LogiLedStandInSetClientName) || (Packets[1].PacketId != LogiLedStandInRequestControllerCount))
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Enumeration: the client did not send its name and request the device count first"));
+		return false;
+	}
+
+	for (int32 DeviceIndex = 0; DeviceIndex < StandIn.Devices.Num(); ++DeviceIndex)
+	{
+		const int32 DataIndex = Packets.IndexOfByPredicate([=](const FLogiLedStandInPacket& Packet) {
+			return (Packet.DeviceIndex == (uint32)DeviceIndex) && (Packet.PacketId == LogiLedStandInRequestControllerData);
+		});
+
+		const int32 ModeIndex = Packets.IndexOfByPredicate([=](const FLogiLedStandInPacket& Packet) {
+			return (Packet.DeviceIndex == (uint32)DeviceIndex) && (Packet.PacketId == LogiLedStandInSetCustomMode);
+		});
+
+		const int32 UpdateIndex = Packets.IndexOfByPredicate([=](const FLogiLedStandInPacket& Packet) {
+			return (Packet.DeviceIndex == (uint32)DeviceIndex) && ((Packet.PacketId == LogiLedStandInUpdateLeds) || (Packet.PacketId == LogiLedStandInUpdateZoneLeds));
+		});
+
+		if ((DataIndex < 2) || (ModeIndex <= DataIndex) || (UpdateIndex <= ModeIndex))
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Enumeration: device %i was described at packet %i, switched to custom mode at packet %i, and first updated at packet %i"), DeviceIndex, DataIndex, ModeIndex, UpdateIndex);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * Move the colors of a set of keys to the previous key in the set.
+ *
+ * The average of all keys does not change.
+ *
+ * @param Keys The keys.
+ * @param Frame The frame to change.
+ */
+static void LogiLedStandInRotate(const TArray<int32>& Keys, FColor* Frame)
+{
+	const FColor First = Frame[Keys[0]];
+
+	for (int32 Index = 0; Index < Keys.Num() - 1; ++Index)
+	{
+		Frame[Keys[Index]] = Frame[Keys[Index + 1]];
+	}
+
+	Frame[Keys.Last()] = First;
+}
+
+
+/* ULogiLedVerifyOpenRgbCommandlet structors
+ *****************************************************************************/
+
+ULogiLedVerifyOpenRgbCommandlet::ULogiLedVerifyOpenRgbCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 ULogiLedVerifyOpenRgbCommandlet::Main(const FString& Params)
+{
+	int32 Port = 0;
+	float Duration = 2.0f;
+
+	FParse::Value(*Params, TEXT("Port="), Port);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+
+	// a keyboard whose keys are split into a large and a small zone, and a mouse that shows the average
+	TArray<int32> MainKeys;
+	TArray<int32> SideKeys;
+	TArray<int32> NamedKeys;
+
+	for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+	{
+		const ANSICHAR* Name = LogiLedKeys::ToOpenRgbName((ELogiLedKeys)KeyIndex);
+
+		const bool Duplicate = (Name == nullptr) || NamedKeys.ContainsByPredicate([=](int32 NamedKey) {
+			return (FCStringAnsi::Strcmp(LogiLedKeys::ToOpenRgbName((ELogiLedKeys)NamedKey), Name) == 0);
+		});
+
+		if (!Duplicate)
+		{
+			NamedKeys.Add(KeyIndex);
+		}
+	}
+
+	const int32 NumMainKeys = NamedKeys.Num() * 3 / 4;
+
+	MainKeys.Append(NamedKeys.GetData(), NumMainKeys);
+	SideKeys.Append(NamedKeys.GetData() + NumMainKeys, NamedKeys.Num() - NumMainKeys);
+
+	check(SideKeys.Num() >= 2);
+
+	FLogiLedStandIn StandIn;
+	{
+		FLogiLedStandIn::FDevice& Keyboard = StandIn.AddDevice(LogiLedStandInKeyboardType, "Stand-in Keyboard");
+		StandIn.AddZone(Keyboard, MainKeys);
+		StandIn.AddZone(Keyboard, SideKeys);
+
+		FLogiLedStandIn::FDevice& Mouse = StandIn.AddDevice(LogiLedStandInMouseType, "Stand-in Mouse");
+		StandIn.AddZone(Mouse, { INDEX_NONE, INDEX_NONE });
+	}
+
+	if (!StandIn.Listen(Port))
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to listen on port %i"), Port);
+		return 1;
+	}
+
+	// start with a known frame
+	FColor Frame[FLogiLedSnapshot::MaxKeys];
+	FMemory::Memzero(Frame);
+	FLogiLedSnapshot::Get().Publish(Frame);
+
+	FLogiLedOpenRgb Client;
+
+	if (!Client.Start(FString::Printf(TEXT("127.0.0.1:%i"), StandIn.Listener->GetPortNo())))
+	{
+		return 1;
+	}
+
+	// publish a frame, tick the client once, and return the LED updates that arrive
+	auto SendFrame = [&](float DeltaTime, int32 NumExpected)
+	{
+		const int32 FirstPacket = StandIn.Packets.Num();
+		const int32 FirstUpdate = StandIn.NumUpdates;
+
+		FLogiLedSnapshot::Get().Publish(Frame);
+		Client.Tick(DeltaTime);
+
+		LogiLedStandInWait(StandIn, [&]() { return (StandIn.NumUpdates - FirstUpdate >= NumExpected); }, LogiLedStandInTimeout);
+		LogiLedStandInWait(StandIn, []() { return false; }, LogiLedStandInQuietTime);
+
+		TArray<FLogiLedStandInPacket> Updates;
+
+		for (int32 Index = FirstPacket; Index < StandIn.Packets.Num(); ++Index)
+		{
+			const FLogiLedStandInPacket& Packet = StandIn.Packets[Index];
+
+			if ((Packet.PacketId == LogiLedStandInUpdateLeds) || (Packet.PacketId == LogiLedStandInUpdateZoneLeds))
+			{
+				Updates.Add(Packet);
+			}
+		}
+
+		return Updates;
+	};
+
+	// ticks of two intervals always send, and leave no time until the next frame
+	const float SendTime = 2.0f * LogiLedStandInSendInterval;
+	const float CoalesceTime = 0.001f;
+
+	const FLogiLedStandInPacket KeyboardUpdate = { 0, LogiLedStandInUpdateLeds, INDEX_NONE };
+	const FLogiLedStandInPacket SideZoneUpdate = { 0, LogiLedStandInUpdateZoneLeds, 1 };
+	const FLogiLedStandInPacket MouseUpdate = { 1, LogiLedStandInUpdateLeds, INDEX_NONE };
+
+	// connect, enumerate and send the first frame
+	const bool Connected = LogiLedStandInWait(StandIn, [&]() {
+		Client.Tick(LogiLedStandInSendInterval);
+		return StandIn.AllUpdated();
+	}, LogiLedStandInTimeout);
+
+	bool Passed = Connected && LogiLedStandInCheckSequence(StandIn) && StandIn.CheckColors(TEXT("Enumeration"), Frame);
+
+	if (!Connected)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Enumeration: the client did not connect and update all devices"));
+	}
+	else if (Passed)
+	{
+		UE_LOG(LogLogiLed, Display, TEXT("Enumeration: passed"));
+
+		// a new frame updates whole devices
+		for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+		{
+			Frame[KeyIndex] = FColor((uint8)((KeyIndex * 7) % 101), (uint8)((KeyIndex * 13 + 30) % 101), (uint8)((KeyIndex * 29 + 60) % 101));
+		}
+
+		Passed &= LogiLedStandInCheckUpdates(TEXT("New frame"), SendFrame(SendTime, 2), { KeyboardUpdate, MouseUpdate }) && StandIn.CheckColors(TEXT("New frame"), Frame);
+
+		// an unchanged frame sends nothing
+		Passed &= LogiLedStandInCheckUpdates(TEXT("Unchanged frame"), SendFrame(SendTime, 0), { });
+
+		// a change in the small zone sends only that zone
+		LogiLedStandInRotate(SideKeys, Frame);
+		Passed &= LogiLedStandInCheckUpdates(TEXT("Zone change"), SendFrame(SendTime, 1), { SideZoneUpdate }) && StandIn.CheckColors(TEXT("Zone change"), Frame);
+
+		// a change in most of the device's LEDs sends the whole device
+		LogiLedStandInRotate(MainKeys, Frame);
+		Passed &= LogiLedStandInCheckUpdates(TEXT("Device change"), SendFrame(SendTime, 1), { KeyboardUpdate }) && StandIn.CheckColors(TEXT("Device change"), Frame);
+
+		// a change in the average updates the mouse as well
+		FColor& SideKey = Frame[SideKeys[0]];
+		SideKey = FColor((SideKey.R < 50) ? 100 : 0, (SideKey.G < 50) ? 100 : 0, (SideKey.B < 50) ? 100 : 0);
+		Passed &= LogiLedStandInCheckUpdates(TEXT("Average change"), SendFrame(SendTime, 2), { SideZoneUpdate, MouseUpdate }) && StandIn.CheckColors(TEXT("Average change"), Frame);
+
+		// frames within one interval are coalesced, and the next update sends the latest one
+		LogiLedStandInRotate(SideKeys, Frame);
+		bool Coalesced = LogiLedStandInCheckUpdates(TEXT("Coalescing"), SendFrame(CoalesceTime, 1), { SideZoneUpdate });
+
+		for (int32 Step = 0; Step < 3; ++Step)
+		{
+			LogiLedStandInRotate(SideKeys, Frame);
+			Coalesced = Coalesced && LogiLedStandInCheckUpdates(TEXT("Coalescing"), SendFrame(CoalesceTime, 0), { });
+		}
+
+		Coalesced = Coalesced && LogiLedStandInCheckUpdates(TEXT("Coalescing"), SendFrame(SendTime, 1), { SideZoneUpdate }) && StandIn.CheckColors(TEXT("Coalescing"), Frame);
+		Passed &= Coalesced;
+
+		if (Passed)
+		{
+			UE_LOG(LogLogiLed, Display, TEXT("Frame updates and coalescing: passed"));
+		}
+
+		// measure the rates while a zone changes every few milliseconds
+		const int32 FirstUpdate = StandIn.NumUpdates;
+		const int64 FirstBytes = StandIn.NumBytes;
+		const double StartTime = FPlatformTime::Seconds();
+		double LastTime = StartTime;
+
+		while (LastTime - StartTime < Duration)
+		{
+			FPlatformProcess::Sleep(0.002f);
+
+			const double Time = FPlatformTime::Seconds();
+
+			LogiLedStandInRotate(SideKeys, Frame);
+			FLogiLedSnapshot::Get().Publish(Frame);
+			Client.Tick((float)(Time - LastTime));
+			StandIn.Poll();
+
+			LastTime = Time;
+		}
+
+		LogiLedStandInWait(StandIn, []() { return false; }, LogiLedStandInQuietTime);
+
+		const double Seconds = FMath::Max(LastTime - StartTime, 0.000001);
+		const double PacketsPerSecond = (StandIn.NumUpdates - FirstUpdate) / Seconds;
+		const double BytesPerSecond = (StandIn.NumBytes - FirstBytes) / Seconds;
+
+		UE_LOG(LogLogiLed, Display, TEXT("Received %.1f LED update packets and %.0f bytes per second (the client reports %.1f and %.0f)"), PacketsPerSecond, BytesPerSecond, Client.GetPacketsPerSecond(), Client.GetBytesPerSecond());
+
+		// one zone changes per frame, so there is at most one packet per interval
+		if (PacketsPerSecond > 1.1 / LogiLedStandInSendInterval)
+		{
+			UE_LOG(LogLogiLed, Error, TEXT("Rate: the client sent more than one frame per interval"));
+			Passed = false;
+		}
+
+		// the last frame is sent once the interval has elapsed
+		SendFrame(SendTime, 0);
+		Passed &= StandIn.CheckColors(TEXT("Rate"), Frame);
+	}
+
+	Client.Stop();
+	StandIn.Close();
+
+	if (!Passed || StandIn.Error)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("OpenRGB checks failed"));
+		return 1;
+	}
+
+	UE_LOG(LogLogiLed, Display, TEXT("All OpenRGB checks passed"));
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedVerifyOpenRgbCommandlet.generated.h"
+
+
+/**
+ * Verifies the OpenRGB backend against a local stand-in server.
+ *
+ * The stand-in listens on the loopback interface, answers the device
+ * enumeration with a keyboard that has two zones and a mouse, and records all
+ * packets it receives. The backend is ticked manually while frames are
+ * published to the snapshot, and the commandlet checks that:
+ *
+ *     - the client name and enumeration requests come first, and each device is
+ *       switched to its custom mode before any of its LEDs are updated,
+ *     - the first frame updates whole devices, unchanged frames send nothing,
+ *       a change in a small zone sends only that zone, and a change in most of
+ *       a device's LEDs sends the whole device,
+ *     - frames published within one send interval are coalesced, and the next
+ *       update carries the latest frame,
+ *     - the LEDs on the stand-in always match the last frame that was sent.
+ *
+ * Then, a frame with changing keys is published every few milliseconds for a
+ * while, and the packets and bytes per second that arrive at the stand-in are
+ * reported. No OpenRGB installation or hardware is needed.
+ *
+ * Usage:
+ *     UE4Editor-Cmd.exe <Project> -run=LogiLedVerifyOpenRgb [-Port=<Port>] [-Duration=<Seconds>]
+ *
+ * The port defaults to any free port, and the duration of the rate measurement
+ * to 2 seconds.
+ */
+UCLASS()
+class ULogiLedVerifyOpenRgbCommandlet
+	: public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Default constructor. */
+	ULogiLedVerifyOpenRgbCommandlet();
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+};
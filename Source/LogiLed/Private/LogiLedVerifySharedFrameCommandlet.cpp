@@ -0,0 +1,166 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedVerifySharedFrameCommandlet.h"
+#include "LogiLedKeys.h"
+#include "LogiLedPrivate.h"
+#include "LogiLedSharedFrame.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/Parse.h"
+
+
+/**
+ * Get the color of a key in a test frame.
+ *
+ * @param FrameNumber The frame's number.
+ * @param KeyIndex The key.
+ * @return The color.
+ */
+static FColor LogiLedSharedFrameTestColor(uint64 FrameNumber, int32 KeyIndex)
+{
+	const uint32 Value = (uint32)FrameNumber + KeyIndex;
+
+	return FColor((uint8)Value, (uint8)(Value >> 8), (uint8)(Value >> 16), (uint8)(Value >> 24));
+}
+
+
+/* ULogiLedVerifySharedFrameCommandlet structors
+ *****************************************************************************/
+
+ULogiLedVerifySharedFrameCommandlet::ULogiLedVerifySharedFrameCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 ULogiLedVerifySharedFrameCommandlet::Main(const FString& Params)
+{
+	float Duration = 5.0f;
+	FString Name = TEXT("LogiLedFrameTest");
+
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("Name="), Name);
+
+	const uint32 ReadWrite = (uint32)FPlatformMemory::ESharedMemoryAccess::Read | (uint32)FPlatformMemory::ESharedMemoryAccess::Write;
+	FPlatformMemory::FSharedMemoryRegion* WriterRegion = FPlatformMemory::MapNamedSharedMemoryRegion(Name, true, ReadWrite, sizeof(FLogiLedSharedFrameData));
+
+	if (WriterRegion == nullptr)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to create shared memory %s"), *Name);
+		return 1;
+	}
+
+	FPlatformMemory::FSharedMemoryRegion* ReaderRegion = FPlatformMemory::MapNamedSharedMemoryRegion(Name, false, (uint32)FPlatformMemory::ESharedMemoryAccess::Read, sizeof(FLogiLedSharedFrameData));
+
+	if (ReaderRegion == nullptr)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Failed to open shared memory %s"), *Name);
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(WriterRegion);
+		return 1;
+	}
+
+	FLogiLedSharedFrameData& WriterData = *(FLogiLedSharedFrameData*)WriterRegion->GetAddress();
+	const FLogiLedSharedFrameData& ReaderData = *(const FLogiLedSharedFrameData*)ReaderRegion->GetAddress();
+
+	FMemory::Memzero(WriterData);
+	WriterData.Magic = LogiLedSharedFrameMagic;
+	WriterData.Version = LogiLedSharedFrameVersion;
+
+	// write frames as fast as possible on another thread
+	FThreadSafeBool StopWriting(false);
+
+	TFuture<uint64> Writer = Async<uint64>(EAsyncExecution::Thread, [&WriterData, &StopWriting]()
+	{
+		FColor Colors[LogiLedKeys::Count];
+		uint64 FrameNumber = 0;
+
+		while (!StopWriting)
+		{
+			++FrameNumber;
+
+			for (int32 KeyIndex = 0; KeyIndex < LogiLedKeys::Count; ++KeyIndex)
+			{
+				Colors[KeyIndex] = LogiLedSharedFrameTestColor(FrameNumber, KeyIndex);
+			}
+
+			FLogiLedSharedFrame::Write(WriterData, Colors, LogiLedKeys::Count, FrameNumber);
+		}
+
+		return FrameNumber;
+	});
+
+	FLogiLedSharedFrameData Frame;
+	uint64 NumReads = 0;
+	uint64 NumGaveUp = 0;
+	uint64 NumTorn = 0;
+	uint64 NumDistinct = 0;
+	uint64 LastTimestamp = 0;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	while (FPlatformTime::Seconds() - StartTime < Duration)
+	{
+		if (!FLogiLedSharedFrame::Read(ReaderData, Frame))
+		{
+			++NumGaveUp;
+			continue;
+		}
+
+		++NumReads;
+
+		// frames are never older than the last one that was read
+		bool Torn = (Frame.Magic != LogiLedSharedFrameMagic) || (Frame.Timestamp < LastTimestamp);
+
+		if ((Frame.Timestamp > 0) && !Torn)
+		{
+			Torn = (Frame.NumKeys != LogiLedKeys::Count);
+
+			for (int32 KeyIndex = 0; (KeyIndex < LogiLedKeys::Count) && !Torn; ++KeyIndex)
+			{
+				const FColor Expected = LogiLedSharedFrameTestColor(Frame.Timestamp, KeyIndex);
+				const uint8* Color = Frame.Colors[KeyIndex];
+
+				Torn = (Color[0] != Expected.R) || (Color[1] != Expected.G) || (Color[2] != Expected.B) || (Color[3] != Expected.A);
+			}
+		}
+
+		if (Torn)
+		{
+			++NumTorn;
+			continue;
+		}
+
+		NumDistinct += (Frame.Timestamp != LastTimestamp) ? 1 : 0;
+		LastTimestamp = Frame.Timestamp;
+	}
+
+	StopWriting = true;
+
+	const uint64 NumWritten = Writer.Get();
+	const double Seconds = FMath::Max(FPlatformTime::Seconds() - StartTime, 0.000001);
+
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(ReaderRegion);
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(WriterRegion);
+
+	UE_LOG(LogLogiLed, Display, TEXT("Wrote %llu frames (%.0f per second)"), NumWritten, NumWritten / Seconds);
+	UE_LOG(LogLogiLed, Display, TEXT("Read %llu frames (%.0f per second, %llu distinct), %llu reads gave up while frames were written"), NumReads, NumReads / Seconds, NumDistinct, NumGaveUp);
+
+	if (NumTorn > 0)
+	{
+		UE_LOG(LogLogiLed, Error, TEXT("Found %llu torn frames"), NumTorn);
+		return 1;
+	}
+
+	UE_LOG(LogLogiLed, Display, TEXT("Found no torn frames"));
+
+	return (NumReads > 0) ? 0 : 1;
+}
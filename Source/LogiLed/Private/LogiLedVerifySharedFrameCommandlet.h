@@ -0,0 +1,43 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedVerifySharedFrameCommandlet.generated.h"
+
+
+/**
+ * Verifies that readers of the shared LED frame never see torn frames.
+ *
+ * A writer thread writes frames into a shared memory segment as fast as it
+ * can, while the commandlet reads them through a second mapping of the same
+ * segment, like an external tool would. Each frame encodes its number in its
+ * timestamp and in all of its colors, so that any mix of two frames is found.
+ * The write and read rates, the number of reads that gave up while frames
+ * were being written, and the number of torn frames are reported.
+ *
+ * Usage:
+ *     UE4Editor-Cmd.exe <Project> -run=LogiLedVerifySharedFrame [-Duration=<Seconds>] [-Name=<Segment>]
+ *
+ * The duration defaults to 5 seconds, and the segment name to LogiLedFrameTest.
+ */
+UCLASS()
+class ULogiLedVerifySharedFrameCommandlet
+	: public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Default constructor. */
+	ULogiLedVerifySharedFrameCommandlet();
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+};
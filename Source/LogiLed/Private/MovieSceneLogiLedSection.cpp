@@ -0,0 +1,72 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "MovieSceneLogiLedSection.h"
+
+
+/* UMovieSceneSection interface
+ *****************************************************************************/
+
+void UMovieSceneLogiLedSection::DilateSection(float DilationFactor, float Origin, TSet<FKeyHandle>& KeyHandles)
+{
+	Super::DilateSection(DilationFactor, Origin, KeyHandles);
+
+	RedCurve.ScaleCurve(Origin, DilationFactor, KeyHandles);
+	GreenCurve.ScaleCurve(Origin, DilationFactor, KeyHandles);
+	BlueCurve.ScaleCurve(Origin, DilationFactor, KeyHandles);
+}
+
+
+void UMovieSceneLogiLedSection::GetKeyHandles(TSet<FKeyHandle>& OutKeyHandles, TRange<float> TimeRange) const
+{
+	if (!TimeRange.Overlaps(GetRange()))
+	{
+		return;
+	}
+
+	for (const FRichCurve* Curve : { &RedCurve, &GreenCurve, &BlueCurve })
+	{
+		for (auto It(Curve->GetKeyHandleIterator()); It; ++It)
+		{
+			if (TimeRange.Contains(Curve->GetKeyTime(It.Key())))
+			{
+				OutKeyHandles.Add(It.Key());
+			}
+		}
+	}
+}
+
+
+TOptional<float> UMovieSceneLogiLedSection::GetKeyTime(FKeyHandle KeyHandle) const
+{
+	for (const FRichCurve* Curve : { &RedCurve, &GreenCurve, &BlueCurve })
+	{
+		if (Curve->IsKeyHandleValid(KeyHandle))
+		{
+			return TOptional<float>(Curve->GetKeyTime(KeyHandle));
+		}
+	}
+
+	return TOptional<float>();
+}
+
+
+void UMovieSceneLogiLedSection::MoveSection(float DeltaPosition, TSet<FKeyHandle>& KeyHandles)
+{
+	Super::MoveSection(DeltaPosition, KeyHandles);
+
+	RedCurve.ShiftCurve(DeltaPosition, KeyHandles);
+	GreenCurve.ShiftCurve(DeltaPosition, KeyHandles);
+	BlueCurve.ShiftCurve(DeltaPosition, KeyHandles);
+}
+
+
+void UMovieSceneLogiLedSection::SetKeyTime(FKeyHandle KeyHandle, float Time)
+{
+	for (FRichCurve* Curve : { &RedCurve, &GreenCurve, &BlueCurve })
+	{
+		if (Curve->IsKeyHandleValid(KeyHandle))
+		{
+			Curve->SetKeyTime(KeyHandle, Time);
+		}
+	}
+}
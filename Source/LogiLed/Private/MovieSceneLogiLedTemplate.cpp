@@ -0,0 +1,260 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "MovieSceneLogiLedTemplate.h"
+#include "LogiLedBlueprintLibrary.h"
+#include "LogiLedFrame.h"
+#include "MovieSceneLogiLedSection.h"
+
+#include "Evaluation/MovieSceneExecutionTokens.h"
+#include "Evaluation/PersistentEvaluationData.h"
+#include "IMovieScenePlayer.h"
+
+
+/* Local helpers
+ *****************************************************************************/
+
+/** Restores the lighting manager after Sequencer stops driving it. */
+struct FLogiLedPreAnimatedToken
+	: IMovieScenePreAnimatedGlobalToken
+{
+	virtual void RestoreState(IMovieScenePlayer& Player) override
+	{
+		ULogiLedBlueprintLibrary::GetManager().ClearOverrideFrame(ELogiLedOverrideLayer::Sequencer);
+	}
+};
+
+
+/** Produces the token that restores the lighting manager. */
+struct FLogiLedPreAnimatedTokenProducer
+	: IMovieScenePreAnimatedGlobalTokenProducer
+{
+	virtual IMovieScenePreAnimatedGlobalTokenPtr CacheExistingState() const override
+	{
+		return FLogiLedPreAnimatedToken();
+	}
+};
+
+
+/** Registers each evaluated section with the lighting manager's pre-animated state. */
+struct FLogiLedExecutionToken
+	: IMovieSceneExecutionToken
+{
+	virtual void Execute(const FMovieSceneContext& Context, const FMovieSceneEvaluationOperand& Operand, FPersistentEvaluationData& PersistentData, IMovieScenePlayer& Player) override
+	{
+		Player.SavePreAnimatedState(TMovieSceneAnimTypeID<FLogiLedExecutionToken>(), FLogiLedPreAnimatedTokenProducer());
+	}
+};
+
+
+/**
+ * Combines the output of all LogiLed sections into one override frame.
+ *
+ * Sections evaluated later take precedence. The frame is handed to the manager
+ * once per evaluation, which only wakes up if it changed.
+ */
+struct FLogiLedSharedExecutionToken
+	: IMovieSceneSharedExecutionToken
+{
+	FLogiLedFrame Frame;
+
+	FLogiLedSharedExecutionToken()
+	{
+		Frame.Fill(FColor(0, 0, 0, 0));
+	}
+
+	void Add(const TArray<ELogiLedKeys>& Keys, FColor Color)
+	{
+		if (Keys.Num() == 0)
+		{
+			Frame.Fill(Color);
+		}
+		else
+		{
+			for (ELogiLedKeys Key : Keys)
+			{
+				Frame.Colors[(int32)Key] = Color;
+			}
+		}
+	}
+
+	virtual void Execute(FPersistentEvaluationData& PersistentData, IMovieScenePlayer& Player) override
+	{
+		ULogiLedBlueprintLibrary::GetManager().SetOverrideFrame(ELogiLedOverrideLayer::Sequencer, Frame);
+	}
+
+	static FMovieSceneSharedDataId GetSharedDataId()
+	{
+		static FMovieSceneSharedDataId SharedDataId = FMovieSceneSharedDataId::Allocate();
+		return SharedDataId;
+	}
+};
+
+
+/**
+ * Evaluate a set of color curves.
+ *
+ * @param RedCurve The red channel curve.
+ * @param GreenCurve The green channel curve.
+ * @param BlueCurve The blue channel curve.
+ * @param Time The time to evaluate.
+ * @return Percentage color.
+ */
+static FColor EvalPercentage(const FRichCurve& RedCurve, const FRichCurve& GreenCurve, const FRichCurve& BlueCurve, float Time)
+{
+	return FLogiLedFrame::ToPercentage(FLinearColor(RedCurve.Eval(Time), GreenCurve.Eval(Time), BlueCurve.Eval(Time)));
+}
+
+
+/**
+ * Check whether a curve is constant between two of its key times, or outside of its keys.
+ *
+ * @param Curve The curve to check.
+ * @param StartTime The start of the segment.
+ * @param EndTime The end of the segment (MAX_flt for the segment after the last key).
+ * @return true if the curve's value does not change within the segment, false otherwise.
+ */
+static bool LogiLedIsSegmentConstant(const FRichCurve& Curve, float StartTime, float EndTime)
+{
+	const TArray<FRichCurveKey>& CurveKeys = Curve.GetConstRefOfKeys();
+
+	if (CurveKeys.Num() == 0)
+	{
+		return true;
+	}
+
+	auto IsConstantExtrapolation = [](ERichCurveExtrapolation Extrapolation)
+	{
+		return (Extrapolation == RCCE_Constant) || (Extrapolation == RCCE_None);
+	};
+
+	if (EndTime <= CurveKeys[0].Time)
+	{
+		return IsConstantExtrapolation(Curve.PreInfinityExtrap);
+	}
+
+	if (StartTime >= CurveKeys.Last().Time)
+	{
+		return IsConstantExtrapolation(Curve.PostInfinityExtrap);
+	}
+
+	// the key that starts the curve segment which contains this segment
+	int32 KeyIndex = CurveKeys.Num() - 1;
+
+	while (CurveKeys[KeyIndex].Time > StartTime)
+	{
+		--KeyIndex;
+	}
+
+	const FRichCurveKey& Key = CurveKeys[KeyIndex];
+
+	return (Key.InterpMode == RCIM_Constant) || ((Key.InterpMode == RCIM_Linear) && (Key.Value == CurveKeys[KeyIndex + 1].Value));
+}
+
+
+/* FMovieSceneLogiLedSectionTemplate structors
+ *****************************************************************************/
+
+FMovieSceneLogiLedSectionTemplate::FMovieSceneLogiLedSectionTemplate(const UMovieSceneLogiLedSection& Section)
+	: Keys(Section.Keys)
+	, RedCurve(Section.RedCurve)
+	, GreenCurve(Section.GreenCurve)
+	, BlueCurve(Section.BlueCurve)
+{
+	for (const FRichCurve* Curve : { &RedCurve, &GreenCurve, &BlueCurve })
+	{
+		for (const FRichCurveKey& Key : Curve->GetConstRefOfKeys())
+		{
+			SegmentTimes.Add(Key.Time);
+		}
+	}
+
+	SegmentTimes.Sort();
+
+	for (int32 Index = SegmentTimes.Num() - 1; Index > 0; --Index)
+	{
+		if (SegmentTimes[Index] == SegmentTimes[Index - 1])
+		{
+			SegmentTimes.RemoveAt(Index, 1, false);
+		}
+	}
+
+	SegmentTimes.Shrink();
+	SegmentColors.SetNumUninitialized(SegmentTimes.Num() + 1);
+
+	for (int32 SegmentIndex = 0; SegmentIndex < SegmentColors.Num(); ++SegmentIndex)
+	{
+		const float StartTime = (SegmentIndex > 0) ? SegmentTimes[SegmentIndex - 1] : -MAX_flt;
+		const float EndTime = (SegmentIndex < SegmentTimes.Num()) ? SegmentTimes[SegmentIndex] : MAX_flt;
+
+		const bool Constant =
+			LogiLedIsSegmentConstant(RedCurve, StartTime, EndTime) &&
+			LogiLedIsSegmentConstant(GreenCurve, StartTime, EndTime) &&
+			LogiLedIsSegmentConstant(BlueCurve, StartTime, EndTime);
+
+		if (Constant)
+		{
+			// constant segments before the first key take the first key's value
+			SegmentColors[SegmentIndex] = EvalPercentage(RedCurve, GreenCurve, BlueCurve, (SegmentIndex > 0) ? StartTime : EndTime);
+		}
+		else
+		{
+			SegmentColors[SegmentIndex] = FColor(0, 0, 0, 0);
+		}
+	}
+}
+
+
+/* FMovieSceneLogiLedSectionTemplate implementation
+ *****************************************************************************/
+
+FColor FMovieSceneLogiLedSectionTemplate::GetColor(float Time) const
+{
+	// count the key times at or before the given time, which is the segment's index
+	int32 Low = 0;
+	int32 High = SegmentTimes.Num();
+
+	while (Low < High)
+	{
+		const int32 Middle = (Low + High) / 2;
+
+		if (SegmentTimes[Middle] <= Time)
+		{
+			Low = Middle + 1;
+		}
+		else
+		{
+			High = Middle;
+		}
+	}
+
+	// templates that were compiled before segments were cached have no segment colors
+	if (!SegmentColors.IsValidIndex(Low) || (SegmentColors[Low].A == 0))
+	{
+		return EvalPercentage(RedCurve, GreenCurve, BlueCurve, Time);
+	}
+
+	return SegmentColors[Low];
+}
+
+
+/* FMovieSceneEvalTemplate interface
+ *****************************************************************************/
+
+void FMovieSceneLogiLedSectionTemplate::Evaluate(const FMovieSceneEvaluationOperand& Operand, const FMovieSceneContext& Context, const FPersistentEvaluationData& PersistentData, FMovieSceneExecutionTokens& ExecutionTokens) const
+{
+	const FMovieSceneSharedDataId SharedDataId = FLogiLedSharedExecutionToken::GetSharedDataId();
+
+	if (ExecutionTokens.FindShared(SharedDataId) == nullptr)
+	{
+		ExecutionTokens.AddShared(SharedDataId, FLogiLedSharedExecutionToken());
+	}
+
+	static_cast<FLogiLedSharedExecutionToken*>(ExecutionTokens.FindShared(SharedDataId))->Add(Keys, GetColor(Context.GetTime()));
+	ExecutionTokens.Add(FLogiLedExecutionToken());
+}
+
+
+UScriptStruct& FMovieSceneLogiLedSectionTemplate::GetScriptStructImpl() const
+{
+	return *StaticStruct();
+}
@@ -0,0 +1,86 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/RichCurve.h"
+#include "Evaluation/MovieSceneEvalTemplate.h"
+#include "LogiLedTypes.h"
+#include "UObject/ObjectMacros.h"
+
+#include "MovieSceneLogiLedTemplate.generated.h"
+
+class UMovieSceneLogiLedSection;
+
+
+/**
+ * Evaluation template for LogiLed sections.
+ *
+ * When the sequence is compiled, the key times of the section's curves are
+ * merged into one sorted list of segment breakpoints, and the percentage color
+ * of each segment over which no channel changes is cached. Evaluating the
+ * template is a binary search in that list, no matter in which order the
+ * sequence is scrubbed, and the copied curves are only evaluated in segments
+ * that are animated, at the exact time.
+ */
+USTRUCT()
+struct FMovieSceneLogiLedSectionTemplate
+	: public FMovieSceneEvalTemplate
+{
+	GENERATED_BODY()
+
+	/** Default constructor. */
+	FMovieSceneLogiLedSectionTemplate() { }
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param Section The section to create the template for.
+	 */
+	FMovieSceneLogiLedSectionTemplate(const UMovieSceneLogiLedSection& Section);
+
+protected:
+
+	/**
+	 * Get the section's percentage color at the given time.
+	 *
+	 * @param Time The time to evaluate.
+	 * @return Percentage color.
+	 */
+	FColor GetColor(float Time) const;
+
+private:
+
+	//~ FMovieSceneEvalTemplate interface
+
+	virtual void Evaluate(const FMovieSceneEvaluationOperand& Operand, const FMovieSceneContext& Context, const FPersistentEvaluationData& PersistentData, FMovieSceneExecutionTokens& ExecutionTokens) const override;
+	virtual UScriptStruct& GetScriptStructImpl() const override;
+
+private:
+
+	/** The keys to light (all keys if empty). */
+	UPROPERTY()
+	TArray<ELogiLedKeys> Keys;
+
+	/** Key times of all curves, in ascending order and without duplicates. */
+	UPROPERTY()
+	TArray<float> SegmentTimes;
+
+	/**
+	 * The percentage color of each segment, or zero alpha if the color changes within the segment.
+	 *
+	 * Segment 0 is before the first key time, and segment i starts at key time i - 1.
+	 */
+	UPROPERTY()
+	TArray<FColor> SegmentColors;
+
+	/** Copies of the section's curves, for animated segments. */
+	UPROPERTY()
+	FRichCurve RedCurve;
+
+	UPROPERTY()
+	FRichCurve GreenCurve;
+
+	UPROPERTY()
+	FRichCurve BlueCurve;
+};
@@ -0,0 +1,90 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "MovieSceneLogiLedTrack.h"
+#include "MovieSceneLogiLedSection.h"
+#include "MovieSceneLogiLedTemplate.h"
+
+#define LOCTEXT_NAMESPACE "MovieSceneLogiLedTrack"
+
+
+/* UMovieSceneTrack interface
+ *****************************************************************************/
+
+void UMovieSceneLogiLedTrack::AddSection(UMovieSceneSection& Section)
+{
+	Sections.Add(&Section);
+}
+
+
+UMovieSceneSection* UMovieSceneLogiLedTrack::CreateNewSection()
+{
+	return NewObject<UMovieSceneLogiLedSection>(this, NAME_None, RF_Transactional);
+}
+
+
+FMovieSceneEvalTemplatePtr UMovieSceneLogiLedTrack::CreateTemplateForSection(const UMovieSceneSection& InSection) const
+{
+	return FMovieSceneLogiLedSectionTemplate(*CastChecked<const UMovieSceneLogiLedSection>(&InSection));
+}
+
+
+const TArray<UMovieSceneSection*>& UMovieSceneLogiLedTrack::GetAllSections() const
+{
+	return Sections;
+}
+
+
+TRange<float> UMovieSceneLogiLedTrack::GetSectionBoundaries() const
+{
+	TArray<TRange<float>> Bounds;
+
+	for (const UMovieSceneSection* Section : Sections)
+	{
+		Bounds.Add(Section->GetRange());
+	}
+
+	return TRange<float>::Hull(Bounds);
+}
+
+
+bool UMovieSceneLogiLedTrack::HasSection(const UMovieSceneSection& Section) const
+{
+	return Sections.Contains(&Section);
+}
+
+
+bool UMovieSceneLogiLedTrack::IsEmpty() const
+{
+	return (Sections.Num() == 0);
+}
+
+
+void UMovieSceneLogiLedTrack::RemoveAllAnimationData()
+{
+	Sections.Empty();
+}
+
+
+void UMovieSceneLogiLedTrack::RemoveSection(UMovieSceneSection& Section)
+{
+	Sections.Remove(&Section);
+}
+
+
+bool UMovieSceneLogiLedTrack::SupportsMultipleRows() const
+{
+	return true;
+}
+
+
+#if WITH_EDITORONLY_DATA
+
+FText UMovieSceneLogiLedTrack::GetDefaultDisplayName() const
+{
+	return LOCTEXT("TrackName", "LogiLed");
+}
+
+#endif
+
+
+#undef LOCTEXT_NAMESPACE
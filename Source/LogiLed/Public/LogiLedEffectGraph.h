@@ -0,0 +1,188 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "LogiLedTypes.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedEffectGraph.generated.h"
+
+class UCurveLinearColor;
+
+
+/**
+ * Enumerates the node types of LED effect graphs.
+ */
+UENUM()
+enum class ELogiLedEffectNodeType : uint8
+{
+	/** Color on all keys. */
+	Constant,
+
+	/** Color curve played on all keys. */
+	Curve,
+
+	/** Gradient from Color to End Color along Direction over the key positions. */
+	Gradient,
+
+	/** Animated noise between Color and End Color over the key positions. */
+	Noise,
+
+	/** Color scaled by a gameplay parameter. */
+	Parameter,
+
+	/** Blend of Input A and Input B. */
+	Blend,
+
+	/** Input A on the masked keys, or scaled by the brightness of Input B. */
+	Mask,
+
+	/** Brightness of Input A remapped from the input range to Color - End Color. */
+	Remap
+};
+
+
+/**
+ * Enumerates the modes of blend nodes in LED effect graphs.
+ */
+UENUM()
+enum class ELogiLedEffectBlendMode : uint8
+{
+	/** Interpolate from Input A to Input B by Alpha. */
+	Lerp,
+
+	/** Add Input B times Alpha to Input A. */
+	Add,
+
+	/** Multiply Input A by Input B. */
+	Multiply,
+
+	/** Take the brighter channels of both inputs. */
+	Max
+};
+
+
+/**
+ * A node in an LED effect graph.
+ *
+ * Which properties are used depends on the node type. Inputs refer to other
+ * nodes by their index in the graph, and must refer to earlier nodes.
+ */
+USTRUCT(BlueprintType)
+struct LOGILED_API FLogiLedEffectNode
+{
+	GENERATED_BODY()
+
+	/** The node type. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Node")
+	ELogiLedEffectNodeType Type;
+
+	/** Index of the node's first input (Blend, Mask and Remap nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Inputs")
+	int32 InputA;
+
+	/** Index of the node's second input (Blend nodes, and optionally Mask nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Inputs")
+	int32 InputB;
+
+	/** Index of a node whose brightness scales Alpha (Blend nodes, optional). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Inputs")
+	int32 AlphaInput;
+
+	/** The node's color, or the start color of ranges. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sources")
+	FLinearColor Color;
+
+	/** The end color of ranges (Gradient, Noise and Remap nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sources")
+	FLinearColor EndColor;
+
+	/** The color curve to play (Curve nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sources")
+	UCurveLinearColor* Curve;
+
+	/** Whether to loop the color curve (Curve nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sources")
+	bool Looping;
+
+	/** Direction of the gradient on the keyboard, with X to the right and Y down (Gradient nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sources")
+	FVector2D Direction;
+
+	/** Number of noise cells across the keyboard (Noise nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sources", meta=(ClampMin="0.0"))
+	float Scale;
+
+	/** Playback rate (Curve and Noise nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sources")
+	float Speed;
+
+	/** Name of the gameplay parameter (Parameter nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sources")
+	FName ParameterName;
+
+	/** How to blend the inputs (Blend nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Operations")
+	ELogiLedEffectBlendMode BlendMode;
+
+	/** Blend weight (Blend nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Operations")
+	float Alpha;
+
+	/** The keys to keep (Mask nodes, all keys if empty). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Operations")
+	TArray<ELogiLedKeys> Keys;
+
+	/** Input brightness that maps to Color (Remap nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Operations")
+	float InMin;
+
+	/** Input brightness that maps to End Color (Remap nodes). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Operations")
+	float InMax;
+
+public:
+
+	/** Default constructor. */
+	FLogiLedEffectNode();
+};
+
+
+/**
+ * An LED effect defined as a graph of sources and operations.
+ *
+ * The graph is compiled into a flat program when it is played, and the
+ * program is evaluated natively on all keys once per LED frame, so complex
+ * lighting does not need per-key Blueprint logic every tick. The output of
+ * the last node is the lighting of all per-key devices.
+ */
+UCLASS(BlueprintType)
+class LOGILED_API ULogiLedEffectGraph
+	: public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The graph's nodes, in evaluation order. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LogiLed")
+	TArray<FLogiLedEffectNode> Nodes;
+
+#if WITH_EDITORONLY_DATA
+
+	/** Why the graph could not be compiled (empty if it compiles). */
+	UPROPERTY(VisibleAnywhere, Transient, Category="LogiLed")
+	FString CompileError;
+
+#endif
+
+public:
+
+	//~ UObject interface
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+};
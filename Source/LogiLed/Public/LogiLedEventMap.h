@@ -0,0 +1,217 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ArrayView.h"
+#include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
+#include "LogiLedTypes.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/WeakObjectPtr.h"
+
+#include "LogiLedEventMap.generated.h"
+
+class UCurveLinearColor;
+
+
+/**
+ * Enumerates the effects that gameplay events can trigger.
+ */
+UENUM()
+enum class ELogiLedEventEffect : uint8
+{
+	/** Alternate between Color and off every half Interval. */
+	Flash,
+
+	/** Fade from Color to End Color and back once per Interval. */
+	Pulse,
+
+	/** Play a color curve. */
+	Curve
+};
+
+
+/**
+ * Maps a gameplay tag to an LED effect.
+ */
+USTRUCT(BlueprintType)
+struct LOGILED_API FLogiLedEventBinding
+{
+	GENERATED_BODY()
+
+	/** The event's tag (only exact matches trigger the effect). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Event")
+	FGameplayTag Tag;
+
+	/** The effect to play. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effect")
+	ELogiLedEventEffect Effect;
+
+	/** The keys to play the effect on (all keys of all devices if empty). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effect")
+	TArray<ELogiLedKeys> Keys;
+
+	/** The flash color, or the start color of pulses. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effect")
+	FLinearColor Color;
+
+	/** The end color of pulses. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effect")
+	FLinearColor EndColor;
+
+	/** The color curve to play (Curve effects). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effect")
+	UCurveLinearColor* Curve;
+
+	/** How long flashes and pulses play (in seconds, rounded to whole intervals, 0 = until replaced by another event). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effect", meta=(ClampMin="0.0"))
+	float Duration;
+
+	/** Period of flashes and pulses (in seconds). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effect", meta=(ClampMin="0.05"))
+	float Interval;
+
+	/** The priority of the effect's keys. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effect")
+	ELogiLedPriority Priority;
+
+public:
+
+	/** Default constructor. */
+	FLogiLedEventBinding();
+};
+
+
+/**
+ * Maps gameplay events to LED effects.
+ *
+ * The bindings are compiled into a flat hash table when the asset is loaded,
+ * with flashes and pulses baked into color curves, so firing an event is one
+ * table lookup plus queuing the event in the LED manager, without executing
+ * any Blueprint logic. The manager starts queued events on its next tick, and
+ * starts events that fire more than once per tick only once.
+ *
+ * Events play on their own layer, on top of static lighting and animations,
+ * which keep playing underneath. An event only replaces earlier events on the
+ * same keys. Effects with a finite duration end without leaving their last
+ * color behind, so their keys return to the lighting they had before.
+ */
+UCLASS(BlueprintType)
+class LOGILED_API ULogiLedEventMap
+	: public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** A compiled binding. */
+	struct FAction
+	{
+		/** The curve to play (baked for flashes and pulses, invalid if the asset was deleted since compiling). */
+		TWeakObjectPtr<UCurveLinearColor> Curve;
+
+		/** Range of the action's keys in the key table (0 keys = all devices). */
+		int32 FirstKey;
+		int32 NumKeys;
+
+		/** The priority of the action's keys. */
+		ELogiLedPriority Priority;
+	};
+
+public:
+
+	/** The event bindings (several bindings may share a tag). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LogiLed")
+	TArray<FLogiLedEventBinding> Bindings;
+
+public:
+
+	/** Compile the bindings into the dispatch table. */
+	void Compile();
+
+	/**
+	 * Fire a gameplay event.
+	 *
+	 * @param Tag The event's tag.
+	 * @return true if the tag is bound, false otherwise.
+	 */
+	UFUNCTION(BlueprintCallable, Category="LogiLed|Events")
+	bool FireEvent(FGameplayTag Tag);
+
+	/**
+	 * Get the compiled actions of an event.
+	 *
+	 * @param EventIndex The event's index in the dispatch table.
+	 * @return The actions (empty if the index is out of date).
+	 */
+	TArrayView<const FAction> GetActions(int32 EventIndex) const;
+
+	/**
+	 * Get the keys of a compiled action.
+	 *
+	 * @param Action The action.
+	 * @return Key indices.
+	 */
+	TArrayView<const uint8> GetKeys(const FAction& Action) const
+	{
+		return TArrayView<const uint8>(KeyTable.GetData() + Action.FirstKey, Action.NumKeys);
+	}
+
+	/**
+	 * Find an event in the dispatch table.
+	 *
+	 * @param Tag The event's tag.
+	 * @return The event's index, or INDEX_NONE if the tag is not bound.
+	 */
+	int32 FindEvent(FGameplayTag Tag) const;
+
+public:
+
+	//~ UObject interface
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+
+	/**
+	 * Bake a flash or pulse into a color curve.
+	 *
+	 * @param Binding The binding to bake.
+	 * @return The curve.
+	 */
+	UCurveLinearColor* BakeCurve(const FLogiLedEventBinding& Binding);
+
+private:
+
+	/** A slot in the dispatch table. */
+	struct FSlot
+	{
+		/** The event's tag (invalid if the slot is empty). */
+		FGameplayTag Tag;
+
+		/** Range of the event's actions. */
+		int32 FirstAction;
+		int32 NumActions;
+	};
+
+	/** Open addressing hash table of bound events (power of two size). */
+	TArray<FSlot> Slots;
+
+	/** Actions of all events, grouped by event. */
+	TArray<FAction> Actions;
+
+	/** Keys of all actions. */
+	TArray<uint8> KeyTable;
+
+	/** Curves baked for flashes and pulses. */
+	UPROPERTY(Transient)
+	TArray<UCurveLinearColor*> BakedCurves;
+
+	/** Whether the bindings were compiled. */
+	bool Compiled;
+};
@@ -0,0 +1,96 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Templates/Function.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedMaterialComponent.generated.h"
+
+class FLogiLedReadback;
+class UMaterialInterface;
+class UTextureRenderTarget2D;
+
+
+/**
+ * Drives per-key lighting from a material.
+ *
+ * The material is rendered into a tiny render target that has one pixel per
+ * key bitmap cell, at a fixed rate instead of every frame. The pixels are read
+ * back asynchronously and set as the per-key lighting a few frames later.
+ *
+ * Where nothing can be rendered, such as in automation tests with a null RHI,
+ * a CPU function can be used to compute the pixels instead.
+ */
+UCLASS(ClassGroup=LogiLed, meta=(BlueprintSpawnableComponent))
+class LOGILED_API ULogiLedMaterialComponent
+	: public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The material to render (uses the Draw Material to Render Target conventions). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LogiLed")
+	UMaterialInterface* Material;
+
+	/** How many times per second to update the lighting. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LogiLed", meta=(ClampMin="1.0", ClampMax="60.0"))
+	float UpdatesPerSecond;
+
+public:
+
+	/** Default constructor. */
+	ULogiLedMaterialComponent();
+
+public:
+
+	/** Function that computes the linear color of a bitmap pixel from its UV coordinates and the time. */
+	typedef TFunction<FLinearColor(const FVector2D& UV, float Time)> FCpuFunction;
+
+	/**
+	 * Set a function that computes the pixels on the CPU.
+	 *
+	 * The function is used instead of the material if the material is not
+	 * set or if nothing can be rendered.
+	 *
+	 * @param InCpuFunction The function to use.
+	 */
+	void SetCpuFunction(FCpuFunction&& InCpuFunction);
+
+public:
+
+	//~ UActorComponent interface
+
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	/** Render the material and queue its readback. */
+	void RenderMaterial();
+
+	/** Evaluate the CPU function and apply its pixels. */
+	void RunCpuFunction();
+
+private:
+
+	/** Function that computes the pixels on the CPU (optional). */
+	FCpuFunction CpuFunction;
+
+	/** Pixels that were read back or computed. */
+	TArray<FColor> Pixels;
+
+	/** Reads the render target back to the CPU. */
+	TSharedPtr<FLogiLedReadback, ESPMode::ThreadSafe> Readback;
+
+	/** The render target that the material is rendered into. */
+	UPROPERTY(Transient)
+	UTextureRenderTarget2D* RenderTarget;
+
+	/** Time until the next update (in seconds). */
+	float TimeUntilUpdate;
+};
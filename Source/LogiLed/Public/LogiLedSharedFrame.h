@@ -0,0 +1,156 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/UnrealString.h"
+#include "CoreTypes.h"
+#include "HAL/PlatformMemory.h"
+#include "Math/Color.h"
+
+#include "LogiLedSnapshot.h"
+
+
+/**
+ * Layout of the shared memory segment that live frames are exported to.
+ *
+ * All values are little-endian. The sequence number is incremented before
+ * and after each frame is written, so it is odd while a frame is being
+ * written. Readers copy the segment and use the copy only if the sequence
+ * number was even and did not change while copying, see FLogiLedSharedFrame::Read.
+ */
+struct FLogiLedSharedFrameData
+{
+	/** Identifies the segment (LogiLedSharedFrameMagic, 'LLED'). */
+	uint32 Magic;
+
+	/** Layout version (1). */
+	uint32 Version;
+
+	/** Sequence number of the frame (odd while a frame is being written, restarts at 0 when the segment is opened). */
+	uint32 Sequence;
+
+	/** Number of valid entries in Colors. */
+	uint32 NumKeys;
+
+	/** Time at which the frame was published (in microseconds since the Unix epoch). */
+	uint64 Timestamp;
+
+	/** The colors of all keys as red, green, blue and alpha bytes, indexed by ELogiLedKeys. */
+	uint8 Colors[FLogiLedSnapshot::MaxKeys][4];
+};
+
+
+/** Magic number at the start of the shared frame segment. */
+constexpr uint32 LogiLedSharedFrameMagic = 0x44454c4c;
+
+/** Version of the shared frame layout. */
+constexpr uint32 LogiLedSharedFrameVersion = 1;
+
+
+/**
+ * Exports the most recently flushed per-key lighting to other processes.
+ *
+ * Bridges to other lighting ecosystems and stream overlays can map a named
+ * shared memory segment and read the current frame at any time, without any
+ * system calls. Frames are written with a sequence lock: the manager never
+ * waits for readers, and readers retry if a frame was written while they
+ * copied it, so they never see a torn frame.
+ *
+ * While the segment is open, the manager publishes every frame that it
+ * composes. The segment keeps the last frame while the manager is idle.
+ */
+class LOGILED_API FLogiLedSharedFrame
+{
+public:
+
+	/** Default name of the shared memory segment. */
+	static const TCHAR* DefaultName;
+
+public:
+
+	/**
+	 * Get the shared frame of the global LED manager.
+	 *
+	 * @return The shared frame.
+	 */
+	static FLogiLedSharedFrame& Get();
+
+	/**
+	 * Read a consistent copy of a shared frame.
+	 *
+	 * This is the reference implementation for readers in other processes.
+	 *
+	 * @param Shared The shared segment.
+	 * @param OutFrame Will contain the copy.
+	 * @param MaxAttempts Maximum number of copies to try while frames are being written.
+	 * @return true on success, false if no consistent copy could be made.
+	 * @see Write
+	 */
+	static bool Read(const FLogiLedSharedFrameData& Shared, FLogiLedSharedFrameData& OutFrame, int32 MaxAttempts = 100);
+
+	/**
+	 * Write a frame into a shared segment.
+	 *
+	 * Only one thread may write into a segment at a time.
+	 *
+	 * @param Shared The shared segment.
+	 * @param Colors The displayable colors of the keys.
+	 * @param NumColors The number of colors (at most FLogiLedSnapshot::MaxKeys).
+	 * @param Timestamp The frame's time (in microseconds since the Unix epoch).
+	 * @see Read
+	 */
+	static void Write(FLogiLedSharedFrameData& Shared, const FColor* Colors, int32 NumColors, uint64 Timestamp);
+
+public:
+
+	/** Default constructor. */
+	FLogiLedSharedFrame();
+
+public:
+
+	/**
+	 * Check whether the segment is open.
+	 *
+	 * @return true if frames are exported, false otherwise.
+	 */
+	bool IsOpen() const
+	{
+		return (Data != nullptr);
+	}
+
+	/**
+	 * Create or open the shared memory segment and start exporting frames.
+	 *
+	 * Closes any previously opened segment.
+	 *
+	 * @param Name The segment's name.
+	 * @return true on success, false if the segment could not be mapped.
+	 * @see Close
+	 */
+	bool Open(const FString& Name);
+
+	/**
+	 * Stop exporting frames and close the segment.
+	 *
+	 * @see Open
+	 */
+	void Close();
+
+	/**
+	 * Publish a frame.
+	 *
+	 * @param Colors The percentage colors of all keys (FLogiLedSnapshot::GetNumKeys() entries).
+	 */
+	void Publish(const FColor* Colors);
+
+private:
+
+	/** The mapped segment (only valid while open). */
+	FPlatformMemory::FSharedMemoryRegion* Region;
+
+	/** The segment's contents (only valid while open). */
+	FLogiLedSharedFrameData* Data;
+
+	/** Displayable colors of the frame being published. */
+	FColor DisplayColors[FLogiLedSnapshot::MaxKeys];
+};
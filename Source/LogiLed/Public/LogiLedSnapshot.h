@@ -0,0 +1,178 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Math/Box2D.h"
+#include "Math/Color.h"
+
+
+/**
+ * A lock-free snapshot of the most recently composed per-key lighting.
+ *
+ * Viewers, such as the editor's LED preview or the frame dump commandlet,
+ * let the manager know that they are attached, and the manager then publishes
+ * every frame it composes. This is the lighting the manager wants to show,
+ * which the SDK may not have received yet, because keys that do not fit into
+ * the SDK time budget are deferred, and nothing is sent while the SDK is not
+ * available. Frames are handed over through a triple buffer, so the manager
+ * never waits for a viewer, and a viewer always reads a complete frame. When
+ * no viewer is attached, nothing is published. Attaching a viewer requests a
+ * frame, so that viewers see the current lighting even if the manager is idle.
+ *
+ * Colors are SDK percentages (0-100 per channel), indexed by ELogiLedKeys.
+ * Frames are published from one thread and read from one thread at a time,
+ * which may be the same thread. Several viewers may read the snapshot, so a
+ * read does not tell whether the frame is new to the viewer that reads it.
+ */
+class LOGILED_API FLogiLedSnapshot
+{
+public:
+
+	/** Maximum number of keys in a frame (the number of key names in the SDK). */
+	static const int32 MaxKeys = 126;
+
+public:
+
+	/**
+	 * Get the snapshot of the global LED manager.
+	 *
+	 * @return The snapshot.
+	 */
+	static FLogiLedSnapshot& Get();
+
+	/**
+	 * Get the area of a key on a virtual keyboard.
+	 *
+	 * Keys that are part of the lighting bitmap are placed at their bitmap
+	 * cell. All other keys, such as G-keys and logos, are placed in an extra
+	 * row below the bitmap.
+	 *
+	 * @param KeyIndex The key (an ELogiLedKeys value).
+	 * @return The key's area (in key cells).
+	 * @see GetLayoutSize
+	 */
+	static FBox2D GetKeyBounds(int32 KeyIndex);
+
+	/**
+	 * Get the display name of a key.
+	 *
+	 * @param KeyIndex The key (an ELogiLedKeys value).
+	 * @return The key's name.
+	 */
+	static const TCHAR* GetKeyName(int32 KeyIndex);
+
+	/**
+	 * Convert a percentage color from a frame to a displayable color.
+	 *
+	 * @param Percentage The percentage color.
+	 * @return The color with byte channels.
+	 */
+	static FColor ToDisplayColor(FColor Percentage)
+	{
+		return FColor((uint8)((Percentage.R * 255 + 50) / 100), (uint8)((Percentage.G * 255 + 50) / 100), (uint8)((Percentage.B * 255 + 50) / 100));
+	}
+
+	/**
+	 * Get the size of the virtual keyboard.
+	 *
+	 * @return Width and height (in key cells).
+	 * @see GetKeyBounds
+	 */
+	static FVector2D GetLayoutSize();
+
+	/**
+	 * Get the number of keys in a frame.
+	 *
+	 * @return Number of keys.
+	 */
+	static int32 GetNumKeys();
+
+public:
+
+	/** Default constructor. */
+	FLogiLedSnapshot();
+
+public:
+
+	/**
+	 * Attach a viewer.
+	 *
+	 * @see HasViewers, RemoveViewer
+	 */
+	void AddViewer()
+	{
+		NumViewers.Increment();
+		FrameRequested = true;
+	}
+
+	/**
+	 * Check whether any viewers are attached.
+	 *
+	 * @return true if frames should be published, false otherwise.
+	 */
+	bool HasViewers() const
+	{
+		return (NumViewers.GetValue() > 0);
+	}
+
+	/**
+	 * Check whether a viewer is waiting for its first frame.
+	 *
+	 * @return true if a frame should be published even if nothing changed, false otherwise.
+	 */
+	bool IsFrameRequested() const
+	{
+		return FrameRequested;
+	}
+
+	/**
+	 * Detach a viewer.
+	 *
+	 * @see AddViewer
+	 */
+	void RemoveViewer()
+	{
+		NumViewers.Decrement();
+	}
+
+public:
+
+	/**
+	 * Publish a frame.
+	 *
+	 * @param Colors The percentage colors of all keys (GetNumKeys() entries).
+	 * @see Read
+	 */
+	void Publish(const FColor* Colors);
+
+	/**
+	 * Read the most recently published frame.
+	 *
+	 * @param OutColors Will contain the percentage colors of all keys (GetNumKeys() entries).
+	 * @see Publish
+	 */
+	void Read(FColor* OutColors);
+
+private:
+
+	/** Frame storage. */
+	FColor Buffers[3][MaxKeys];
+
+	/** Index of the buffer that holds the latest frame, and whether it was not swapped into the read buffer yet. */
+	volatile int32 Latest;
+
+	/** Whether a frame should be published even if nothing changed. */
+	FThreadSafeBool FrameRequested;
+
+	/** Number of attached viewers. */
+	FThreadSafeCounter NumViewers;
+
+	/** Index of the buffer being read (owned by the reader). */
+	int32 ReadIndex;
+
+	/** Index of the buffer being written (owned by the publisher). */
+	int32 WriteIndex;
+};
@@ -0,0 +1,283 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "CoreTypes.h"
+#include "Math/Color.h"
+#include "UObject/ObjectMacros.h"
+
+#include "LogiLedTypes.generated.h"
+
+class UCurveLinearColor;
+
+
+/**
+ * Enumerates available Logitech LED device types.
+ */
+UENUM()
+enum class ELogiLedDeviceType : uint8
+{
+	All,
+	Monochrome,
+	PerKeyRgb,
+	Rgb
+};
+
+
+/**
+ * Enumerates priorities of lighting updates.
+ *
+ * When the SDK time budget per frame is exhausted, updates with higher
+ * priority are sent first, and the rest are deferred to later frames.
+ */
+UENUM()
+enum class ELogiLedPriority : uint8
+{
+	/** Background lighting, such as ambient effects. */
+	Ambient,
+
+	/** Lighting that reflects gameplay state. */
+	Gameplay,
+
+	/** Lighting that must be seen immediately, such as warnings. */
+	Alert
+};
+
+
+/**
+ * Enumerates available Logitech LED mouse and keyboard keys.
+ */
+UENUM()
+enum class ELogiLedKeys : uint8
+{
+	Escape,
+	F1,
+	F2,
+	F3,
+	F4,
+	F5,
+	F6,
+	F7,
+	F8,
+	F9,
+	F10,
+	F11,
+	F12,
+	PrintScreen,
+	ScrollLock,
+	PauseBreak,
+	Tilde,
+	One,
+	Two,
+	Three,
+	Four,
+	Five,
+	Six,
+	Seven,
+	Eight,
+	Nine,
+	Zero,
+	Minus,
+	Equals,
+	Backspace,
+	Insert,
+	Home,
+	PageUp,
+	NumLock,
+	NumSlash,
+	NumAsterisk,
+	NumMinus,
+	Tab,
+	Q,
+	W,
+	E,
+	R,
+	T,
+	Y,
+	U,
+	I,
+	O,
+	P,
+	OpenBracket,
+	CloseBracket,
+	Backslash,
+	KeyboardDelete,
+	End,
+	PageDown,
+	NumSeven,
+	NumEight,
+	NumNine,
+	NumPlus,
+	CapsLock,
+	A,
+	S,
+	D,
+	F,
+	G,
+	H,
+	J,
+	K,
+	L,
+	Semicolon,
+	Apostrophe,
+	Enter,
+	NumFour,
+	NumFive,
+	NumSix,
+	LeftShift,
+	Z,
+	X,
+	C,
+	V,
+	B,
+	N,
+	M,
+	Comma,
+	Period,
+	ForwardSlash,
+	RightShift,
+	ArrowUp,
+	NumOne,
+	NumTwo,
+	NumThree,
+	NumEnter,
+	LeftControl,
+	LeftWindows,
+	LeftAlt,
+	Space,
+	RightAlt,
+	RightWindows,
+	ApplicationSelect,
+	RightControl,
+	ArrowLeft,
+	ArrowDown,
+	ArrowRight,
+	NumZero,
+	NumPeriod,
+	G1,
+	G2,
+	G3,
+	G4,
+	G5,
+	G6,
+	G7,
+	G8,
+	G9,
+	GLogo,
+	GBadge
+};
+
+
+/**
+ * Identifies an effect that is playing on Logitech LED devices.
+ *
+ * Handles stay safe to use after the effect ended: they simply no longer
+ * refer to anything, even if the effect's storage was reused.
+ */
+USTRUCT(BlueprintType)
+struct FLogiLedEffectHandle
+{
+	GENERATED_BODY()
+
+	/** Index of the effect in the effect pool. */
+	UPROPERTY()
+	int32 Index;
+
+	/** Generation of the effect pool slot at the time the effect was started. */
+	UPROPERTY()
+	int32 Generation;
+
+public:
+
+	/** Default constructor (invalid handle). */
+	FLogiLedEffectHandle()
+		: Index(INDEX_NONE)
+		, Generation(0)
+	{ }
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InIndex Index of the effect in the effect pool.
+	 * @param InGeneration Generation of the effect pool slot.
+	 */
+	FLogiLedEffectHandle(int32 InIndex, int32 InGeneration)
+		: Index(InIndex)
+		, Generation(InGeneration)
+	{ }
+
+public:
+
+	/** Whether this handle was ever assigned to an effect. */
+	bool IsValid() const
+	{
+		return (Index != INDEX_NONE);
+	}
+
+	/** Reset this handle so that it no longer refers to an effect. */
+	void Invalidate()
+	{
+		Index = INDEX_NONE;
+		Generation = 0;
+	}
+
+public:
+
+	bool operator==(const FLogiLedEffectHandle& Other) const
+	{
+		return (Index == Other.Index) && (Generation == Other.Generation);
+	}
+
+	bool operator!=(const FLogiLedEffectHandle& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+
+/**
+ * Describes a meter that shows a value as a bar of keys.
+ *
+ * Keys are lit from the first to the last key as the value goes from 0 to 1.
+ */
+USTRUCT(BlueprintType)
+struct FLogiLedMeter
+{
+	GENERATED_BODY()
+
+	/** The keys that make up the bar, from empty to full. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Meter")
+	TArray<ELogiLedKeys> Keys;
+
+	/** Color of the first key when lit. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Meter")
+	FLinearColor StartColor;
+
+	/** Color of the last key when lit. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Meter")
+	FLinearColor EndColor;
+
+	/** Color of unlit keys. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Meter")
+	FLinearColor EmptyColor;
+
+	/** Optional gradient along the bar, from time 0 (first key) to 1 (last key), replaces Start Color and End Color. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Meter")
+	UCurveLinearColor* Gradient;
+
+	/** Number of brightness steps per key (1 = keys are either lit or unlit). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Meter", meta=(ClampMin="1", ClampMax="100"))
+	int32 StepsPerKey;
+
+public:
+
+	/** Default constructor. */
+	FLogiLedMeter()
+		: StartColor(FLinearColor::Green)
+		, EndColor(FLinearColor::Red)
+		, EmptyColor(FLinearColor::Black)
+		, Gradient(nullptr)
+		, StepsPerKey(1)
+	{ }
+};
@@ -0,0 +1,61 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/RichCurve.h"
+#include "LogiLedTypes.h"
+#include "MovieSceneSection.h"
+#include "UObject/ObjectMacros.h"
+
+#include "MovieSceneLogiLedSection.generated.h"
+
+
+/**
+ * A movie scene section that animates the lighting of Logitech LED keys.
+ */
+UCLASS(MinimalAPI)
+class UMovieSceneLogiLedSection
+	: public UMovieSceneSection
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The keys to light (all keys if empty). */
+	UPROPERTY(EditAnywhere, Category="LogiLed")
+	TArray<ELogiLedKeys> Keys;
+
+	/** Red, green and blue curves. */
+	UPROPERTY()
+	FRichCurve RedCurve;
+
+	UPROPERTY()
+	FRichCurve GreenCurve;
+
+	UPROPERTY()
+	FRichCurve BlueCurve;
+
+public:
+
+	/**
+	 * Evaluate the section's color at the given time.
+	 *
+	 * @param Time The time to evaluate.
+	 * @return The linear color.
+	 */
+	FLinearColor Eval(float Time) const
+	{
+		return FLinearColor(RedCurve.Eval(Time), GreenCurve.Eval(Time), BlueCurve.Eval(Time));
+	}
+
+public:
+
+	//~ UMovieSceneSection interface
+
+	virtual void DilateSection(float DilationFactor, float Origin, TSet<FKeyHandle>& KeyHandles) override;
+	virtual void GetKeyHandles(TSet<FKeyHandle>& OutKeyHandles, TRange<float> TimeRange) const override;
+	virtual TOptional<float> GetKeyTime(FKeyHandle KeyHandle) const override;
+	virtual void MoveSection(float DeltaPosition, TSet<FKeyHandle>& KeyHandles) override;
+	virtual void SetKeyTime(FKeyHandle KeyHandle, float Time) override;
+};
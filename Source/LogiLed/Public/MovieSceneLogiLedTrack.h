@@ -0,0 +1,51 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MovieSceneTrack.h"
+#include "UObject/ObjectMacros.h"
+
+#include "MovieSceneLogiLedTrack.generated.h"
+
+
+/**
+ * A master track that drives Logitech LED lighting from a level sequence.
+ *
+ * The key times of each section are cached when the sequence is compiled, with
+ * the colors of segments that do not change, so that playback and scrubbing
+ * only evaluate the curves while the color is actually animated. The output
+ * overrides the lighting manager's keys on the Sequencer layer, and is sent to
+ * the SDK with the manager's regular flush.
+ */
+UCLASS(MinimalAPI)
+class UMovieSceneLogiLedTrack
+	: public UMovieSceneTrack
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ UMovieSceneTrack interface
+
+	virtual void AddSection(UMovieSceneSection& Section) override;
+	virtual UMovieSceneSection* CreateNewSection() override;
+	virtual FMovieSceneEvalTemplatePtr CreateTemplateForSection(const UMovieSceneSection& InSection) const override;
+	virtual const TArray<UMovieSceneSection*>& GetAllSections() const override;
+	virtual TRange<float> GetSectionBoundaries() const override;
+	virtual bool HasSection(const UMovieSceneSection& Section) const override;
+	virtual bool IsEmpty() const override;
+	virtual void RemoveAllAnimationData() override;
+	virtual void RemoveSection(UMovieSceneSection& Section) override;
+	virtual bool SupportsMultipleRows() const override;
+
+#if WITH_EDITORONLY_DATA
+	virtual FText GetDefaultDisplayName() const override;
+#endif
+
+private:
+
+	/** The track's sections. */
+	UPROPERTY()
+	TArray<UMovieSceneSection*> Sections;
+};
@@ -0,0 +1,33 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+namespace UnrealBuildTool.Rules
+{
+	public class LogiLedEditor : ModuleRules
+	{
+		public LogiLedEditor(ReadOnlyTargetRules Target) : base(Target)
+		{
+			PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+			PrivateDependencyModuleNames.AddRange(
+				new string[] {
+					"Core",
+					"CoreUObject",
+					"EditorStyle",
+					"Engine",
+					"LogiLed",
+					"MovieScene",
+					"MovieSceneTools",
+					"Sequencer",
+					"Slate",
+					"SlateCore",
+					"UnrealEd",
+					"WorkspaceMenuStructure",
+				});
+
+			PrivateIncludePaths.AddRange(
+				new string[] {
+					"LogiLedEditor/Private",
+				});
+		}
+	}
+}
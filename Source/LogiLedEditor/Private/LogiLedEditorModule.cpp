@@ -0,0 +1,80 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedTrackEditor.h"
+#include "Widgets/SLogiLedPreview.h"
+
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Docking/TabManager.h"
+#include "ISequencerModule.h"
+#include "Modules/ModuleInterface.h"
+#include "Modules/ModuleManager.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "WorkspaceMenuStructure.h"
+#include "WorkspaceMenuStructureModule.h"
+
+#define LOCTEXT_NAMESPACE "FLogiLedEditorModule"
+
+
+/** Name of the LED preview tab. */
+static const FName LogiLedPreviewTabName("LogiLedPreview");
+
+
+/**
+ * Implements the LogiLedEditor module.
+ */
+class FLogiLedEditorModule
+	: public IModuleInterface
+{
+public:
+
+	//~ IModuleInterface interface
+
+	virtual void StartupModule() override
+	{
+		ISequencerModule& SequencerModule = FModuleManager::LoadModuleChecked<ISequencerModule>("Sequencer");
+		TrackEditorHandle = SequencerModule.RegisterTrackEditor(FOnCreateTrackEditor::CreateStatic(&FLogiLedTrackEditor::CreateTrackEditor));
+
+		FGlobalTabmanager::Get()->RegisterNomadTabSpawner(LogiLedPreviewTabName, FOnSpawnTab::CreateStatic(&FLogiLedEditorModule::HandleSpawnPreviewTab))
+			.SetDisplayName(LOCTEXT("PreviewTabTitle", "LED Preview"))
+			.SetTooltipText(LOCTEXT("PreviewTooltipText", "Shows the Logitech LED output on a virtual keyboard."))
+			.SetGroup(WorkspaceMenu::GetMenuStructure().GetDeveloperToolsDebugCategory());
+	}
+
+	virtual void ShutdownModule() override
+	{
+		if (FSlateApplication::IsInitialized())
+		{
+			FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(LogiLedPreviewTabName);
+		}
+
+		ISequencerModule* SequencerModule = FModuleManager::GetModulePtr<ISequencerModule>("Sequencer");
+
+		if (SequencerModule != nullptr)
+		{
+			SequencerModule->UnRegisterTrackEditor(TrackEditorHandle);
+		}
+	}
+
+private:
+
+	/** Callback for spawning the LED preview tab. */
+	static TSharedRef<SDockTab> HandleSpawnPreviewTab(const FSpawnTabArgs& SpawnTabArgs)
+	{
+		return SNew(SDockTab)
+			.TabRole(ETabRole::NomadTab)
+			[
+				SNew(SLogiLedPreview)
+			];
+	}
+
+private:
+
+	/** Handle of the registered Sequencer track editor. */
+	FDelegateHandle TrackEditorHandle;
+};
+
+
+IMPLEMENT_MODULE(FLogiLedEditorModule, LogiLedEditor);
+
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,55 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedSection.h"
+
+#include "FloatCurveKeyArea.h"
+#include "ISectionLayoutBuilder.h"
+#include "MovieSceneLogiLedSection.h"
+#include "SequencerSectionPainter.h"
+
+#define LOCTEXT_NAMESPACE "FLogiLedSection"
+
+
+/* FLogiLedSection structors
+ *****************************************************************************/
+
+FLogiLedSection::FLogiLedSection(UMovieSceneLogiLedSection& InSection)
+	: Section(InSection)
+{ }
+
+
+/* ISequencerSection interface
+ *****************************************************************************/
+
+void FLogiLedSection::GenerateSectionLayout(ISectionLayoutBuilder& LayoutBuilder) const
+{
+	LayoutBuilder.AddKeyArea("R", LOCTEXT("RedArea", "Red"), MakeShareable(new FFloatCurveKeyArea(&Section.RedCurve, &Section, FLinearColor::Red)));
+	LayoutBuilder.AddKeyArea("G", LOCTEXT("GreenArea", "Green"), MakeShareable(new FFloatCurveKeyArea(&Section.GreenCurve, &Section, FLinearColor::Green)));
+	LayoutBuilder.AddKeyArea("B", LOCTEXT("BlueArea", "Blue"), MakeShareable(new FFloatCurveKeyArea(&Section.BlueCurve, &Section, FLinearColor::Blue)));
+}
+
+
+UMovieSceneSection* FLogiLedSection::GetSectionObject()
+{
+	return &Section;
+}
+
+
+FText FLogiLedSection::GetSectionTitle() const
+{
+	if (Section.Keys.Num() == 0)
+	{
+		return LOCTEXT("AllKeysTitle", "All Keys");
+	}
+
+	return FText::Format(LOCTEXT("KeysTitleFormat", "{0} Keys"), FText::AsNumber(Section.Keys.Num()));
+}
+
+
+int32 FLogiLedSection::OnPaintSection(FSequencerSectionPainter& Painter) const
+{
+	return Painter.PaintSectionBackground();
+}
+
+
+#undef LOCTEXT_NAMESPACE
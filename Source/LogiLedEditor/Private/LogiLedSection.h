@@ -0,0 +1,39 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ISequencerSection.h"
+
+class UMovieSceneLogiLedSection;
+
+
+/**
+ * Sequencer section for LogiLed sections.
+ */
+class FLogiLedSection
+	: public ISequencerSection
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InSection The section object being visualized.
+	 */
+	FLogiLedSection(UMovieSceneLogiLedSection& InSection);
+
+public:
+
+	//~ ISequencerSection interface
+
+	virtual void GenerateSectionLayout(ISectionLayoutBuilder& LayoutBuilder) const override;
+	virtual UMovieSceneSection* GetSectionObject() override;
+	virtual FText GetSectionTitle() const override;
+	virtual int32 OnPaintSection(FSequencerSectionPainter& Painter) const override;
+
+private:
+
+	/** The section object being visualized. */
+	UMovieSceneLogiLedSection& Section;
+};
@@ -0,0 +1,141 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "LogiLedTrackEditor.h"
+#include "LogiLedSection.h"
+
+#include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "ISequencer.h"
+#include "MovieScene.h"
+#include "MovieSceneLogiLedSection.h"
+#include "MovieSceneLogiLedTrack.h"
+#include "ScopedTransaction.h"
+#include "SequencerUtilities.h"
+
+#define LOCTEXT_NAMESPACE "FLogiLedTrackEditor"
+
+
+/** Default length of new sections (in seconds). */
+static const float LogiLedDefaultSectionLength = 5.0f;
+
+
+/* FLogiLedTrackEditor structors
+ *****************************************************************************/
+
+FLogiLedTrackEditor::FLogiLedTrackEditor(TSharedRef<ISequencer> InSequencer)
+	: FMovieSceneTrackEditor(InSequencer)
+{ }
+
+
+/* FLogiLedTrackEditor static functions
+ *****************************************************************************/
+
+TSharedRef<ISequencerTrackEditor> FLogiLedTrackEditor::CreateTrackEditor(TSharedRef<ISequencer> OwningSequencer)
+{
+	return MakeShareable(new FLogiLedTrackEditor(OwningSequencer));
+}
+
+
+/* FMovieSceneTrackEditor interface
+ *****************************************************************************/
+
+void FLogiLedTrackEditor::BuildAddTrackMenu(FMenuBuilder& MenuBuilder)
+{
+	MenuBuilder.AddMenuEntry(
+		LOCTEXT("AddLogiLedTrack", "LogiLed Track"),
+		LOCTEXT("AddLogiLedTrackTooltip", "Adds a new track that controls Logitech LED lighting."),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateRaw(this, &FLogiLedTrackEditor::HandleAddLogiLedTrackMenuEntryExecute))
+	);
+}
+
+
+TSharedPtr<SWidget> FLogiLedTrackEditor::BuildOutlinerEditWidget(const FGuid& ObjectBinding, UMovieSceneTrack* Track, const FBuildEditWidgetParams& Params)
+{
+	return FSequencerUtilities::MakeAddButton(
+		LOCTEXT("AddSection", "Section"),
+		FOnGetContent::CreateSP(this, &FLogiLedTrackEditor::HandleAddSectionButtonGetContent, Cast<UMovieSceneLogiLedTrack>(Track)),
+		Params.NodeIsHovered
+	);
+}
+
+
+TSharedRef<ISequencerSection> FLogiLedTrackEditor::MakeSectionInterface(UMovieSceneSection& SectionObject, UMovieSceneTrack& Track, FGuid ObjectBinding)
+{
+	check(SupportsType(SectionObject.GetOuter()->GetClass()));
+
+	return MakeShareable(new FLogiLedSection(*CastChecked<UMovieSceneLogiLedSection>(&SectionObject)));
+}
+
+
+bool FLogiLedTrackEditor::SupportsType(TSubclassOf<UMovieSceneTrack> Type) const
+{
+	return (Type == UMovieSceneLogiLedTrack::StaticClass());
+}
+
+
+/* FLogiLedTrackEditor implementation
+ *****************************************************************************/
+
+void FLogiLedTrackEditor::AddNewSection(UMovieSceneLogiLedTrack* Track)
+{
+	if (Track == nullptr)
+	{
+		return;
+	}
+
+	const FScopedTransaction Transaction(LOCTEXT("AddLogiLedSection_Transaction", "Add LogiLed Section"));
+
+	Track->Modify();
+
+	const float StartTime = GetSequencer()->GetLocalTime();
+	UMovieSceneSection* NewSection = Track->CreateNewSection();
+	{
+		NewSection->SetStartTime(StartTime);
+		NewSection->SetEndTime(StartTime + LogiLedDefaultSectionLength);
+	}
+
+	Track->AddSection(*NewSection);
+
+	GetSequencer()->NotifyMovieSceneDataChanged(EMovieSceneDataChangeType::MovieSceneStructureItemAdded);
+}
+
+
+/* FLogiLedTrackEditor callbacks
+ *****************************************************************************/
+
+void FLogiLedTrackEditor::HandleAddLogiLedTrackMenuEntryExecute()
+{
+	UMovieScene* FocusedMovieScene = GetFocusedMovieScene();
+
+	if (FocusedMovieScene == nullptr)
+	{
+		return;
+	}
+
+	const FScopedTransaction Transaction(LOCTEXT("AddLogiLedTrack_Transaction", "Add LogiLed Track"));
+
+	FocusedMovieScene->Modify();
+
+	UMovieSceneLogiLedTrack* NewTrack = FocusedMovieScene->AddMasterTrack<UMovieSceneLogiLedTrack>();
+	ensure(NewTrack != nullptr);
+
+	AddNewSection(NewTrack);
+}
+
+
+TSharedRef<SWidget> FLogiLedTrackEditor::HandleAddSectionButtonGetContent(UMovieSceneLogiLedTrack* Track)
+{
+	FMenuBuilder MenuBuilder(true, nullptr);
+
+	MenuBuilder.AddMenuEntry(
+		LOCTEXT("AddSectionEntry", "Add Section"),
+		LOCTEXT("AddSectionEntryTooltip", "Adds a new section at the current time."),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateSP(this, &FLogiLedTrackEditor::AddNewSection, Track))
+	);
+
+	return MenuBuilder.MakeWidget();
+}
+
+
+#undef LOCTEXT_NAMESPACE
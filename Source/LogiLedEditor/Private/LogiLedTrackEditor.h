@@ -0,0 +1,62 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MovieSceneTrackEditor.h"
+
+class FMenuBuilder;
+class UMovieSceneLogiLedTrack;
+
+
+/**
+ * Track editor for LogiLed tracks.
+ */
+class FLogiLedTrackEditor
+	: public FMovieSceneTrackEditor
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InSequencer The sequencer instance to be used by this tool.
+	 */
+	FLogiLedTrackEditor(TSharedRef<ISequencer> InSequencer);
+
+public:
+
+	/**
+	 * Create a new track editor instance (called by the Sequencer module).
+	 *
+	 * @param OwningSequencer The sequencer instance to be used by this tool.
+	 * @return The new instance of this class.
+	 */
+	static TSharedRef<ISequencerTrackEditor> CreateTrackEditor(TSharedRef<ISequencer> OwningSequencer);
+
+public:
+
+	//~ FMovieSceneTrackEditor interface
+
+	virtual void BuildAddTrackMenu(FMenuBuilder& MenuBuilder) override;
+	virtual TSharedPtr<SWidget> BuildOutlinerEditWidget(const FGuid& ObjectBinding, UMovieSceneTrack* Track, const FBuildEditWidgetParams& Params) override;
+	virtual TSharedRef<ISequencerSection> MakeSectionInterface(UMovieSceneSection& SectionObject, UMovieSceneTrack& Track, FGuid ObjectBinding) override;
+	virtual bool SupportsType(TSubclassOf<UMovieSceneTrack> Type) const override;
+
+protected:
+
+	/**
+	 * Add a new section to the given track at the current time.
+	 *
+	 * @param Track The track to add the section to.
+	 */
+	void AddNewSection(UMovieSceneLogiLedTrack* Track);
+
+private:
+
+	/** Callback for executing the "Add LogiLed Track" menu entry. */
+	void HandleAddLogiLedTrackMenuEntryExecute();
+
+	/** Callback for getting the content of the track's "Add Section" button. */
+	TSharedRef<SWidget> HandleAddSectionButtonGetContent(UMovieSceneLogiLedTrack* Track);
+};
@@ -0,0 +1,152 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "Widgets/SLogiLedPreview.h"
+
+#include "EditorStyleSet.h"
+#include "Rendering/DrawElements.h"
+
+#define LOCTEXT_NAMESPACE "SLogiLedPreview"
+
+
+/** Size of a key cell when the widget is not stretched (in slate units). */
+static const float LogiLedPreviewKeySize = 32.0f;
+
+
+/* SLogiLedPreview structors
+ *****************************************************************************/
+
+SLogiLedPreview::SLogiLedPreview()
+	: HoveredKey(INDEX_NONE)
+{
+	FMemory::Memzero(Colors);
+}
+
+
+SLogiLedPreview::~SLogiLedPreview()
+{
+	FLogiLedSnapshot::Get().RemoveViewer();
+}
+
+
+/* SLogiLedPreview interface
+ *****************************************************************************/
+
+void SLogiLedPreview::Construct(const FArguments& InArgs)
+{
+	FLogiLedSnapshot::Get().AddViewer();
+
+	SetToolTipText(TAttribute<FText>::Create(TAttribute<FText>::FGetter::CreateSP(this, &SLogiLedPreview::HandleToolTipText)));
+}
+
+
+/* SWidget interface
+ *****************************************************************************/
+
+FVector2D SLogiLedPreview::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FLogiLedSnapshot::GetLayoutSize() * LogiLedPreviewKeySize;
+}
+
+
+void SLogiLedPreview::OnMouseLeave(const FPointerEvent& MouseEvent)
+{
+	SLeafWidget::OnMouseLeave(MouseEvent);
+
+	HoveredKey = INDEX_NONE;
+}
+
+
+FReply SLogiLedPreview::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	float Scale = 1.0f;
+	FVector2D Offset;
+	GetLayoutTransform(MyGeometry.GetLocalSize(), Scale, Offset);
+
+	const FVector2D CellPosition = (MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition()) - Offset) / Scale;
+
+	HoveredKey = INDEX_NONE;
+
+	for (int32 KeyIndex = 0; KeyIndex < FLogiLedSnapshot::GetNumKeys(); ++KeyIndex)
+	{
+		if (FLogiLedSnapshot::GetKeyBounds(KeyIndex).IsInside(CellPosition))
+		{
+			HoveredKey = KeyIndex;
+			break;
+		}
+	}
+
+	return FReply::Unhandled();
+}
+
+
+int32 SLogiLedPreview::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const FSlateBrush* KeyBrush = FEditorStyle::GetBrush("WhiteBrush");
+	const ESlateDrawEffect DrawEffects = ShouldBeEnabled(bParentEnabled) ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect;
+
+	float Scale = 1.0f;
+	FVector2D Offset;
+	GetLayoutTransform(AllottedGeometry.GetLocalSize(), Scale, Offset);
+
+	for (int32 KeyIndex = 0; KeyIndex < FLogiLedSnapshot::GetNumKeys(); ++KeyIndex)
+	{
+		const FBox2D Bounds = FLogiLedSnapshot::GetKeyBounds(KeyIndex);
+		const FLinearColor KeyColor = FLinearColor(FLogiLedSnapshot::ToDisplayColor(Colors[KeyIndex]));
+
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId,
+			AllottedGeometry.ToPaintGeometry(Offset + Bounds.Min * Scale, Bounds.GetSize() * Scale),
+			KeyBrush,
+			DrawEffects,
+			InWidgetStyle.GetColorAndOpacityTint() * KeyColor
+		);
+	}
+
+	return LayerId;
+}
+
+
+void SLogiLedPreview::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SLeafWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	FLogiLedSnapshot::Get().Read(Colors);
+}
+
+
+/* SLogiLedPreview implementation
+ *****************************************************************************/
+
+void SLogiLedPreview::GetLayoutTransform(const FVector2D& Size, float& OutScale, FVector2D& OutOffset) const
+{
+	const FVector2D LayoutSize = FLogiLedSnapshot::GetLayoutSize();
+
+	OutScale = FMath::Max(FMath::Min(Size.X / LayoutSize.X, Size.Y / LayoutSize.Y), KINDA_SMALL_NUMBER);
+	OutOffset = (Size - LayoutSize * OutScale) * 0.5f;
+}
+
+
+/* SLogiLedPreview callbacks
+ *****************************************************************************/
+
+FText SLogiLedPreview::HandleToolTipText() const
+{
+	if (HoveredKey == INDEX_NONE)
+	{
+		return FText::GetEmpty();
+	}
+
+	const FColor& Color = Colors[HoveredKey];
+
+	return FText::Format(
+		LOCTEXT("KeyToolTipFormat", "{0}: R {1}%, G {2}%, B {3}%"),
+		FText::FromString(FLogiLedSnapshot::GetKeyName(HoveredKey)),
+		FText::AsNumber(Color.R),
+		FText::AsNumber(Color.G),
+		FText::AsNumber(Color.B)
+	);
+}
+
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,79 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/SLeafWidget.h"
+
+#include "LogiLedSnapshot.h"
+
+
+/**
+ * Shows the LED manager's output on a virtual keyboard.
+ *
+ * The widget attaches itself as a viewer of the LED snapshot while it exists,
+ * and picks up the most recently flushed frame on every tick. This works with
+ * or without Logitech hardware.
+ */
+class SLogiLedPreview
+	: public SLeafWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SLogiLedPreview) { }
+	SLATE_END_ARGS()
+
+public:
+
+	/** Default constructor. */
+	SLogiLedPreview();
+
+	/** Virtual destructor. */
+	virtual ~SLogiLedPreview();
+
+public:
+
+	/**
+	 * Construct this widget.
+	 *
+	 * @param InArgs The declaration data for this widget.
+	 */
+	void Construct(const FArguments& InArgs);
+
+public:
+
+	//~ SWidget interface
+
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+	virtual void OnMouseLeave(const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+
+protected:
+
+	/**
+	 * Get the transform from key cells to local widget coordinates.
+	 *
+	 * The keyboard is scaled uniformly to fit the widget and centered in it.
+	 *
+	 * @param Size The widget's local size.
+	 * @param OutScale Will contain the size of a key cell.
+	 * @param OutOffset Will contain the position of the keyboard's top left corner.
+	 */
+	void GetLayoutTransform(const FVector2D& Size, float& OutScale, FVector2D& OutOffset) const;
+
+private:
+
+	/** Callback for getting the tool tip text. */
+	FText HandleToolTipText() const;
+
+private:
+
+	/** The most recently read percentage colors of all keys. */
+	FColor Colors[FLogiLedSnapshot::MaxKeys];
+
+	/** The key under the mouse cursor (INDEX_NONE = none). */
+	int32 HoveredKey;
+};